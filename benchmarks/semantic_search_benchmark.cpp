@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+
+#include <indexes/hnsw_index.hpp>
+#include <indexes/text_embedding.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// About the size of the IGDB catalog
+constexpr std::size_t kGames = 250000;
+constexpr std::size_t kTopics = 2000;
+constexpr std::size_t kVocabulary = 60000;
+constexpr std::size_t kDimension = 128;
+constexpr std::size_t kQueries = 512;
+constexpr std::size_t kK = 10;
+
+std::string MakeWord(std::size_t word)
+{
+    std::string text = "w";
+    for (; word != 0; word /= 26)
+        text.push_back(static_cast<char>('a' + word % 26));
+    return text;
+}
+
+// Summaries mix words of a topic with common words, as game summaries mix
+// words of their genre with plain English
+std::string MakeSummary(std::mt19937& random)
+{
+    std::uniform_int_distribution<std::size_t> topic(0, kTopics - 1);
+    std::uniform_int_distribution<std::size_t> topic_word(0, 29);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<int> words(15, 80);
+
+    const auto kTopic = topic(random);
+    std::string summary;
+    for (auto left = words(random); left != 0; --left)
+    {
+        const auto kSkewed = uniform(random);
+        const auto kWord =
+            uniform(random) < 0.4
+                ? kVocabulary + kTopic * 30 + topic_word(random)
+                : static_cast<std::size_t>(kVocabulary * kSkewed * kSkewed);
+        if (!summary.empty())
+            summary.push_back(' ');
+        summary += MakeWord(kWord);
+    }
+    return summary;
+}
+
+struct Catalog
+{
+    indexes::TextEmbedder embedder{ kDimension, 1 << 18 };
+    std::vector<indexes::TextEmbedder::Vector> vectors;
+    std::vector<indexes::TextEmbedder::Vector> queries;
+};
+
+const Catalog& GetCatalog()
+{
+    static const auto kCatalog = [] {
+        std::mt19937 random(42);
+        Catalog catalog;
+
+        std::vector<indexes::TextEmbedder::Tokens> documents(kGames);
+        for (auto& tokens : documents)
+        {
+            indexes::TextEmbedder::Tokenize(MakeSummary(random), tokens);
+            catalog.embedder.AddDocument(tokens);
+        }
+
+        catalog.vectors.reserve(kGames);
+        for (const auto& tokens : documents)
+            catalog.vectors.push_back(catalog.embedder.Embed(tokens));
+
+        // Queries are short descriptions
+        for (std::size_t query = 0; query < kQueries; ++query)
+        {
+            auto summary = MakeSummary(random);
+            std::size_t words = 0;
+            std::size_t end = 0;
+            while (words < 4 && end != std::string::npos)
+            {
+                end = summary.find(' ', end + 1);
+                ++words;
+            }
+
+            indexes::TextEmbedder::Tokens tokens;
+            indexes::TextEmbedder::Tokenize(summary.substr(0, end), tokens);
+            catalog.queries.push_back(catalog.embedder.Embed(tokens));
+        }
+
+        return catalog;
+    }();
+    return kCatalog;
+}
+
+indexes::HnswIndex BuildIndex(std::size_t games)
+{
+    const auto& kCatalog = GetCatalog();
+
+    indexes::HnswIndex index(kDimension, 32, 100);
+    index.Reserve(games);
+    for (std::size_t game = 0; game < games; ++game)
+        index.Add(kCatalog.vectors[game].data());
+    return index;
+}
+
+// The true closest games by scanning all of them
+std::vector<std::uint32_t>
+ScanClosest(const indexes::TextEmbedder::Vector& query)
+{
+    const auto& kCatalog = GetCatalog();
+
+    std::vector<std::pair<float, std::uint32_t>> scored;
+    scored.reserve(kGames);
+    for (std::uint32_t game = 0; game < kGames; ++game)
+        scored.emplace_back(
+            indexes::GetDotProduct(query.data(),
+                                   kCatalog.vectors[game].data(), kDimension),
+            game);
+
+    std::partial_sort(scored.begin(), scored.begin() + kK, scored.end(),
+                      [](const auto& lhs, const auto& rhs) {
+                          return lhs.first > rhs.first;
+                      });
+
+    std::vector<std::uint32_t> closest;
+    for (std::size_t i = 0; i < kK; ++i)
+        closest.push_back(scored[i].second);
+    return closest;
+}
+
+} // namespace
+
+void SemanticIndexBuild(benchmark::State& state)
+{
+    const auto kGames = static_cast<std::size_t>(state.range(0));
+    GetCatalog();
+
+    for (auto _ : state)
+    {
+        const auto kIndex = BuildIndex(kGames);
+        state.counters["memory-mb"] =
+            static_cast<double>(kIndex.GetMemoryBytes()) / 1e6;
+    }
+}
+BENCHMARK(SemanticIndexBuild)
+    ->Arg(kGames / 10)
+    ->Arg(kGames)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+void SemanticIndexSearch(benchmark::State& state)
+{
+    static const auto kIndex = BuildIndex(kGames);
+    const auto& kCatalog = GetCatalog();
+    const auto kEf = static_cast<std::size_t>(state.range(0));
+
+    std::size_t query = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            kIndex.Search(kCatalog.queries[query].data(), kK, kEf));
+        query = (query + 1) % kCatalog.queries.size();
+    }
+
+    // Share of the true closest games found, outside of the timing
+    std::size_t found = 0;
+    for (const auto& kQuery : kCatalog.queries)
+    {
+        const auto kExpected = ScanClosest(kQuery);
+        for (const auto& neighbor : kIndex.Search(kQuery.data(), kK, kEf))
+            found += std::count(kExpected.begin(), kExpected.end(),
+                                neighbor.node);
+    }
+    state.counters["recall"] = static_cast<double>(found) /
+                               static_cast<double>(kQueries * kK);
+}
+BENCHMARK(SemanticIndexSearch)->Arg(16)->Arg(64)->Arg(128)->Arg(256);
+
+void SemanticIndexScan(benchmark::State& state)
+{
+    const auto& kCatalog = GetCatalog();
+
+    std::size_t query = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ScanClosest(kCatalog.queries[query]));
+        query = (query + 1) % kCatalog.queries.size();
+    }
+}
+BENCHMARK(SemanticIndexScan)->Unit(benchmark::kMillisecond);
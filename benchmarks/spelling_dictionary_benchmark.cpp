@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+
+#include <indexes/spelling_dictionary.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTitles = 500000;
+constexpr std::size_t kVocabulary = 150000;
+constexpr std::size_t kMaxWords = 100000;
+constexpr std::size_t kQueries = 4096;
+
+const std::vector<std::string>& GetVocabulary()
+{
+    static const auto kWords = [] {
+        std::mt19937 random(7);
+        std::uniform_int_distribution<int> length(3, 10);
+        std::uniform_int_distribution<int> letter('a', 'z');
+
+        std::vector<std::string> words(kVocabulary);
+        for (auto& word : words)
+        {
+            word.resize(length(random));
+            for (auto& c : word)
+                c = static_cast<char>(letter(random));
+        }
+        return words;
+    }();
+    return kWords;
+}
+
+// Few words make up most titles, as in real catalogs
+const std::string& PickWord(std::mt19937& random)
+{
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const auto kSkewed = uniform(random);
+    const auto& kWords = GetVocabulary();
+    return kWords[static_cast<std::size_t>(kWords.size() * kSkewed * kSkewed *
+                                           kSkewed)];
+}
+
+indexes::SpellingDictionary BuildDictionary()
+{
+    std::mt19937 random(42);
+    indexes::SpellingDictionary dictionary(2, 7);
+
+    for (std::size_t title = 0; title < kTitles; ++title)
+        for (auto words = 1 + random() % 5; words != 0; --words)
+            dictionary.Add(PickWord(random));
+
+    dictionary.Build(kMaxWords);
+    return dictionary;
+}
+
+std::vector<std::string> MakeTypos(std::size_t edits)
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<std::string> queries;
+    queries.reserve(kQueries);
+    while (queries.size() < kQueries)
+    {
+        auto query = PickWord(random);
+        for (std::size_t edit = 0; edit < edits; ++edit)
+        {
+            const auto kPosition = random() % query.size();
+            if (random() % 2 == 0 && query.size() > 1)
+                query.erase(kPosition, 1);
+            else
+                query[kPosition] = static_cast<char>(letter(random));
+        }
+        queries.push_back(std::move(query));
+    }
+    return queries;
+}
+
+} // namespace
+
+void SpellingDictionaryBuild(benchmark::State& state)
+{
+    GetVocabulary();
+
+    for (auto _ : state)
+    {
+        const auto kDictionary = BuildDictionary();
+        state.counters["words"] =
+            static_cast<double>(kDictionary.GetWordCount());
+        state.counters["memory-mb"] =
+            static_cast<double>(kDictionary.GetMemoryBytes()) / 1e6;
+    }
+}
+BENCHMARK(SpellingDictionaryBuild)->Unit(benchmark::kMillisecond);
+
+void SpellingDictionaryCorrect(benchmark::State& state)
+{
+    static const auto kDictionary = BuildDictionary();
+    const auto kQueries = MakeTypos(static_cast<std::size_t>(state.range(0)));
+
+    std::size_t query = 0;
+    std::size_t corrected = 0;
+    for (auto _ : state)
+    {
+        const auto kCorrection = kDictionary.Correct(kQueries[query]);
+        corrected += kCorrection.has_value();
+        benchmark::DoNotOptimize(kCorrection);
+        query = (query + 1) % kQueries.size();
+    }
+
+    state.counters["corrected"] = benchmark::Counter(
+        static_cast<double>(corrected) / state.iterations());
+}
+// Edits made to every query
+BENCHMARK(SpellingDictionaryCorrect)->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,169 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// userver
+#include <userver/concurrent/variable.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace cache {
+
+struct CacheStatistics
+{
+    userver::utils::statistics::RateCounter hits;
+    userver::utils::statistics::RateCounter misses;
+    userver::utils::statistics::RateCounter evictions;
+    userver::utils::statistics::RateCounter expirations;
+    userver::utils::statistics::RateCounter invalidations;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CacheStatistics& stats);
+
+// LRU cache with a TTL, split into independently locked shards. Each shard
+// holds at most capacity / shards entries and evicts its least recently used
+// one on overflow
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache final
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ShardedLruCache(std::size_t shards, std::size_t capacity,
+                    Clock::duration ttl)
+        : shards_(std::max<std::size_t>(shards, 1)),
+          shard_capacity_(
+              std::max<std::size_t>((capacity + shards_.size() - 1) /
+                                        shards_.size(),
+                                    1)),
+          ttl_(ttl)
+    {}
+
+    std::optional<Value> Get(const Key& key)
+    {
+        auto shard = ShardFor(key).Lock();
+
+        const auto kIt = shard->index.find(key);
+        if (kIt == shard->index.end())
+        {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+
+        if (kIt->second->expires_at <= Clock::now())
+        {
+            shard->entries.erase(kIt->second);
+            shard->index.erase(kIt);
+            ++stats_.expirations;
+            ++stats_.misses;
+            return std::nullopt;
+        }
+
+        shard->entries.splice(shard->entries.begin(), shard->entries,
+                              kIt->second);
+        ++stats_.hits;
+        return kIt->second->value;
+    }
+
+    void Put(const Key& key, Value value)
+    {
+        auto shard = ShardFor(key).Lock();
+        const auto kExpiresAt = Clock::now() + ttl_;
+
+        const auto kIt = shard->index.find(key);
+        if (kIt != shard->index.end())
+        {
+            kIt->second->value = std::move(value);
+            kIt->second->expires_at = kExpiresAt;
+            shard->entries.splice(shard->entries.begin(), shard->entries,
+                                  kIt->second);
+            return;
+        }
+
+        shard->entries.push_front(Node{ key, std::move(value), kExpiresAt });
+        shard->index.emplace(key, shard->entries.begin());
+
+        if (shard->entries.size() > shard_capacity_)
+        {
+            shard->index.erase(shard->entries.back().key);
+            shard->entries.pop_back();
+            ++stats_.evictions;
+        }
+    }
+
+    // Drops every entry the predicate accepts, returns how many were dropped
+    template <typename Predicate>
+    std::size_t EraseIf(Predicate predicate)
+    {
+        std::size_t erased = 0;
+
+        for (auto& variable : shards_)
+        {
+            auto shard = variable.Lock();
+            for (auto it = shard->entries.begin();
+                 it != shard->entries.end();)
+            {
+                if (!predicate(it->key, it->value))
+                {
+                    ++it;
+                    continue;
+                }
+
+                shard->index.erase(it->key);
+                it = shard->entries.erase(it);
+                ++erased;
+            }
+        }
+
+        stats_.invalidations.Add(
+            userver::utils::statistics::Rate{ erased });
+        return erased;
+    }
+
+    std::size_t GetSize() const
+    {
+        std::size_t size = 0;
+        for (const auto& variable : shards_)
+            size += variable.Lock()->entries.size();
+        return size;
+    }
+
+    const CacheStatistics& GetStatistics() const { return stats_; }
+
+private:
+    struct Node
+    {
+        Key key;
+        Value value;
+        Clock::time_point expires_at;
+    };
+
+    struct Shard
+    {
+        std::list<Node> entries;
+        std::unordered_map<Key, typename std::list<Node>::iterator, Hash>
+            index;
+    };
+
+    userver::concurrent::Variable<Shard>& ShardFor(const Key& key)
+    {
+        return shards_[Hash{}(key) % shards_.size()];
+    }
+
+    std::vector<userver::concurrent::Variable<Shard>> shards_;
+    const std::size_t shard_capacity_;
+    const Clock::duration ttl_;
+
+    CacheStatistics stats_;
+};
+
+} // namespace cache
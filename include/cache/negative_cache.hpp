@@ -0,0 +1,52 @@
+#pragma once
+
+// project headers
+#include <cache/lru_cache.hpp>
+
+// std
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cache {
+
+struct NegativeCacheSettings
+{
+    bool enabled{ true };
+    std::size_t shards{ 16 };
+    std::size_t capacity{ 100000 };
+    std::chrono::milliseconds ttl{ std::chrono::minutes{ 10 } };
+};
+
+// Remembers (method, normalized key) pairs IGDB had nothing for. Only a
+// 64-bit hash of the pair is stored, so an entry costs a few dozen bytes
+// whatever the key length
+class NegativeCache final
+{
+public:
+    explicit NegativeCache(NegativeCacheSettings settings);
+
+    // True if IGDB recently answered this with nothing; every hit is an
+    // IGDB request saved
+    bool Contains(std::string_view method, std::string_view normalized_key);
+    void Add(std::string_view method, std::string_view normalized_key);
+
+    std::size_t GetSize() const;
+    const CacheStatistics& GetStatistics() const;
+
+private:
+    struct Miss
+    {};
+
+    static std::uint64_t MakeKey(std::string_view method,
+                                 std::string_view normalized_key);
+
+    const bool enabled_;
+    ShardedLruCache<std::uint64_t, Miss> cache_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const NegativeCache& cache);
+
+} // namespace cache
@@ -0,0 +1,61 @@
+#pragma once
+
+// project headers
+#include <cache/lru_cache.hpp>
+
+// std
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cache {
+
+struct SearchCacheSettings
+{
+    bool enabled{ true };
+    std::size_t shards{ 16 };
+    std::size_t capacity{ 10000 };
+    std::chrono::milliseconds ttl{ std::chrono::seconds{ 30 } };
+};
+
+// Ids of games found for a SearchGames query and limit. Queries are keyed
+// case-insensitively, the same way FindGame matches them
+class SearchCache final
+{
+public:
+    using Ids = std::vector<std::string>;
+
+    explicit SearchCache(SearchCacheSettings settings);
+
+    // An empty list is never a hit, FindGame is asked again instead
+    std::optional<Ids> Get(std::string_view query, std::int32_t limit);
+    void Put(std::string_view query, std::int32_t limit, Ids ids);
+
+    // Drops results of the queries a game with this title would now match
+    void InvalidateMatching(std::string_view title);
+
+    std::size_t GetSize() const;
+    const CacheStatistics& GetStatistics() const;
+
+private:
+    struct Entry
+    {
+        std::string query;
+        Ids ids;
+    };
+
+    static std::string MakeKey(std::string_view folded_query,
+                               std::int32_t limit);
+
+    const bool enabled_;
+    ShardedLruCache<std::string, Entry> cache_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SearchCache& cache);
+
+} // namespace cache
@@ -0,0 +1,133 @@
+#pragma once
+
+// project headers
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace counters {
+
+struct ViewCounterSettings
+{
+    bool enabled{ true };
+
+    std::chrono::milliseconds flush_period{ std::chrono::seconds{ 10 } };
+    // Games per UPDATE statement
+    std::size_t flush_batch{ 1000 };
+    // Distinct games a core counts between two flushes without a lock,
+    // views of the ones past it go to a shared map under a mutex
+    std::size_t shard_capacity{ 4096 };
+    // Games with views Postgres hasn't taken yet. Past this the games with
+    // the fewest views are dropped rather than kept for an outage of any
+    // length
+    std::size_t max_pending{ 100000 };
+};
+
+struct ViewCounterStatistics
+{
+    userver::utils::statistics::RateCounter views;
+    userver::utils::statistics::RateCounter overflowed_views;
+    userver::utils::statistics::RateCounter dropped_views;
+    userver::utils::statistics::RateCounter flushes;
+    userver::utils::statistics::RateCounter flush_failures;
+
+    metrics::LatencyHistogram flushing;
+
+    std::atomic<std::int64_t> pending_games{ 0 };
+};
+
+// Views of games counted in memory per core and written to Postgres in
+// batches on a timer, so GetGame costs an atomic increment instead of an
+// UPDATE. Every core counts into an open addressing table of its own and
+// claims slots with a compare and swap. Each core has two tables: writers
+// count into the active one while a flush switches them, waits for the
+// writers of the old one to leave and drains it
+class ViewCounters final
+{
+public:
+    explicit ViewCounters(ViewCounterSettings settings);
+
+    // Lock-free unless the table of the core is full
+    void Add(const boost::uuids::uuid& id);
+
+    // Views counted since the last collection, summed over the cores. Views
+    // collected here are not written by `Flush`
+    std::vector<entities::GameViews> Collect();
+
+    // Writes the views collected now and the ones earlier flushes failed
+    // to write, returns the ones collected now. Called on a timer and once
+    // more on shutdown
+    std::vector<entities::GameViews>
+    Flush(const pg::IGameRepository& repository);
+
+    const ViewCounterSettings& GetSettings() const;
+    const ViewCounterStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    using ViewMap = std::unordered_map<boost::uuids::uuid, std::int64_t,
+                                       boost::hash<boost::uuids::uuid>>;
+
+    struct Slot
+    {
+        // Halves of the uuid, a zero high half is a free slot
+        std::atomic<std::uint64_t> high{ 0 };
+        std::atomic<std::uint64_t> low{ 0 };
+        std::atomic<std::int64_t> views{ 0 };
+    };
+
+    struct alignas(64) Shard
+    {
+        explicit Shard(std::size_t capacity);
+
+        std::array<std::vector<Slot>, 2> tables;
+        std::atomic<std::uint32_t> active{ 0 };
+        // Writers inside each of the tables
+        std::array<std::atomic<std::int64_t>, 2> writers{};
+    };
+
+    std::vector<entities::GameViews> CollectLocked();
+
+    Shard& GetShard();
+    // False when no slot is free within the probe limit
+    bool Increment(std::vector<Slot>& table, std::uint64_t high,
+                   std::uint64_t low);
+    void Drain(Shard& shard, ViewMap& views);
+
+    const ViewCounterSettings settings_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    userver::engine::Mutex overflow_mutex_;
+    ViewMap overflow_;
+
+    // Flushes don't overlap, they switch the tables of the cores
+    userver::engine::Mutex flush_mutex_;
+    ViewMap pending_;
+
+    mutable ViewCounterStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const ViewCounters& counters);
+
+} // namespace counters
@@ -0,0 +1,148 @@
+#pragma once
+
+// project headers
+#include <repository/repository.hpp>
+#include <structs/game_postgres.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// userver
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace feed {
+
+struct FeedSettings
+{
+    bool enabled{ true };
+
+    std::chrono::milliseconds poll_period{ std::chrono::seconds{ 1 } };
+    // Changes younger than this are left for the next poll, so that a
+    // transaction that is still running doesn't commit behind the cursor
+    std::chrono::milliseconds settle{ std::chrono::seconds{ 1 } };
+
+    // Changes kept in memory for watchers; those further behind read
+    // Postgres until they catch up
+    std::size_t capacity{ 4096 };
+    std::int32_t page_size{ 500 };
+    std::size_t max_watchers{ 256 };
+};
+
+struct FeedStatistics
+{
+    userver::utils::statistics::RateCounter polls;
+    userver::utils::statistics::RateCounter poll_failures;
+    userver::utils::statistics::RateCounter changes;
+    userver::utils::statistics::RateCounter catch_up_reads;
+
+    std::atomic<std::int64_t> watchers{ 0 };
+};
+
+struct Change
+{
+    entities::ChangeCursor cursor;
+    entities::GamePostgres game;
+};
+
+std::vector<Change> MakeChanges(pg::IGameRepository::GamesPostgres&& games);
+
+// Whether the first cursor is earlier in the (updated_at, id) order
+bool IsBefore(const entities::ChangeCursor& lhs,
+              const entities::ChangeCursor& rhs);
+
+// Opaque to clients: microseconds of updated_at and the id
+std::string EncodeResumeToken(const entities::ChangeCursor& cursor);
+std::optional<entities::ChangeCursor>
+DecodeResumeToken(std::string_view token);
+
+// Changes of playhub.games found by one updated_at poller and shared by all
+// watchers
+class ChangeFeed final
+{
+public:
+    struct Read
+    {
+        // Changes right after the cursor are no longer in memory
+        bool behind{ false };
+        std::vector<Change> changes;
+    };
+
+    // Counts a watcher for its lifetime
+    class WatcherScope final
+    {
+    public:
+        explicit WatcherScope(ChangeFeed& feed);
+        ~WatcherScope();
+
+        WatcherScope(const WatcherScope&) = delete;
+        WatcherScope& operator=(const WatcherScope&) = delete;
+
+        explicit operator bool() const;
+
+    private:
+        ChangeFeed& feed_;
+        const bool admitted_;
+    };
+
+    // Gets every page of changes a poll finds, in order, before the
+    // watchers do
+    using Listener = std::function<void(const std::vector<Change>&)>;
+
+    explicit ChangeFeed(FeedSettings settings);
+
+    // Only before the first poll, listeners aren't guarded
+    void Listen(Listener listener);
+
+    void Poll(const pg::IGameRepository& repository);
+
+    // Where new watchers start; nullopt until the first poll
+    std::optional<entities::ChangeCursor> GetHead() const;
+
+    // Changes after `cursor`, waiting for some until `deadline`
+    Read ReadAfter(const entities::ChangeCursor& cursor, std::size_t limit,
+                   userver::engine::Deadline deadline);
+
+    // Reads Postgres directly for a watcher the log has left behind
+    std::optional<std::vector<Change>>
+    CatchUp(const pg::IGameRepository& repository,
+            const entities::ChangeCursor& cursor, std::int32_t limit);
+
+    std::size_t GetSize() const;
+
+    const FeedSettings& GetSettings() const;
+    const FeedStatistics& GetStatistics() const;
+
+private:
+    void Append(std::vector<Change>&& changes);
+
+    const FeedSettings settings_;
+    std::vector<Listener> listeners_;
+
+    mutable userver::engine::Mutex mutex_;
+    userver::engine::ConditionVariable changed_;
+
+    std::deque<Change> log_;
+    // Every change after the floor is in the log
+    std::optional<entities::ChangeCursor> floor_;
+    std::optional<entities::ChangeCursor> head_;
+
+    FeedStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const ChangeFeed& feed);
+
+} // namespace feed
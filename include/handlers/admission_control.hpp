@@ -0,0 +1,136 @@
+#pragma once
+
+// project headers
+#include <handlers/rpc_method.hpp>
+
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace game_service {
+
+// Lower priorities are shed first when the service as a whole is loaded
+enum class Priority
+{
+    kCritical,
+    kNormal,
+    kBackground
+};
+
+struct MethodLimits
+{
+    Priority priority{ Priority::kNormal };
+
+    std::size_t initial_limit{ 32 };
+    std::size_t min_limit{ 4 };
+    std::size_t max_limit{ 256 };
+
+    // Completions slower than this shrink the limit. Time spent waiting on
+    // IGDB isn't counted, see Permit::ExcludeLatency
+    std::chrono::milliseconds target_latency{ 200 };
+
+    // Streams, whose latency is that of the whole stream, aren't refused
+    // for a short deadline
+    bool check_deadline{ true };
+};
+
+MethodLimits GetDefaultLimits(RpcMethod method);
+
+// AIMD concurrency limit: grows by 1/limit on each fast completion while the
+// limit is actually used, shrinks by 10% on a slow one. After a shrink the
+// slow calls already in flight are let drain: there is no other shrink for
+// as long as the call that caused it took
+class ConcurrencyLimiter final
+{
+public:
+    explicit ConcurrencyLimiter(MethodLimits limits = {});
+
+    bool TryAcquire();
+    void Release(std::chrono::nanoseconds latency);
+
+    // Whether a call with `remaining` until its deadline can be expected to
+    // finish in time. The expected latency is capped by the target one, so
+    // a few slow calls can't refuse every deadline, and every kProbeEvery-th
+    // refused call is let through, so that the estimate recovers from calls
+    // that were slow long ago
+    bool FitsDeadline(std::chrono::nanoseconds remaining);
+
+    std::size_t GetLimit() const;
+    std::size_t GetInFlight() const;
+    std::chrono::nanoseconds GetExpectedLatency() const;
+    Priority GetPriority() const;
+
+private:
+    static constexpr double kDecreaseFactor = 0.9;
+    static constexpr double kLatencySmoothing = 0.1;
+    static constexpr std::size_t kProbeEvery = 16;
+
+    const MethodLimits limits_;
+
+    std::atomic<double> limit_;
+    std::atomic<std::size_t> in_flight_{ 0 };
+    std::atomic<double> expected_latency_ns_{ 0.0 };
+    std::atomic<std::int64_t> next_decrease_ns_{ 0 };
+    std::atomic<std::size_t> deadline_rejections_{ 0 };
+};
+
+struct AdmissionSettings
+{
+    bool enabled{ true };
+
+    // In-flight calls of all methods the service is sized for
+    std::size_t total_capacity{ 512 };
+};
+
+class AdmissionController final
+{
+public:
+    class Permit final
+    {
+    public:
+        Permit(Permit&& other) noexcept;
+        Permit& operator=(Permit&&) = delete;
+        ~Permit();
+
+        explicit operator bool() const;
+        std::string_view GetRejectReason() const;
+
+        // Leaves time the call spent on a dependency with its own latency,
+        // such as IGDB, out of what the limiter measures
+        void ExcludeLatency(std::chrono::nanoseconds elapsed);
+
+    private:
+        friend class AdmissionController;
+
+        Permit(AdmissionController* controller, ConcurrencyLimiter* limiter);
+        explicit Permit(std::string_view reject_reason);
+
+        AdmissionController* controller_{ nullptr };
+        ConcurrencyLimiter* limiter_{ nullptr };
+        std::string_view reject_reason_;
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::nanoseconds excluded_{ 0 };
+    };
+
+    explicit AdmissionController(AdmissionSettings settings = {});
+
+    // `remaining` is the time left until the caller's deadline
+    Permit Admit(RpcMethod method, std::chrono::nanoseconds remaining);
+
+    const ConcurrencyLimiter& GetLimiter(RpcMethod method) const;
+    std::size_t GetTotalInFlight() const;
+
+private:
+    bool HasCapacityFor(Priority priority) const;
+
+    const AdmissionSettings settings_;
+
+    std::array<ConcurrencyLimiter, kRpcMethodCount> limiters_;
+    std::atomic<std::size_t> total_in_flight_{ 0 };
+};
+
+} // namespace game_service
@@ -2,17 +2,56 @@
 
 #include <games/games_service.usrv.pb.hpp>
 #include <userver/ugrpc/server/service_component_base.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
 
+#include <cache/negative_cache.hpp>
+#include <cache/search_cache.hpp>
+#include <counters/view_counters.hpp>
+#include <feed/change_feed.hpp>
+#include <handlers/admission_control.hpp>
+#include <handlers/rpc_statistics.hpp>
+#include <indexes/autocomplete.hpp>
+#include <indexes/catalog_sync.hpp>
+#include <indexes/facet_index.hpp>
+#include <indexes/genre_leaderboards.hpp>
+#include <indexes/known_games.hpp>
+#include <indexes/semantic_index.hpp>
+#include <indexes/similar_games.hpp>
+#include <indexes/spelling_corrector.hpp>
+#include <indexes/trending.hpp>
 #include <managers/igdb_manager.hpp>
+#include <refresh/stale_refresher.hpp>
+#include <repository/batching_repository.hpp>
 #include <repository/postgres_manager.hpp>
 
 namespace game_service {
 
+struct ServiceSettings
+{
+    refresh::RefreshSettings refresh;
+    AdmissionSettings admission;
+    cache::SearchCacheSettings search_cache;
+    cache::NegativeCacheSettings negative_cache;
+    indexes::KnownGamesSettings known_games;
+    feed::FeedSettings change_feed;
+    indexes::SimilarGamesSettings similar_games;
+    indexes::FacetSettings facets;
+    indexes::AutocompleteSettings autocomplete;
+    indexes::SpellingCorrectorSettings spelling;
+    indexes::SemanticSearchSettings semantic_search;
+    indexes::TrendingSettings trending;
+    counters::ViewCounterSettings views;
+    indexes::GenreLeaderboardSettings leaderboards;
+    indexes::CatalogSyncSettings catalog_sync;
+};
+
 class GameService final : public ::games::GameServiceBase
 {
 public:
     explicit GameService(std::string prefix, const pg::IGameRepository& manager,
-                         igdb::IIGDBManager& igdb_manager);
+                         igdb::IIGDBManager& igdb_manager,
+                         ServiceSettings settings = {});
 
     SearchGamesResult
     SearchGames(CallContext& context,
@@ -29,6 +68,14 @@ public:
     GetTopRatedGames(CallContext& context,
                      ::games::GetDiscoveryRequest&& request) override;
 
+    GetTrendingGamesResult
+    GetTrendingGames(CallContext& context,
+                     ::games::GetDiscoveryRequest&& request) override;
+
+    GetGenreRankResult
+    GetGenreRank(CallContext& context,
+                 ::games::GetGenreRankRequest&& request) override;
+
     GetUpcomingGamesResult
     GetUpcomingGames(CallContext& context,
                      ::games::GetDiscoveryRequest&& request) override;
@@ -39,16 +86,172 @@ public:
     SetRatingResult SetRating(CallContext& context,
                               ::games::RatingRequest&& request) override;
 
+    BatchGetGamesResult
+    BatchGetGames(CallContext& context,
+                  ::games::BatchGetGamesRequest&& request) override;
+
+    ExportGamesResult ExportGames(CallContext& context,
+                                  ::games::ExportGamesRequest&& request,
+                                  ExportGamesWriter& writer) override;
+
+    WatchGamesResult WatchGames(CallContext& context,
+                                ::games::WatchGamesRequest&& request,
+                                WatchGamesWriter& writer) override;
+
+    GetGamesUpdatedSinceResult GetGamesUpdatedSince(
+        CallContext& context,
+        ::games::GetGamesUpdatedSinceRequest&& request) override;
+
+    GetSimilarGamesResult
+    GetSimilarGames(CallContext& context,
+                    ::games::GetSimilarGamesRequest&& request) override;
+
+    ListFilteredGamesResult
+    ListFilteredGames(CallContext& context,
+                      ::games::ListFilteredGamesRequest&& request) override;
+
+    GetFacetCountsResult
+    GetFacetCounts(CallContext& context,
+                   ::games::GetFacetCountsRequest&& request) override;
+
+    AutocompleteResult
+    Autocomplete(CallContext& context,
+                 ::games::AutocompleteRequest&& request) override;
+
+    SemanticSearchResult
+    SemanticSearch(CallContext& context,
+                   ::games::SemanticSearchRequest&& request) override;
+
+    const RpcStatistics& GetStatistics() const;
+    const cache::SearchCache& GetSearchCache() const;
+    const cache::NegativeCache& GetNegativeCache() const;
+    indexes::KnownGamesFilter& GetKnownGames();
+    feed::ChangeFeed& GetChangeFeed();
+    indexes::SimilarGamesIndex& GetSimilarGames();
+    indexes::FacetIndex& GetFacets();
+    indexes::AutocompleteIndex& GetAutocomplete();
+    indexes::SpellingCorrector& GetSpelling();
+    indexes::SemanticIndex& GetSemanticSearch();
+    indexes::TrendingIndex& GetTrending();
+    counters::ViewCounters& GetViewCounters();
+    indexes::GenreLeaderboards& GetLeaderboards();
+    indexes::CatalogSync& GetCatalogSync();
+
 private:
+    SearchGamesResult DoSearchGames(CallContext& context,
+                                    ::games::SearchGamesRequest&& request,
+                                    CallRecorder& recorder);
+    GetGameResult DoGetGame(CallContext& context,
+                            ::games::GetGameRequest&& request,
+                            CallRecorder& recorder);
+    GetGamesByGenreResult
+    DoGetGamesByGenre(CallContext& context,
+                      ::games::GetGamesByGenreRequest&& request,
+                      CallRecorder& recorder);
+    GetTopRatedGamesResult
+    DoGetTopRatedGames(CallContext& context,
+                       ::games::GetDiscoveryRequest&& request,
+                       CallRecorder& recorder);
+    GetTrendingGamesResult
+    DoGetTrendingGames(CallContext& context,
+                       ::games::GetDiscoveryRequest&& request,
+                       CallRecorder& recorder);
+    GetGenreRankResult DoGetGenreRank(CallContext& context,
+                                      ::games::GetGenreRankRequest&& request,
+                                      CallRecorder& recorder);
+    GetUpcomingGamesResult
+    DoGetUpcomingGames(CallContext& context,
+                       ::games::GetDiscoveryRequest&& request,
+                       CallRecorder& recorder);
+    ListGamesResult DoListGames(CallContext& context,
+                                ::games::ListGamesRequest&& request,
+                                CallRecorder& recorder);
+    SetRatingResult DoSetRating(CallContext& context,
+                                ::games::RatingRequest&& request,
+                                CallRecorder& recorder);
+    BatchGetGamesResult
+    DoBatchGetGames(CallContext& context,
+                    ::games::BatchGetGamesRequest&& request,
+                    CallRecorder& recorder);
+    grpc::Status DoExportGames(CallContext& context,
+                               ::games::ExportGamesRequest&& request,
+                               ExportGamesWriter& writer,
+                               CallRecorder& recorder);
+    grpc::Status DoWatchGames(CallContext& context,
+                              ::games::WatchGamesRequest&& request,
+                              WatchGamesWriter& writer,
+                              CallRecorder& recorder);
+    GetGamesUpdatedSinceResult
+    DoGetGamesUpdatedSince(CallContext& context,
+                           ::games::GetGamesUpdatedSinceRequest&& request,
+                           CallRecorder& recorder);
+    GetSimilarGamesResult
+    DoGetSimilarGames(CallContext& context,
+                      ::games::GetSimilarGamesRequest&& request,
+                      CallRecorder& recorder);
+    ListFilteredGamesResult
+    DoListFilteredGames(CallContext& context,
+                        ::games::ListFilteredGamesRequest&& request,
+                        CallRecorder& recorder);
+    GetFacetCountsResult
+    DoGetFacetCounts(CallContext& context,
+                     ::games::GetFacetCountsRequest&& request,
+                     CallRecorder& recorder);
+    AutocompleteResult
+    DoAutocomplete(CallContext& context,
+                   ::games::AutocompleteRequest&& request,
+                   CallRecorder& recorder);
+    SemanticSearchResult
+    DoSemanticSearch(CallContext& context,
+                     ::games::SemanticSearchRequest&& request,
+                     CallRecorder& recorder);
+
+    // Asks IGDB unless it is known to have nothing for the key. Returns
+    // nullopt when IGDB can't answer. The wait isn't held against the
+    // method's own latency target
+    template <typename Call>
+    std::optional<igdb::IIGDBManager::GamesInfo>
+    QueryIgdb(RpcMethod method, std::string_view key,
+              AdmissionController::Permit& permit, Call&& call);
+
+    // Upserts a game found in IGDB and invalidates what it makes stale
+    entities::GamePostgres SaveIgdbGame(const entities::GameInfo& igdb_game);
+
     void FillResponseWithPgData(::games::GamesListResponse& response,
-                                entities::GamePostgres&& pgData) const;
-    void FillGameProto(::games::Game* game,
-                       entities::GamePostgres&& pgData) const;
+                                entities::GamePostgres&& pgData);
+    // Answers with just the version when the client already has it
+    void FillListResponse(::games::GamesListResponse& response,
+                          std::string_view known_version,
+                          pg::IGameRepository::GamesPostgres&& games,
+                          CallRecorder& recorder);
+    void FillGameProto(::games::Game* game, entities::GamePostgres&& pgData);
+    // Sets the catalog size a ListGames caller asked for, the response
+    // says whether it is exact
+    void FillTotalCount(::games::GamesListResponse& response,
+                        ::games::TotalCount requested);
 
     std::string prefix_;
     
     const pg::IGameRepository& pg_manager_;
     igdb::IIGDBManager& igdb_manager_;
+
+    refresh::StaleRefresher refresher_;
+    AdmissionController admission_;
+    cache::SearchCache search_cache_;
+    cache::NegativeCache negative_cache_;
+    indexes::KnownGamesFilter known_games_;
+    feed::ChangeFeed change_feed_;
+    indexes::SimilarGamesIndex similar_games_;
+    indexes::FacetIndex facets_;
+    indexes::AutocompleteIndex autocomplete_;
+    indexes::SpellingCorrector spelling_;
+    indexes::SemanticIndex semantic_search_;
+    indexes::TrendingIndex trending_;
+    counters::ViewCounters views_;
+    indexes::GenreLeaderboards leaderboards_;
+    // Keeps every index above current, after them so it goes first
+    indexes::CatalogSync catalog_sync_;
+    RpcStatistics statistics_;
 };
 
 class GameServiceComponent final
@@ -59,15 +262,30 @@ public:
 
     GameServiceComponent(const userver::components::ComponentConfig& config,
                          const userver::components::ComponentContext& context);
+    ~GameServiceComponent() override;
 
     static userver::yaml_config::Schema GetStaticConfigSchema();
 
 private:
+    static ServiceSettings
+    ParseSettings(const userver::components::ComponentConfig& config);
+    static pg::BatchSettings
+    ParseBatchSettings(const userver::components::ComponentConfig& config);
 
     pg::PostgresManager pg_manager_;
-    igdb::IGDBManager igdb_manager_;
+    pg::BatchingRepository batching_repository_;
 
     GameService service_;
+
+    userver::utils::statistics::Entry statistics_entry_;
+    userver::utils::statistics::Entry cache_statistics_entry_;
+    userver::utils::statistics::Entry batching_statistics_entry_;
+    userver::utils::statistics::Entry change_feed_statistics_entry_;
+    userver::utils::statistics::Entry indexes_statistics_entry_;
+    userver::utils::statistics::Entry views_statistics_entry_;
+    userver::utils::PeriodicTask change_feed_task_;
+    userver::utils::PeriodicTask catalog_sync_task_;
+    userver::utils::PeriodicTask views_task_;
 };
 
 } // namespace game_service
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace game_service {
+
+enum class RpcMethod
+{
+    kSearchGames,
+    kGetGame,
+    kGetGamesByGenre,
+    kGetTopRatedGames,
+    kGetUpcomingGames,
+    kListGames,
+    kSetRating,
+    kBatchGetGames,
+    kExportGames,
+    kWatchGames,
+    kGetGamesUpdatedSince,
+    kGetSimilarGames,
+    kListFilteredGames,
+    kGetFacetCounts,
+    kAutocomplete,
+    kSemanticSearch,
+    kGetTrendingGames,
+    kGetGenreRank,
+
+    kCount
+};
+
+constexpr std::size_t kRpcMethodCount =
+    static_cast<std::size_t>(RpcMethod::kCount);
+
+constexpr std::size_t ToIndex(RpcMethod method)
+{
+    return static_cast<std::size_t>(method);
+}
+
+std::string_view ToString(RpcMethod method);
+
+} // namespace game_service
@@ -0,0 +1,110 @@
+#pragma once
+
+// project headers
+#include <handlers/rpc_method.hpp>
+#include <metrics/histogram.hpp>
+
+// std
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+// grpc
+#include <grpcpp/support/status.h>
+
+// userver
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace game_service {
+
+// Where the data of a response came from
+enum class ServingPath
+{
+    kCacheHit,
+    kPgHit,
+    kIgdbMiss,
+    // IGDB is unavailable, answered with what Postgres has
+    kFallback,
+    kEmpty,
+    // The client already has this version of the data
+    kNotModified,
+    // Answered from an in-memory index alone
+    kIndexHit,
+    // Found in Postgres after correcting misspelled words of the query
+    kCorrected,
+    // Answered with an error status, whatever path it took
+    kError,
+
+    kCount
+};
+
+constexpr std::size_t kServingPathCount =
+    static_cast<std::size_t>(ServingPath::kCount);
+
+// grpc::StatusCode::OK .. grpc::StatusCode::UNAUTHENTICATED
+constexpr std::size_t kStatusCodeCount = 17;
+
+std::string_view ToString(ServingPath path);
+
+struct MethodStatistics
+{
+    std::array<metrics::LatencyHistogram, kServingPathCount> latency;
+    metrics::SizeHistogram result_size;
+    std::array<userver::utils::statistics::RateCounter, kStatusCodeCount>
+        status;
+};
+
+class RpcStatistics final
+{
+public:
+    MethodStatistics& ForMethod(RpcMethod method);
+    const MethodStatistics& ForMethod(RpcMethod method) const;
+
+private:
+    std::array<MethodStatistics, kRpcMethodCount> methods_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const MethodStatistics& stats);
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const RpcStatistics& stats);
+
+// Accounts latency of one call on destruction, under the serving path the
+// handler reported, or the error one if the call failed
+class CallRecorder final
+{
+public:
+    CallRecorder(RpcStatistics& stats, RpcMethod method);
+    ~CallRecorder();
+
+    CallRecorder(const CallRecorder&) = delete;
+    CallRecorder& operator=(const CallRecorder&) = delete;
+
+    void SetPath(ServingPath path);
+    void SetResultSize(std::size_t size);
+
+    template <typename Result>
+    Result Finish(Result&& result);
+    // For streaming calls, whose result is just a status
+    grpc::Status Finish(grpc::Status status);
+
+private:
+    void AccountStatus(grpc::StatusCode code);
+
+    MethodStatistics& stats_;
+    ServingPath path_{ ServingPath::kEmpty };
+    const std::chrono::steady_clock::time_point start_;
+};
+
+template <typename Result>
+Result CallRecorder::Finish(Result&& result)
+{
+    AccountStatus(result.IsSuccess() ? grpc::StatusCode::OK
+                                     : result.GetErrorStatus().error_code());
+    return std::move(result);
+}
+
+} // namespace game_service
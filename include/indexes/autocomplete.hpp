@@ -0,0 +1,188 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct AutocompleteSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+
+    // Suggestions kept for every prefix, the most a call can ask for
+    std::size_t top_k{ 10 };
+    // Prefixes of more keys than this get their top suggestions
+    // precomputed, the rest are ranked by scanning their keys
+    std::size_t scan_limit{ 256 };
+
+    // Rank of a game is rating_weight * playhub_rating +
+    // hypes_weight * log2(1 + hypes)
+    double rating_weight{ 1.0 };
+    double hypes_weight{ 5.0 };
+};
+
+struct AutocompleteStatistics
+{
+    userver::utils::statistics::RateCounter compactions;
+
+    metrics::LatencyHistogram suggesting;
+
+    std::atomic<std::int64_t> games{ 0 };
+    std::atomic<std::int64_t> keys{ 0 };
+    std::atomic<std::int64_t> precomputed_prefixes{ 0 };
+};
+
+struct Suggestion
+{
+    boost::uuids::uuid id;
+    std::string name;
+    std::string slug;
+};
+
+// Normalized names and slugs of the catalog sorted back to back in one
+// buffer, so the keys under a prefix are a range found by binary search.
+// Prefixes covering many keys have their best games precomputed, so every
+// keystroke costs a few comparisons and at most `scan_limit` key reads.
+// Upserts and changes of other replicas land in the game table at once and
+// in the keys at the next run of the CatalogSync
+class AutocompleteIndex final : public ICatalogIndex
+{
+public:
+    explicit AutocompleteIndex(AutocompleteSettings settings);
+
+    // Best ranked games with a name or slug starting with the prefix, at
+    // most `top_k` of them. Nullopt until the index is built
+    std::optional<std::vector<Suggestion>> Suggest(std::string_view prefix,
+                                                   std::size_t limit) const;
+
+    void Upsert(const entities::GamePostgres& game);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+    // Compacts the keys when games were added, renamed or reranked
+    void Maintain(const pg::IGameRepository& repository,
+                  const entities::ChangeCursor& applied) override;
+
+    bool IsReady() const;
+
+    const AutocompleteSettings& GetSettings() const;
+    const AutocompleteStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    struct Game
+    {
+        boost::uuids::uuid id;
+        std::string name;
+        std::string slug;
+    };
+
+    struct Games
+    {
+        std::vector<Game> rows;
+        // Rank of every row
+        std::vector<double> ranks;
+        std::unordered_map<boost::uuids::uuid, std::uint32_t,
+                           boost::hash<boost::uuids::uuid>>
+            positions;
+    };
+
+    // Best rows of every prefix of more than `scan_limit` keys, `top_k`
+    // slots each starting at the mapped offset, unused ones are kNoRow
+    struct Tops
+    {
+        std::unordered_map<std::string, std::uint32_t> prefixes;
+        std::vector<std::uint32_t> rows;
+    };
+
+    struct Keys
+    {
+        // Keys in increasing order, key i is
+        // buffer[offsets[i], offsets[i + 1])
+        std::string buffer;
+        std::vector<std::uint32_t> offsets;
+        // Game row of every key
+        std::vector<std::uint32_t> rows;
+
+        Tops tops;
+
+        std::size_t Size() const;
+        std::string_view Get(std::size_t key) const;
+    };
+
+    enum class Change
+    {
+        kNone,
+        // Only the rank, the keys stay and the tops are recomputed
+        kRanked,
+        // The game is new or renamed, the keys are compacted again
+        kRenamed,
+    };
+
+    static constexpr std::uint32_t kNoRow = ~std::uint32_t{ 0 };
+
+    double Rank(std::int32_t playhub_rating, std::int32_t hypes) const;
+    Change Set(Games& games, const entities::GameFeatures& game) const;
+    // Flags the change for the next compaction, under the exclusive lock
+    void MarkChanged(Change change);
+
+    // Keys of the games as they are now
+    Keys Compact(const Games& games) const;
+    Tops Precompute(const std::vector<double>& ranks, const Keys& keys) const;
+    void Precompute(const std::vector<double>& ranks, const Keys& keys,
+                    std::size_t begin, std::size_t end, std::size_t depth,
+                    Tops& tops) const;
+    // Best distinct rows of the keys, at most `limit` of them
+    static std::vector<std::uint32_t> Best(const std::vector<double>& ranks,
+                                           const Keys& keys, std::size_t begin,
+                                           std::size_t end, std::size_t limit);
+
+    void CompactIfChanged();
+
+    const AutocompleteSettings settings_;
+
+    // Suggestions and the snapshots compaction works on are taken under a
+    // shared lock, upserts and swapping the compacted keys in take it
+    // exclusively
+    mutable userver::engine::SharedMutex mutex_;
+    Games games_;
+    Keys keys_;
+    // Games were added or renamed since the keys were compacted
+    bool renamed_{ false };
+    // Ranks changed since the tops were precomputed
+    bool reranked_{ false };
+    bool ready_{ false };
+
+    mutable AutocompleteStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const AutocompleteIndex& index);
+
+} // namespace indexes
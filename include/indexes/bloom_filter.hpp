@@ -0,0 +1,49 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace indexes {
+
+// Fixed-size Bloom filter sized for an expected number of keys and a target
+// false positive rate. Adds and lookups are lock-free and may run
+// concurrently; keys can't be removed
+class BloomFilter final
+{
+public:
+    BloomFilter(std::size_t expected_items, double false_positive_rate);
+
+    void Add(std::string_view key);
+
+    // False only if the key was never added
+    bool MayContain(std::string_view key) const;
+
+    std::size_t GetBitCount() const;
+    std::size_t GetHashCount() const;
+    std::size_t GetMemoryBytes() const;
+
+    // Probability of a false positive at the current fill of the bit array
+    double EstimateFalsePositiveRate() const;
+
+private:
+    struct Probe
+    {
+        std::uint64_t first;
+        std::uint64_t step;
+    };
+
+    static Probe MakeProbe(std::string_view key);
+
+    std::size_t GetBit(const Probe& probe, std::size_t i) const;
+
+    const std::size_t bit_count_;
+    const std::size_t hash_count_;
+    const std::size_t word_count_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+};
+
+} // namespace indexes
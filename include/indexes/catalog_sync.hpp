@@ -0,0 +1,162 @@
+#pragma once
+
+// project headers
+#include <feed/change_feed.hpp>
+#include <repository/repository.hpp>
+#include <tools/utils.hpp>
+
+// std
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// userver
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct CatalogSyncSettings
+{
+    // Due rebuilds and the upkeep of the indexes run this often, and so do
+    // catch-ups while the change feed is disabled
+    std::chrono::milliseconds period{ std::chrono::seconds{ 5 } };
+    // Changes younger than this are left for the next catch-up, so that a
+    // transaction that is still running doesn't commit behind the cursor
+    std::chrono::milliseconds settle{ std::chrono::seconds{ 1 } };
+    std::int32_t scan_batch{ 5000 };
+};
+
+struct CatalogIndexStatistics
+{
+    userver::utils::statistics::RateCounter rebuilds;
+    userver::utils::statistics::RateCounter rebuild_failures;
+    userver::utils::statistics::RateCounter catch_up_failures;
+};
+
+// What an in-memory index of the catalog supplies to the CatalogSync that
+// keeps it current
+class ICatalogIndex
+{
+public:
+    virtual ~ICatalogIndex() = default;
+
+    // Builds the index anew from a scan of the catalog and swaps it in.
+    // False when the scan fails, the previous index is kept then
+    virtual bool Rebuild(const pg::IGameRepository& repository) = 0;
+    // Changed games in the order of the changes. Ignored until the index
+    // is built
+    virtual void Apply(const std::vector<feed::Change>& changes) = 0;
+
+    // Rebuilds the index before its rebuild period is over
+    virtual bool IsRebuildRequested() const;
+    // Upkeep after every run of the sync. Changes up to `applied` are
+    // applied, later ones may not be yet
+    virtual void Maintain(const pg::IGameRepository& repository,
+                          const entities::ChangeCursor& applied);
+};
+
+// Every field the indexes read, for changes that come as whole games
+entities::GameFeatures ToFeatures(const entities::GamePostgres& game);
+
+// Id a keyset scan of the catalog continues after
+std::string GetScanKey(const entities::GameKey& key);
+std::string GetScanKey(const entities::GameFeatures& game);
+std::string GetScanKey(const entities::GamePostgres& game);
+
+// Reads the whole catalog in pages of `batch` rows, `page` reads the rows
+// after an id and `visit` gets every page. False when a page can't be read
+template <typename Page, typename Visit>
+bool ScanCatalog(Page page, std::int32_t batch, Visit visit);
+
+// Keeps the in-memory indexes of the catalog current from one task. An
+// index is rebuilt from a scan when due and caught up from where the scan
+// began, and in between gets the changes the change feed polls. Pages of
+// the feed and of a catch-up are applied in order, a page the feed polled
+// before a catch-up page doesn't overwrite it. With the feed disabled
+// every run catches the indexes up instead
+class CatalogSync final
+{
+public:
+    CatalogSync(CatalogSyncSettings settings, feed::ChangeFeed& feed);
+
+    // Only before the first run. `name` labels the logs and metrics
+    void Add(std::string name, ICatalogIndex& index,
+             std::chrono::seconds rebuild_period);
+
+    // Rebuilds and catches up the indexes that are due, then lets every
+    // built index do its upkeep. Not meant to be called concurrently
+    void Run(const pg::IGameRepository& repository);
+
+    const CatalogSyncSettings& GetSettings() const;
+
+    // Counters of every index by its name
+    std::vector<std::pair<std::string, const CatalogIndexStatistics*>>
+    GetStatistics() const;
+
+private:
+    struct Entry
+    {
+        Entry(std::string name, ICatalogIndex& index,
+              std::chrono::seconds rebuild_period);
+
+        const std::string name;
+        ICatalogIndex& index;
+        const std::chrono::seconds rebuild_period;
+
+        // Held while a page is applied, and while a catch-up page is read
+        userver::engine::Mutex mutex;
+        // Latest change applied; every earlier one is applied once no
+        // catch-up is left
+        std::optional<entities::ChangeCursor> applied;
+        // Where the catch-up continues, nullopt when it is done
+        std::optional<entities::ChangeCursor> catch_up;
+
+        bool built{ false };
+        std::chrono::steady_clock::time_point last_rebuild;
+
+        CatalogIndexStatistics stats;
+    };
+
+    void Apply(const std::vector<feed::Change>& changes);
+    void Rebuild(const pg::IGameRepository& repository, Entry& entry);
+    void CatchUp(const pg::IGameRepository& repository, Entry& entry);
+
+    const CatalogSyncSettings settings_;
+    const feed::ChangeFeed& feed_;
+
+    std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CatalogIndexStatistics& stats);
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CatalogSync& sync);
+
+template <typename Page, typename Visit>
+bool ScanCatalog(Page page, std::int32_t batch, Visit visit)
+{
+    std::string after{ utils::kNilUuid };
+
+    while (true)
+    {
+        const auto kRows = page(after, batch);
+        if (!kRows)
+            return false;
+
+        visit(*kRows);
+
+        if (kRows->size() < static_cast<std::size_t>(batch))
+            return true;
+
+        after = GetScanKey(kRows->back());
+    }
+}
+
+} // namespace indexes
@@ -0,0 +1,192 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <indexes/roaring_bitmap.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct FacetSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+};
+
+struct FacetStatistics
+{
+    metrics::LatencyHistogram filtering;
+    metrics::LatencyHistogram counting;
+    metrics::SizeHistogram matches;
+
+    std::atomic<std::int64_t> games{ 0 };
+};
+
+// A game matches when it has any of the values of every facet given
+struct FacetFilter
+{
+    std::vector<std::string> genres;
+    std::vector<std::string> themes;
+    std::vector<std::string> platforms;
+    std::vector<std::int32_t> release_years;
+};
+
+struct FacetPage
+{
+    std::vector<boost::uuids::uuid> ids;
+    // Games matching the filter on all pages
+    std::uint64_t total{ 0 };
+};
+
+// Roaring bitmap of the games with each genre, theme, platform and release
+// year, so any combination of facets is a few bitmap unions and
+// intersections instead of a query shape of its own. Built at startup,
+// updated on upsert and kept current with changes of other replicas by
+// a CatalogSync
+struct FacetValueCount
+{
+    std::string value;
+    std::uint64_t count{ 0 };
+};
+
+// Counts of a facet are taken under the filter on the other facets only,
+// so that the values next to a selected one show what picking them would
+// give. Values without games are left out, the rest go most games first
+struct FacetCounts
+{
+    std::vector<FacetValueCount> genres;
+    std::vector<FacetValueCount> themes;
+    std::vector<FacetValueCount> platforms;
+    std::vector<FacetValueCount> release_years;
+
+    // Games matching the whole filter
+    std::uint64_t total{ 0 };
+};
+
+class FacetIndex final : public ICatalogIndex
+{
+public:
+    explicit FacetIndex(FacetSettings settings);
+
+    // A page of the matching games in the order of ListGames: highest
+    // rating or latest release first, games without a release date last.
+    // Nullopt until the index is built
+    std::optional<FacetPage> Filter(const FacetFilter& filter,
+                                    ::games::SortingType order,
+                                    std::size_t limit,
+                                    std::size_t offset) const;
+
+    // Nullopt until the index is built
+    std::optional<FacetCounts> Count(const FacetFilter& filter) const;
+    // Games in the catalog as of the last catch-up, nullopt until the
+    // index is built
+    std::optional<std::uint64_t> GetGameCount() const;
+
+    void Upsert(const entities::GamePostgres& game);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+
+    bool IsReady() const;
+
+    const FacetSettings& GetSettings() const;
+    const FacetStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+    std::size_t GetValueCount() const;
+
+private:
+    enum class Facet
+    {
+        kGenre,
+        kTheme,
+        kPlatform,
+        kReleaseYear,
+
+        kCount
+    };
+
+    static constexpr auto kFacetCount = static_cast<std::size_t>(Facet::kCount);
+    using FacetValues = std::array<std::vector<std::string>, kFacetCount>;
+
+    struct Row
+    {
+        boost::uuids::uuid id;
+        std::int32_t playhub_rating{ 0 };
+        // YYYYMMDD, 0 when unknown
+        std::int32_t release_date{ 0 };
+
+        // Bitmaps the row is in, to take it out on update
+        std::vector<std::uint32_t> values;
+    };
+
+    struct Index
+    {
+        std::vector<Row> rows;
+        std::unordered_map<boost::uuids::uuid, std::uint32_t,
+                           boost::hash<boost::uuids::uuid>>
+            positions;
+
+        std::array<std::unordered_map<std::string, std::uint32_t>,
+                   kFacetCount>
+            values;
+        std::vector<RoaringBitmap> bitmaps;
+        RoaringBitmap all;
+    };
+
+    static void Set(Index& index, const entities::GameFeatures& game);
+    static void AddValues(Index& index, Row& row, std::uint32_t position,
+                          Facet facet,
+                          const std::vector<std::string>& values);
+
+    static FacetValues ToValues(const FacetFilter& filter);
+
+    // Games with any of the values, nullopt when no facet value is given
+    static std::optional<RoaringBitmap>
+    MatchAny(const Index& index, Facet facet,
+             const std::vector<std::string>& values);
+
+    // Games matching the values of every facet but `skipped`, nullopt when
+    // none of them is given
+    static std::optional<RoaringBitmap> Match(const Index& index,
+                                              const FacetValues& values,
+                                              std::optional<Facet> skipped);
+
+    const FacetSettings settings_;
+
+    // Filters read the index under a shared lock, upserts take it
+    // exclusively
+    mutable userver::engine::SharedMutex mutex_;
+    Index index_;
+    bool ready_{ false };
+
+    mutable FacetStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const FacetIndex& index);
+
+} // namespace indexes
@@ -0,0 +1,166 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <indexes/rank_tree.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct GenreLeaderboardSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+
+    // One genre is compared with Postgres this often, the genres take
+    // turns
+    std::chrono::seconds check_period{ std::chrono::minutes{ 5 } };
+    // Best rated games of the genre the check compares
+    std::int32_t check_depth{ 100 };
+};
+
+struct GenreLeaderboardStatistics
+{
+    userver::utils::statistics::RateCounter rating_changes;
+    userver::utils::statistics::RateCounter checks;
+    userver::utils::statistics::RateCounter inconsistencies;
+
+    metrics::LatencyHistogram ranking;
+
+    std::atomic<std::int64_t> games{ 0 };
+    std::atomic<std::int64_t> genres{ 0 };
+};
+
+// Ranks of a game within a genre, 1 is the best rated
+struct GenreRank
+{
+    std::size_t igdb_rank{ 0 };
+    std::size_t playhub_rank{ 0 };
+    std::size_t games{ 0 };
+};
+
+// Games of every genre ranked by the IGDB rating, the order of
+// GetGamesByGenre, and by the PlayHub rating in rank trees. A rating
+// change or an upsert moves the game in the trees of its genres in
+// O(log n), the best games of a genre are read in O(k + log n) and the
+// rank of a game in O(log n). A CatalogSync applies the changes of other
+// replicas, and a periodic check compares the best games of a genre with
+// Postgres and rebuilds on a mismatch
+class GenreLeaderboards final : public ICatalogIndex
+{
+public:
+    enum class Order
+    {
+        kIgdbRating,
+        kPlayhubRating,
+    };
+
+    explicit GenreLeaderboards(GenreLeaderboardSettings settings);
+
+    // Best rated games of the genre first, at most `limit` of them, none
+    // for an unknown genre. Nullopt until the leaderboards are built
+    std::optional<std::vector<boost::uuids::uuid>>
+    GetTop(std::string_view genre, std::size_t limit,
+           Order order = Order::kIgdbRating) const;
+    // Nullopt when the game isn't in the genre or the leaderboards aren't
+    // built yet
+    std::optional<GenreRank> GetRank(const boost::uuids::uuid& id,
+                                     std::string_view genre) const;
+
+    void Upsert(const entities::GamePostgres& game);
+    // Only for a rating Postgres has stored: the change feed doesn't bring
+    // back one the leaderboards already hold
+    void AccountRating(const boost::uuids::uuid& id,
+                       std::int32_t playhub_rating);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+    // After a failed check
+    bool IsRebuildRequested() const override;
+    // Checks a genre when due
+    void Maintain(const pg::IGameRepository& repository,
+                  const entities::ChangeCursor& applied) override;
+
+    bool IsReady() const;
+
+    const GenreLeaderboardSettings& GetSettings() const;
+    const GenreLeaderboardStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    struct Game
+    {
+        boost::uuids::uuid id;
+        std::vector<std::uint32_t> genres;
+        std::int32_t igdb_rating{ 0 };
+        std::int32_t playhub_rating{ 0 };
+    };
+
+    struct Board
+    {
+        RankTree by_igdb_rating;
+        RankTree by_playhub_rating;
+    };
+
+    struct Boards
+    {
+        std::vector<Game> rows;
+        std::unordered_map<boost::uuids::uuid, std::uint32_t,
+                           boost::hash<boost::uuids::uuid>>
+            positions;
+
+        std::vector<std::string> genre_names;
+        std::unordered_map<std::string, std::uint32_t> genre_numbers;
+        std::vector<Board> boards;
+    };
+
+    // Moves the game to its genres and ratings, true when anything
+    // changed
+    static bool Set(Boards& boards, const entities::GameFeatures& game);
+
+    void Check(const pg::IGameRepository& repository,
+               const entities::ChangeCursor& applied);
+
+    const GenreLeaderboardSettings settings_;
+
+    mutable userver::engine::SharedMutex mutex_;
+    Boards boards_;
+    bool ready_{ false };
+
+    std::chrono::steady_clock::time_point last_check_;
+    // Genre the next check compares
+    std::size_t next_checked_{ 0 };
+    // Set by a failed check, cleared by the rebuild it asks for
+    bool rebuild_requested_{ false };
+
+    mutable GenreLeaderboardStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const GenreLeaderboards& leaderboards);
+
+} // namespace indexes
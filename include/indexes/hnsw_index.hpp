@@ -0,0 +1,92 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace indexes {
+
+// Hierarchical navigable small world graph over unit vectors compared by
+// their dot product, the cosine similarity. Every node links to its
+// closest nodes on layer 0 and, with exponentially decreasing odds, on
+// the layers above it, so a search walks greedily from the sparse top
+// layer down and reads a small share of the vectors instead of all.
+// Nodes are never removed, callers skip the ones they no longer want.
+// Not thread-safe
+class HnswIndex final
+{
+public:
+    struct Neighbor
+    {
+        std::uint32_t node{ 0 };
+        float similarity{ 0.0f };
+    };
+
+    // `m` links per node and layer, twice as many on layer 0.
+    // `ef_construction` candidates are considered for the links of a node
+    HnswIndex(std::size_t dimension, std::size_t m,
+              std::size_t ef_construction, std::uint64_t seed = 0);
+
+    // Id of the new node, nodes are numbered from zero in insertion order
+    std::uint32_t Add(const float* vector);
+
+    // At most `k` nodes most similar first, out of `ef` >= k candidates
+    std::vector<Neighbor> Search(const float* query, std::size_t k,
+                                 std::size_t ef) const;
+
+    const float* GetVector(std::uint32_t node) const;
+
+    void Reserve(std::size_t nodes);
+    std::size_t Size() const;
+    std::size_t GetMemoryBytes() const;
+
+private:
+    static constexpr std::size_t kMaxLevel = 16;
+
+    float GetSimilarity(const float* query, std::uint32_t node) const;
+
+    // Link count followed by the links of the node on the level
+    std::uint32_t* GetLinks(std::uint32_t node, std::size_t level);
+    const std::uint32_t* GetLinks(std::uint32_t node,
+                                  std::size_t level) const;
+    std::size_t GetMaxLinks(std::size_t level) const;
+
+    std::uint32_t SearchGreedy(const float* query, std::uint32_t entry,
+                               std::size_t level) const;
+    // The `ef` closest nodes reachable from the entry, closest first
+    std::vector<Neighbor> SearchLayer(const float* query, std::uint32_t entry,
+                                      std::size_t ef,
+                                      std::size_t level) const;
+    // Keeps candidates closer to the query than to any kept one, so links
+    // point in different directions. Candidates are closest first
+    std::vector<Neighbor> SelectNeighbors(std::vector<Neighbor> candidates,
+                                          std::size_t limit) const;
+    void Link(std::uint32_t node, std::uint32_t neighbor, std::size_t level);
+
+    const std::size_t dimension_;
+    const std::size_t m_;
+    const std::size_t ef_construction_;
+    const double level_factor_;
+    std::mt19937_64 random_;
+
+    // Node i is vectors_[i * dimension_, (i + 1) * dimension_)
+    std::vector<float> vectors_;
+    std::vector<std::uint8_t> levels_;
+
+    // Layer 0 links of node i start at i * (1 + 2 * m_)
+    std::vector<std::uint32_t> base_links_;
+    // Links on layers 1..level of every node, 1 + m_ slots per layer
+    std::vector<std::vector<std::uint32_t>> upper_links_;
+
+    std::uint32_t entry_{ 0 };
+    std::size_t top_level_{ 0 };
+};
+
+// Sums in eight lanes, which compilers vectorize without reordering
+// floating point sums themselves
+float GetDotProduct(const float* lhs, const float* rhs,
+                    std::size_t dimension);
+
+} // namespace indexes
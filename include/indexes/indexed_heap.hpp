@@ -0,0 +1,49 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace indexes {
+
+// Binary max-heap of items numbered from zero with the heap position of
+// every item kept next to it, so the key of any item is changed in
+// O(log n) and the best `k` items are read in O(k log k) without touching
+// the rest of the heap. Not thread-safe
+class IndexedHeap final
+{
+public:
+    using Item = std::uint32_t;
+
+    // Adds the item or moves it to its new key
+    void Set(Item item, double key);
+    // Sets every key at once and heapifies in O(n), items are the
+    // positions in `keys`
+    void Assign(std::vector<double> keys);
+
+    // At most `k` items, the highest keys first
+    std::vector<Item> Top(std::size_t k) const;
+
+    bool Contains(Item item) const;
+    double GetKey(Item item) const;
+    const std::vector<double>& GetKeys() const;
+
+    std::size_t Size() const;
+    std::size_t GetMemoryBytes() const;
+
+private:
+    static constexpr std::uint32_t kAbsent = ~std::uint32_t{ 0 };
+
+    void SiftUp(std::size_t slot);
+    void SiftDown(std::size_t slot);
+    void Place(std::size_t slot, Item item);
+
+    // Key of every item, kept for items not in the heap too
+    std::vector<double> keys_;
+    std::vector<Item> heap_;
+    // Slot of every item in `heap_`, kAbsent for items never set
+    std::vector<std::uint32_t> slots_;
+};
+
+} // namespace indexes
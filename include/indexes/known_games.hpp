@@ -0,0 +1,111 @@
+#pragma once
+
+// project headers
+#include <indexes/bloom_filter.hpp>
+#include <indexes/catalog_sync.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// userver
+#include <userver/engine/mutex.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct KnownGamesSettings
+{
+    bool enabled{ true };
+
+    // Filters are sized for the larger of this and twice the games seen
+    std::size_t expected_items{ 1000000 };
+    double false_positive_rate{ 0.01 };
+    std::int32_t scan_batch{ 10000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+};
+
+struct KnownGamesStatistics
+{
+    // Lookups answered without Postgres
+    userver::utils::statistics::RateCounter rejected;
+    // Lookups that passed the filter but found nothing in Postgres
+    userver::utils::statistics::RateCounter false_positives;
+
+    std::atomic<std::int64_t> items{ 0 };
+};
+
+// Bloom filters of the ids and slugs of every game in Postgres, so lookups
+// of games we don't have are answered without a query. Built at startup,
+// updated on insert and fed the inserts of other replicas and the refresh
+// scheduler by a CatalogSync. A game inserted elsewhere is still rejected
+// until the change feed polls it, about its settle plus poll period, or
+// while the feed is disabled until the next run of the sync
+class KnownGamesFilter final : public ICatalogIndex
+{
+public:
+    explicit KnownGamesFilter(KnownGamesSettings settings);
+
+    // False only for a game that is definitely not in Postgres. Everything
+    // passes until the filters are built
+    bool MayContainId(std::string_view id) const;
+    bool MayContainSlug(std::string_view slug) const;
+
+    void Add(std::string_view id, std::string_view slug);
+    void AccountFalsePositive();
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+    // Past its capacity, to keep the false positive rate near the target
+    bool IsRebuildRequested() const override;
+
+    bool IsReady() const;
+
+    const KnownGamesSettings& GetSettings() const;
+    const KnownGamesStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+    // Estimated false positive rates of the id and slug filters
+    double GetIdFalsePositiveRate() const;
+    double GetSlugFalsePositiveRate() const;
+
+private:
+    struct Filters
+    {
+        Filters(std::size_t expected_items, double false_positive_rate);
+
+        BloomFilter ids;
+        BloomFilter slugs;
+    };
+
+    using FiltersPtr = std::shared_ptr<Filters>;
+
+    FiltersPtr GetCurrent() const;
+    void AddTo(Filters& filters, std::string_view id, std::string_view slug);
+
+    const KnownGamesSettings settings_;
+
+    userver::rcu::Variable<FiltersPtr> current_;
+
+    // Makes an insert reach both the current filters and the ones being
+    // rebuilt before they replace the current
+    userver::engine::Mutex mutex_;
+    FiltersPtr next_;
+
+    std::size_t capacity_{ 0 };
+
+    mutable KnownGamesStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const KnownGamesFilter& filter);
+
+} // namespace indexes
@@ -0,0 +1,73 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace indexes {
+
+// Items ordered by decreasing key, ties by increasing item, in a treap
+// whose nodes know the size of their subtree. Moving an item and reading
+// its rank cost O(log n) expected, and the best `k` items are read in
+// O(k + log n). Not thread-safe
+class RankTree final
+{
+public:
+    using Item = std::uint32_t;
+
+    // Adds the item or moves it to its new key
+    void Set(Item item, double key);
+    void Erase(Item item);
+
+    // Zero-based position of the item, nullopt when it isn't in the tree
+    std::optional<std::size_t> GetRank(Item item) const;
+    // At most `k` items, the highest keys first
+    std::vector<Item> Top(std::size_t k) const;
+
+    bool Contains(Item item) const;
+    std::optional<double> GetKey(Item item) const;
+
+    std::size_t Size() const;
+    std::size_t GetMemoryBytes() const;
+
+private:
+    static constexpr std::uint32_t kNull = ~std::uint32_t{ 0 };
+
+    struct Node
+    {
+        Item item;
+        double key;
+        std::uint32_t priority;
+        std::uint32_t left{ kNull };
+        std::uint32_t right{ kNull };
+        std::uint32_t size{ 1 };
+    };
+
+    // Whether the first item goes before the second one
+    static bool Before(double key, Item item, const Node& node);
+
+    std::uint32_t SizeOf(std::uint32_t node) const;
+    void Resize(std::uint32_t node);
+
+    // Nodes before the key go to the first tree, the rest to the second
+    std::pair<std::uint32_t, std::uint32_t> Split(std::uint32_t node,
+                                                  double key, Item item);
+    // Every node of the first tree goes before every node of the second
+    std::uint32_t Merge(std::uint32_t first, std::uint32_t second);
+    std::uint32_t Remove(std::uint32_t node, double key, Item item);
+
+    std::uint32_t NextPriority();
+
+    std::vector<Node> nodes_;
+    // Nodes of erased items, reused by the next ones
+    std::vector<std::uint32_t> free_;
+    std::unordered_map<Item, std::uint32_t> nodes_of_;
+    std::uint32_t root_{ kNull };
+    std::uint64_t random_{ 0x9e3779b97f4a7c15ULL };
+};
+
+} // namespace indexes
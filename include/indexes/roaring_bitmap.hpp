@@ -0,0 +1,62 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace indexes {
+
+// Compressed set of 32-bit values in the roaring layout: values are grouped
+// by their upper 16 bits, a group is a sorted array of the lower 16 bits
+// while sparse and a 2^16-bit bitmap once dense. Not thread-safe
+class RoaringBitmap final
+{
+public:
+    void Add(std::uint32_t value);
+    void Remove(std::uint32_t value);
+    bool Contains(std::uint32_t value) const;
+
+    std::uint64_t GetCardinality() const;
+    bool IsEmpty() const;
+    std::size_t GetMemoryBytes() const;
+
+    // Values in increasing order
+    std::vector<std::uint32_t> ToVector() const;
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+
+    friend RoaringBitmap operator&(const RoaringBitmap& lhs,
+                                   const RoaringBitmap& rhs);
+    friend RoaringBitmap operator|(const RoaringBitmap& lhs,
+                                   const RoaringBitmap& rhs);
+
+    // Cardinality of `lhs & rhs` without building the intersection
+    friend std::uint64_t GetIntersectionCardinality(const RoaringBitmap& lhs,
+                                                    const RoaringBitmap& rhs);
+
+private:
+    struct Container
+    {
+        std::uint16_t key{ 0 };
+        std::uint32_t cardinality{ 0 };
+
+        // Exactly one of them is in use
+        std::vector<std::uint16_t> array;
+        std::vector<std::uint64_t> bits;
+    };
+
+    static Container Intersect(const Container& lhs, const Container& rhs);
+    static Container Unite(const Container& lhs, const Container& rhs);
+    static std::uint32_t CountIntersection(const Container& lhs,
+                                           const Container& rhs);
+
+    Container* Find(std::uint16_t key);
+    const Container* Find(std::uint16_t key) const;
+
+    // Sorted by key, none of them empty
+    std::vector<Container> containers_;
+};
+
+} // namespace indexes
@@ -0,0 +1,137 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <indexes/hnsw_index.hpp>
+#include <indexes/text_embedding.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct SemanticSearchSettings
+{
+    bool enabled{ true };
+
+    // Whole rows with their summaries are scanned
+    std::int32_t scan_batch{ 1000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+
+    // Floats per game, the vectors are most of the memory
+    std::size_t dimension{ 128 };
+    std::size_t frequency_buckets{ 1 << 18 };
+
+    std::size_t m{ 32 };
+    std::size_t ef_construction{ 100 };
+    // Candidates a search considers, more is slower and finds more of the
+    // true closest games
+    std::size_t ef_search{ 128 };
+};
+
+struct SemanticSearchStatistics
+{
+    metrics::LatencyHistogram searching;
+
+    std::atomic<std::int64_t> games{ 0 };
+    // Nodes of games whose text changed since they were added
+    std::atomic<std::int64_t> stale_nodes{ 0 };
+};
+
+struct SemanticMatch
+{
+    boost::uuids::uuid id;
+    double score{ 0.0 };
+};
+
+// Summaries, genres and themes of every game embedded as hashed TF-IDF
+// vectors in an HNSW graph, so a description finds games that talk about
+// the same things without a scan of the catalog. Built at startup with
+// two scans, one counting document frequencies and one embedding, updated
+// on upsert and kept current with changes of other replicas by a
+// CatalogSync. A game whose text changes gets a new node and the old
+// one is skipped until the next rebuild
+class SemanticIndex final : public ICatalogIndex
+{
+public:
+    explicit SemanticIndex(SemanticSearchSettings settings);
+
+    // Most similar games first. Empty when no word of the query is in the
+    // catalog, nullopt until the index is built
+    std::optional<std::vector<SemanticMatch>> Search(std::string_view query,
+                                                     std::size_t limit) const;
+
+    void Upsert(const entities::GamePostgres& game);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+    // Once a quarter of the nodes are stale. Stale nodes still cost a
+    // search their similarity
+    bool IsRebuildRequested() const override;
+
+    bool IsReady() const;
+
+    const SemanticSearchSettings& GetSettings() const;
+    const SemanticSearchStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    struct Graph
+    {
+        explicit Graph(const SemanticSearchSettings& settings);
+
+        TextEmbedder embedder;
+        HnswIndex hnsw;
+
+        // Game and staleness of every node
+        std::vector<boost::uuids::uuid> ids;
+        std::vector<bool> stale;
+        std::size_t stale_count{ 0 };
+
+        // Current node of every game with a text
+        std::unordered_map<boost::uuids::uuid, std::uint32_t,
+                           boost::hash<boost::uuids::uuid>>
+            nodes;
+    };
+
+    static TextEmbedder::Tokens Tokenize(const entities::GamePostgres& game);
+    static void Set(Graph& graph, const entities::GamePostgres& game);
+
+    // Both scans of a rebuild, `visit` is called with every game
+    template <typename Visit>
+    bool Scan(const pg::IGameRepository& repository, Visit visit);
+
+    const SemanticSearchSettings settings_;
+
+    // Searches read the graph under a shared lock, upserts take it
+    // exclusively
+    mutable userver::engine::SharedMutex mutex_;
+    std::unique_ptr<Graph> graph_;
+
+    mutable SemanticSearchStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SemanticIndex& index);
+
+} // namespace indexes
@@ -0,0 +1,137 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct SimilarGamesSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+
+    // Share of a matching genre, theme or platform in the score
+    double genre_weight{ 1.0 };
+    double theme_weight{ 1.0 };
+    double platform_weight{ 0.5 };
+};
+
+struct SimilarGamesStatistics
+{
+    // Values left out because their kind has no free bits
+    userver::utils::statistics::RateCounter dropped_values;
+
+    metrics::LatencyHistogram scoring;
+
+    std::atomic<std::int64_t> games{ 0 };
+};
+
+struct SimilarGame
+{
+    boost::uuids::uuid id;
+    double score{ 0.0 };
+};
+
+// Genres, themes and platforms of every game as fixed-width bitsets, so
+// that "more like this" scores the whole catalog with a weighted Jaccard
+// over a few machine words per game. Built at startup, updated on upsert
+// and kept current with changes of other replicas by a CatalogSync
+class SimilarGamesIndex final : public ICatalogIndex
+{
+public:
+    // One cache line per game: a word of genres, a word of themes and six
+    // words of platforms
+    static constexpr std::size_t kRowWords = 8;
+    using Row = std::array<std::uint64_t, kRowWords>;
+
+    explicit SimilarGamesIndex(SimilarGamesSettings settings);
+
+    // Most similar games first, not including the game itself. Nullopt
+    // when the game is unknown or the index is not built yet
+    std::optional<std::vector<SimilarGame>>
+    FindSimilar(const boost::uuids::uuid& id, std::size_t limit) const;
+
+    void Upsert(const entities::GamePostgres& game);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+
+    bool IsReady() const;
+
+    const SimilarGamesSettings& GetSettings() const;
+    const SimilarGamesStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    enum class Kind
+    {
+        kGenre,
+        kTheme,
+        kPlatform,
+
+        kCount
+    };
+
+    struct Matrix
+    {
+        std::vector<Row> rows;
+        std::vector<boost::uuids::uuid> ids;
+        std::unordered_map<boost::uuids::uuid, std::size_t,
+                           boost::hash<boost::uuids::uuid>>
+            positions;
+
+        // Bit of every value seen, per kind
+        std::array<std::unordered_map<std::string, std::size_t>,
+                   static_cast<std::size_t>(Kind::kCount)>
+            bits;
+    };
+
+    void Set(Matrix& matrix, const boost::uuids::uuid& id,
+             const std::vector<std::string>& genres,
+             const std::vector<std::string>& themes,
+             const std::vector<std::string>& platforms);
+    void SetBits(Matrix& matrix, Row& row, Kind kind,
+                 const std::vector<std::string>& values);
+
+    const SimilarGamesSettings settings_;
+    // Weight of every word of a row
+    const std::array<double, kRowWords> weights_;
+
+    // Scoring reads rows under a shared lock, upserts take it exclusively
+    mutable userver::engine::SharedMutex mutex_;
+    Matrix matrix_;
+    bool ready_{ false };
+
+    mutable SimilarGamesStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SimilarGamesIndex& index);
+
+} // namespace indexes
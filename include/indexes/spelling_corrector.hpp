@@ -0,0 +1,93 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <indexes/spelling_dictionary.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// userver
+#include <userver/rcu/rcu.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct SpellingCorrectorSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 1 } };
+
+    // Misspellings further than this from every word are left alone
+    std::size_t max_distance{ 2 };
+    // Only the first characters of a word are indexed, typos past them are
+    // still corrected as long as the prefix is close enough
+    std::size_t prefix_length{ 7 };
+    // Words kept in the dictionary, the rarest ones are dropped past it
+    std::size_t max_words{ 100000 };
+};
+
+struct SpellingCorrectorStatistics
+{
+    // Queries that had a misspelled word corrected
+    userver::utils::statistics::RateCounter corrections;
+    // Corrected queries that found games in Postgres
+    userver::utils::statistics::RateCounter hits;
+
+    metrics::LatencyHistogram correcting;
+
+    std::atomic<std::int64_t> words{ 0 };
+    std::atomic<std::int64_t> memory_bytes{ 0 };
+};
+
+// Spelling dictionary of the words in game names, rebuilt from Postgres
+// every `rebuild_period`. Names of games added in between are corrected
+// to after the next rebuild
+class SpellingCorrector final : public ICatalogIndex
+{
+public:
+    explicit SpellingCorrector(SpellingCorrectorSettings settings);
+
+    // The normalized query with misspelled words corrected. Nullopt when no
+    // word changed or the dictionary is not built yet
+    std::optional<std::string> CorrectQuery(std::string_view normalized) const;
+    void AccountHit();
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    // Names reach the dictionary with the next rebuild
+    void Apply(const std::vector<feed::Change>& changes) override;
+
+    bool IsReady() const;
+
+    const SpellingCorrectorSettings& GetSettings() const;
+    const SpellingCorrectorStatistics& GetStatistics() const;
+
+private:
+    using DictionaryPtr = std::shared_ptr<const SpellingDictionary>;
+
+    DictionaryPtr GetCurrent() const;
+
+    const SpellingCorrectorSettings settings_;
+
+    userver::rcu::Variable<DictionaryPtr> current_;
+
+    mutable SpellingCorrectorStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SpellingCorrector& corrector);
+
+} // namespace indexes
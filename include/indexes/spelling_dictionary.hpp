@@ -0,0 +1,89 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace indexes {
+
+// Symmetric delete spelling dictionary: every word is indexed by the
+// strings left after deleting up to `max_distance` characters of its first
+// `prefix_length` ones, so a misspelling shares a delete with the word it
+// misspells and candidates are found by lookups instead of a scan of the
+// vocabulary. Words are counted with `Add` and looked up after `Build`.
+// Not thread-safe while building, read-only afterwards
+class SpellingDictionary final
+{
+public:
+    SpellingDictionary(std::size_t max_distance, std::size_t prefix_length);
+
+    void Add(std::string_view word);
+
+    // Keeps the `max_words` most frequent words, which bounds the memory of
+    // the deletes to about max_words * C(prefix_length, max_distance)
+    void Build(std::size_t max_words);
+
+    // The closest word within the distance allowed for the length of the
+    // word, ties go to the more frequent one. The word itself when it is
+    // known, nullopt when nothing is close enough
+    std::optional<std::string_view> Correct(std::string_view word) const;
+
+    // The normalized query with every misspelled word corrected. Short
+    // words, words with digits and words without a correction are kept
+    // as they are. Nullopt when no word changed
+    std::optional<std::string> CorrectQuery(std::string_view query) const;
+
+    std::size_t GetWordCount() const;
+    std::size_t GetMemoryBytes() const;
+
+private:
+    // Shorter words are too easy to "correct" into other words
+    static constexpr std::size_t kMinWordLength = 3;
+    // Words of up to this many characters are corrected by one edit at most
+    static constexpr std::size_t kShortWordLength = 4;
+
+    std::string_view GetWord(std::uint32_t word) const;
+    std::size_t GetMaxDistance(std::string_view word) const;
+
+    // Every string left after deleting up to `distance` characters,
+    // including the string itself
+    static std::vector<std::string> MakeDeletes(std::string_view word,
+                                                std::size_t distance);
+    // Every string left after deleting one character of any of the words
+    static std::vector<std::string>
+    DeleteOne(const std::vector<std::string>& words);
+
+    const std::size_t max_distance_;
+    const std::size_t prefix_length_;
+
+    // Counts of the words added since the last build
+    std::unordered_map<std::string, std::uint32_t> counts_;
+
+    // Word i is words_[offsets_[i], offsets_[i + 1])
+    std::string words_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> frequencies_;
+
+    // (hash of a delete, word) sorted by hash. Colliding hashes only add
+    // candidates, which are checked by their edit distance anyway
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> deletes_;
+    // Deletes with the top `bucket_bits_` bits of the hash equal to i are
+    // deletes_[buckets_[i], buckets_[i + 1]), so a lookup reads a couple
+    // of entries instead of binary searching all of them
+    std::uint32_t bucket_bits_{ 0 };
+    std::vector<std::uint32_t> buckets_;
+};
+
+// Optimal string alignment distance: insertions, deletions, substitutions
+// and transpositions of adjacent characters. Anything above `limit` is
+// reported as limit + 1
+std::size_t GetEditDistance(std::string_view lhs, std::string_view rhs,
+                            std::size_t limit);
+
+} // namespace indexes
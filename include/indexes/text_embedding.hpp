@@ -0,0 +1,47 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace indexes {
+
+// Bag of words and adjacent word pairs weighted by TF-IDF and folded into
+// `dimension` buckets with random signs (the hashing trick), so texts are
+// embedded without a vocabulary or a model and similar texts end up with
+// a high cosine. Document frequencies are counted by `AddDocument` before
+// embedding, and are kept per hash bucket to bound their memory
+class TextEmbedder final
+{
+public:
+    using Tokens = std::vector<std::uint32_t>;
+    // Unit length, so the dot product of two is their cosine
+    using Vector = std::vector<float>;
+
+    TextEmbedder(std::size_t dimension, std::size_t frequency_buckets);
+
+    // Appends hashes of the words and of the pairs of adjacent words of a
+    // normalized text. Pairs don't span separate calls
+    static void Tokenize(std::string_view normalized, Tokens& tokens);
+
+    void AddDocument(const Tokens& tokens);
+
+    // Tokens no document has are left out. All zeros when nothing is left
+    Vector Embed(const Tokens& tokens) const;
+
+    std::size_t GetDimension() const;
+    std::size_t GetDocumentCount() const;
+    std::size_t GetMemoryBytes() const;
+
+private:
+    double GetIdf(std::uint32_t token) const;
+
+    const std::size_t dimension_;
+
+    std::vector<std::uint32_t> frequencies_;
+    std::uint32_t documents_{ 0 };
+};
+
+} // namespace indexes
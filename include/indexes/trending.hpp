@@ -0,0 +1,160 @@
+#pragma once
+
+// project headers
+#include <indexes/catalog_sync.hpp>
+#include <indexes/indexed_heap.hpp>
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// boost
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// userver
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace indexes {
+
+struct TrendingSettings
+{
+    bool enabled{ true };
+
+    std::int32_t scan_batch{ 5000 };
+    std::chrono::seconds rebuild_period{ std::chrono::hours{ 6 } };
+    // Decay is folded into the scores this often
+    std::chrono::milliseconds fold_period{ std::chrono::seconds{ 30 } };
+
+    // Views, rating changes and releases lose half their weight in this
+    // long
+    std::chrono::seconds half_life{ std::chrono::hours{ 24 } };
+
+    // Score of a game is hypes_weight * log2(1 + hypes) +
+    // igdb_rating_weight * igdb_rating +
+    // playhub_rating_weight * playhub_rating plus the decayed weights of
+    // its views, rating changes and release
+    double hypes_weight{ 2.0 };
+    double igdb_rating_weight{ 0.05 };
+    double playhub_rating_weight{ 0.05 };
+    double view_weight{ 0.1 };
+    double rating_change_weight{ 1.0 };
+    double release_weight{ 10.0 };
+};
+
+struct TrendingStatistics
+{
+    userver::utils::statistics::RateCounter views;
+    userver::utils::statistics::RateCounter rating_changes;
+
+    metrics::LatencyHistogram ranking;
+    metrics::LatencyHistogram folding;
+
+    std::atomic<std::int64_t> games{ 0 };
+};
+
+// Trending score of every game in an indexed heap, so the trending list
+// is read in O(k log k) and every viewed game, rating change and upsert
+// moves one game in O(log n). Views come in batches from the view
+// counters. Activity decays exponentially: between folds new activity is
+// weighted up by how much time passed since the last one instead of every
+// older weight being decayed, and every `fold_period` the decay is folded
+// into all scores and the heap rebuilt. Activity lives in memory only,
+// each replica ranks by the views it served and the rating changes it saw
+class TrendingIndex final : public ICatalogIndex
+{
+public:
+    explicit TrendingIndex(TrendingSettings settings);
+
+    // Best scored games first, at most `limit` of them. Nullopt until the
+    // index is built
+    std::optional<std::vector<boost::uuids::uuid>>
+    GetTop(std::size_t limit) const;
+
+    void Upsert(const entities::GamePostgres& game);
+    // Views the view counters collected since their last flush
+    void AccountViews(const std::vector<entities::GameViews>& views);
+    void AccountRating(const boost::uuids::uuid& id,
+                       std::int32_t playhub_rating);
+
+    bool Rebuild(const pg::IGameRepository& repository) override;
+    void Apply(const std::vector<feed::Change>& changes) override;
+    // Folds the decay when due
+    void Maintain(const pg::IGameRepository& repository,
+                  const entities::ChangeCursor& applied) override;
+
+    bool IsReady() const;
+
+    const TrendingSettings& GetSettings() const;
+    const TrendingStatistics& GetStatistics() const;
+
+    std::size_t GetMemoryBytes() const;
+
+private:
+    using Clock = std::chrono::system_clock;
+
+    struct Game
+    {
+        boost::uuids::uuid id;
+        // Hypes and ratings, what doesn't decay
+        double base{ 0.0 };
+        std::int32_t playhub_rating{ 0 };
+        // Days since the epoch, weightless until then
+        std::int32_t release_day{ kNoRelease };
+        // Weights of views and rating changes as of the landmark
+        double activity{ 0.0 };
+    };
+
+    struct Games
+    {
+        std::vector<Game> rows;
+        std::unordered_map<boost::uuids::uuid, std::uint32_t,
+                           boost::hash<boost::uuids::uuid>>
+            positions;
+    };
+
+    static constexpr std::int32_t kNoRelease =
+        std::numeric_limits<std::int32_t>::min();
+
+    // Weight of something that happens now as of the landmark
+    double GetForwardWeight(Clock::time_point now) const;
+    double GetScore(const Game& game) const;
+
+    // Sets the attributes of the game and returns its row, a changed
+    // rating is activity too
+    std::uint32_t Set(Games& games, const entities::GameFeatures& game,
+                      Clock::time_point now) const;
+    void AddActivity(std::uint32_t row, double weight);
+
+    void Fold(Clock::time_point now);
+
+    const TrendingSettings settings_;
+
+    // Reads of the top take it shared, everything else exclusively
+    mutable userver::engine::SharedMutex mutex_;
+    Games games_;
+    // Score of every row of `games_`
+    IndexedHeap heap_;
+    // Activity and release weights are relative to this moment
+    Clock::time_point landmark_;
+    bool ready_{ false };
+
+    std::chrono::steady_clock::time_point last_fold_;
+
+    mutable TrendingStatistics stats_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const TrendingIndex& index);
+
+} // namespace indexes
@@ -0,0 +1,145 @@
+#pragma once
+
+// project headers
+#include <managers/manager.hpp>
+
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+// userver
+#include <userver/concurrent/variable.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace igdb {
+
+enum class BreakerState
+{
+    kClosed,
+    kHalfOpen,
+    kOpen,
+
+    kCount
+};
+
+constexpr std::size_t kBreakerStateCount =
+    static_cast<std::size_t>(BreakerState::kCount);
+
+std::string_view ToString(BreakerState state);
+
+struct BreakerSettings
+{
+    bool enabled{ true };
+
+    // Calls of the last `window` decide whether to open
+    std::chrono::milliseconds window{ std::chrono::seconds{ 10 } };
+    std::size_t min_calls{ 10 };
+    double failure_ratio{ 0.5 };
+
+    // Successful calls slower than this count as failures
+    std::chrono::milliseconds slow_call{ std::chrono::seconds{ 2 } };
+
+    std::chrono::milliseconds open_duration{ std::chrono::seconds{ 30 } };
+
+    // Concurrent probes while half-open; that many successes close again
+    std::size_t half_open_probes{ 3 };
+};
+
+struct BreakerStatistics
+{
+    std::atomic<BreakerState> state{ BreakerState::kClosed };
+
+    userver::utils::statistics::RateCounter successes;
+    userver::utils::statistics::RateCounter failures;
+    userver::utils::statistics::RateCounter slow_calls;
+    userver::utils::statistics::RateCounter rejected;
+
+    // Indexed by the state entered
+    std::array<userver::utils::statistics::RateCounter, kBreakerStateCount>
+        transitions;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BreakerStatistics& stats);
+
+// Guards an IGDB client: stops calling it while the error rate of recent
+// calls is high and lets a few probes through once `open_duration` passes.
+// Transport errors, 5xx, 429 and slow calls are failures, requests IGDB
+// refuses with another 4xx are not. Rejected calls throw IgdbError right
+// away, errors of the wrapped client are rethrown
+class CircuitBreaker final : public IIGDBManager
+{
+public:
+    CircuitBreaker(IIGDBManager& manager, BreakerSettings settings);
+
+    GamesInfo SearchGames(std::string_view query,
+                          std::int32_t limit = 10) override;
+    GamesInfo GetGameBySlug(std::string_view slug) override;
+    GamesInfo GetGamesByGenre(std::string_view genre,
+                              std::int32_t limit = 20) override;
+    GamesInfo GetUpcomingGames(std::int32_t limit = 5) override;
+    GamesInfo GetGamesByIds(const std::vector<std::string>& ids) override;
+
+    bool IsAvailable() const override;
+
+    BreakerState GetState() const;
+    const BreakerStatistics& GetStatistics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Pass
+    {
+        kRejected,
+        kCall,
+        kProbe
+    };
+
+    enum class Outcome
+    {
+        kSuccess,
+        kFailure,
+        kAbandoned
+    };
+
+    static constexpr std::size_t kBucketCount = 10;
+
+    struct Bucket
+    {
+        std::int64_t epoch{ -1 };
+        std::size_t calls{ 0 };
+        std::size_t failures{ 0 };
+    };
+
+    struct State
+    {
+        BreakerState state{ BreakerState::kClosed };
+        Clock::time_point opened_at;
+        std::size_t probes_in_flight{ 0 };
+        std::size_t probe_successes{ 0 };
+        std::array<Bucket, kBucketCount> buckets;
+    };
+
+    template <typename Call>
+    GamesInfo Execute(std::string_view operation, Call&& call);
+
+    Pass TryPass();
+    void Record(Pass pass, Outcome outcome, Clock::duration latency);
+
+    void RecordCall(State& state, bool failed);
+    void TransitionTo(State& state, BreakerState next);
+    bool IsOpenExpired(const State& state) const;
+
+    IIGDBManager& manager_;
+    const BreakerSettings settings_;
+    const Clock::duration bucket_width_;
+
+    userver::concurrent::Variable<State> state_;
+    BreakerStatistics stats_;
+};
+
+} // namespace igdb
@@ -0,0 +1,43 @@
+#pragma once
+
+// project headers
+#include <managers/circuit_breaker.hpp>
+#include <managers/igdb_manager.hpp>
+
+// std
+#include <string_view>
+
+// userver
+#include <userver/components/component_base.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+namespace igdb {
+
+// Single IGDB client shared by all components of the service, so that they
+// share one Twitch token and one set of client metrics
+class IgdbComponent final : public userver::components::ComponentBase
+{
+public:
+    static constexpr std::string_view kName = "igdb-client";
+
+    IgdbComponent(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+    ~IgdbComponent() override;
+
+    // The client behind the circuit breaker
+    IIGDBManager& GetManager();
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+    static BreakerSettings
+    ParseSettings(const userver::components::ComponentConfig& config);
+
+    IGDBManager manager_;
+    CircuitBreaker breaker_;
+
+    userver::utils::statistics::Entry statistics_entry_;
+};
+
+} // namespace igdb
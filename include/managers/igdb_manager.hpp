@@ -1,6 +1,7 @@
 #pragma once
 
 // project headers
+#include <managers/igdb_statistics.hpp>
 #include <managers/manager.hpp>
 #include <structs/game_info.hpp>
 // std
@@ -14,6 +15,9 @@
 #include <boost/asio/ssl.hpp>
 #include <boost/beast.hpp>
 
+// userver
+#include <userver/engine/mutex.hpp>
+
 namespace igdb {
 
 namespace beast = boost::beast;
@@ -38,22 +42,33 @@ public:
     GamesInfo GetGamesByGenre(std::string_view genre,
                               std::int32_t limit = 20) override;
     GamesInfo GetUpcomingGames(std::int32_t limit = 5) override;
+    GamesInfo GetGamesByIds(const std::vector<std::string>& ids) override;
+
+    const IgdbStatistics& GetStatistics() const;
 
 private:
+    std::optional<std::string> AcquireToken();
+    // Forgets the token IGDB refused, unless it is already replaced
+    void DropToken(const std::string& token);
+
+    GamesInfo QueryGames(std::string_view operation, const std::string& body);
+
     GamesInfo ParseGamesResponse(std::string_view response) const;
 
     const std::string PerformHttpRequest(
-        std::string_view host, std::string_view port, std::string_view target,
-        http::verb method, std::string_view body = "",
+        Endpoint endpoint, std::string_view host, std::string_view port,
+        std::string_view target, http::verb method, std::string_view body = "",
         const std::vector<std::pair<std::string_view, std::string_view>>&
             headers = {}) const;
 
+    userver::engine::Mutex token_mutex_;
     mutable std::optional<std::string> cachedToken_;
     mutable std::chrono::system_clock::time_point tokenExpiry_;
 
     std::string clientId_;
     std::string clientSecret_;
-    std::string accessToken_;
+
+    mutable IgdbStatistics stats_;
 
     static constexpr std::uint32_t kTokenExpiryBufferSeconds = 300;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+// project headers
+#include <metrics/histogram.hpp>
+
+// std
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+// userver
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace igdb {
+
+enum class Endpoint
+{
+    kIgdb,
+    kTwitch,
+
+    kCount
+};
+
+constexpr std::size_t kEndpointCount =
+    static_cast<std::size_t>(Endpoint::kCount);
+
+std::string_view ToString(Endpoint endpoint);
+
+struct EndpointStatistics
+{
+    metrics::LatencyHistogram dns;
+    metrics::LatencyHistogram connect;
+    metrics::LatencyHistogram tls_handshake;
+    metrics::LatencyHistogram ttfb;
+    metrics::LatencyHistogram transfer;
+    metrics::LatencyHistogram total;
+
+    metrics::SizeHistogram response_kib;
+
+    userver::utils::statistics::RateCounter requests;
+    userver::utils::statistics::RateCounter transport_errors;
+    userver::utils::statistics::RateCounter abandoned;
+    userver::utils::statistics::RateCounter status_2xx;
+    userver::utils::statistics::RateCounter status_4xx;
+    userver::utils::statistics::RateCounter status_5xx;
+    userver::utils::statistics::RateCounter too_many_requests;
+};
+
+struct IgdbStatistics
+{
+    EndpointStatistics& ForEndpoint(Endpoint endpoint);
+    const EndpointStatistics& ForEndpoint(Endpoint endpoint) const;
+
+    std::array<EndpointStatistics, kEndpointCount> endpoints;
+
+    metrics::LatencyHistogram parse;
+    metrics::SizeHistogram games;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const EndpointStatistics& stats);
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const IgdbStatistics& stats);
+
+} // namespace igdb
@@ -5,10 +5,45 @@
 
 // std
 #include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 
 namespace igdb {
 
+// IGDB could not answer: transport error, bad status or malformed response
+class IgdbError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// The request was given up because the call it served is cancelled or out of
+// time; says nothing about IGDB health
+class IgdbAbandoned final : public IgdbError
+{
+public:
+    using IgdbError::IgdbError;
+};
+
+// IGDB answered, but refused the request with a 4xx status other than 429,
+// 401 and 403, e.g. for a malformed query; says nothing about IGDB health
+// either
+class IgdbRejected final : public IgdbError
+{
+public:
+    using IgdbError::IgdbError;
+};
+
+// IGDB refused the credentials with 401 or 403. No request succeeds until
+// they are renewed, so it is a failure like any other
+class IgdbUnauthorized final : public IgdbError
+{
+public:
+    using IgdbError::IgdbError;
+};
+
 class IIGDBManager 
 {
 public:
@@ -20,6 +55,10 @@ public:
     virtual GamesInfo GetGameBySlug(std::string_view slug) = 0;
     virtual GamesInfo GetGamesByGenre(std::string_view genre, std::int32_t limit = 20) = 0;
     virtual GamesInfo GetUpcomingGames(std::int32_t limit = 5) = 0;
+    virtual GamesInfo GetGamesByIds(const std::vector<std::string>& ids) = 0;
+
+    // False while requests are known to fail and won't be sent
+    virtual bool IsAvailable() const { return true; }
 };
 
 } // namespace igdb
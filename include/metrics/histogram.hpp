@@ -0,0 +1,48 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <cstddef>
+
+// userver
+#include <userver/utils/statistics/histogram.hpp>
+#include <userver/utils/statistics/histogram_view.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace metrics {
+
+// Milliseconds, from a cached read up to a slow IGDB round trip
+class LatencyHistogram final
+{
+public:
+    LatencyHistogram();
+
+    void Account(std::chrono::nanoseconds duration);
+
+    userver::utils::statistics::HistogramView GetView() const;
+
+private:
+    userver::utils::statistics::Histogram histogram_;
+};
+
+// Number of items: games in a response, ids in a batch, bytes in KiB...
+class SizeHistogram final
+{
+public:
+    SizeHistogram();
+
+    void Account(std::size_t size);
+
+    userver::utils::statistics::HistogramView GetView() const;
+
+private:
+    userver::utils::statistics::Histogram histogram_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const LatencyHistogram& histogram);
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SizeHistogram& histogram);
+
+} // namespace metrics
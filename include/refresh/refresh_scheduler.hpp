@@ -0,0 +1,101 @@
+#pragma once
+
+// project headers
+#include <managers/igdb_manager.hpp>
+#include <repository/postgres_manager.hpp>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// userver
+#include <userver/components/component_base.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/utils/token_bucket.hpp>
+
+namespace refresh {
+
+struct SchedulerSettings
+{
+    std::chrono::milliseconds period{ std::chrono::seconds{ 60 } };
+    std::chrono::seconds stale_after{ std::chrono::hours{ 6 } };
+
+    // IGDB accepts up to 500 ids in a single `where id = (...)`
+    std::size_t batch_size{ 100 };
+    std::size_t max_batches{ 10 };
+
+    // Share of the IGDB request rate the scheduler may spend
+    double igdb_rps{ 4.0 };
+    double budget_share{ 0.25 };
+};
+
+struct SchedulerStatistics
+{
+    userver::utils::statistics::RateCounter runs;
+    userver::utils::statistics::RateCounter batches;
+    userver::utils::statistics::RateCounter refreshed;
+    // Asked for, but not returned by IGDB
+    userver::utils::statistics::RateCounter missing;
+    userver::utils::statistics::RateCounter failed_batches;
+    userver::utils::statistics::RateCounter budget_exhausted;
+
+    std::atomic<std::int64_t> last_candidates{ 0 };
+    std::atomic<std::int64_t> lag_seconds{ 0 };
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SchedulerStatistics& stats);
+
+// Picks the games most worth refreshing and re-fetches them from IGDB in
+// batches, spending no more than its share of the IGDB rate budget
+class RefreshScheduler final
+{
+public:
+    RefreshScheduler(const pg::IGameRepository& repository,
+                     igdb::IIGDBManager& igdb_manager,
+                     SchedulerSettings settings);
+
+    void RunOnce();
+
+    const SchedulerStatistics& GetStatistics() const;
+    const SchedulerSettings& GetSettings() const;
+
+private:
+    void RefreshBatch(const std::vector<std::string>& igdb_ids);
+
+    const pg::IGameRepository& repository_;
+    igdb::IIGDBManager& igdb_manager_;
+    const SchedulerSettings settings_;
+
+    userver::utils::TokenBucket budget_;
+    SchedulerStatistics stats_;
+};
+
+class RefreshSchedulerComponent final
+    : public userver::components::ComponentBase
+{
+public:
+    static constexpr std::string_view kName = "igdb-refresh-scheduler";
+
+    RefreshSchedulerComponent(
+        const userver::components::ComponentConfig& config,
+        const userver::components::ComponentContext& context);
+    ~RefreshSchedulerComponent() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+    pg::PostgresManager pg_manager_;
+
+    RefreshScheduler scheduler_;
+
+    userver::utils::statistics::Entry statistics_entry_;
+    userver::utils::PeriodicTask task_;
+};
+
+} // namespace refresh
@@ -0,0 +1,65 @@
+#pragma once
+
+// project headers
+#include <managers/manager.hpp>
+#include <repository/repository.hpp>
+#include <structs/game_postgres.hpp>
+
+// std
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+
+// userver
+#include <userver/concurrent/background_task_storage.hpp>
+#include <userver/concurrent/variable.hpp>
+#include <userver/utils/token_bucket.hpp>
+
+namespace refresh {
+
+struct RefreshSettings
+{
+    bool enabled{ true };
+
+    // Rows whose IGDB data is older than this are refreshed in background
+    std::chrono::seconds ttl{ std::chrono::hours{ 24 } };
+
+    std::size_t max_in_flight{ 16 };
+    std::size_t burst{ 4 };
+    std::chrono::milliseconds token_interval{ 500 };
+};
+
+// Serves rows as is and schedules a background IGDB re-fetch for the stale
+// ones. Refreshes are deduplicated by slug and limited by a token bucket, so
+// nothing here ever blocks the calling request.
+class StaleRefresher final
+{
+public:
+    StaleRefresher(const pg::IGameRepository& repository,
+                   igdb::IIGDBManager& igdb_manager, RefreshSettings settings);
+
+    bool IsStale(const entities::GamePostgres& game) const;
+
+    void RefreshIfStale(const entities::GamePostgres& game);
+
+    std::size_t InFlight() const;
+
+private:
+    bool TryAcquire(const std::string& slug);
+    void Release(const std::string& slug);
+
+    void Refresh(const std::string& slug);
+
+    const pg::IGameRepository& repository_;
+    igdb::IIGDBManager& igdb_manager_;
+    const RefreshSettings settings_;
+
+    userver::utils::TokenBucket rate_limit_;
+    userver::concurrent::Variable<std::unordered_set<std::string>> in_flight_;
+
+    // Must be the last member: running refreshes use everything above
+    userver::concurrent::BackgroundTaskStorage tasks_;
+};
+
+} // namespace refresh
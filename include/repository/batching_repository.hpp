@@ -0,0 +1,85 @@
+#pragma once
+
+// project headers
+#include <repository/lookup_batcher.hpp>
+#include <repository/repository.hpp>
+
+// userver
+#include <userver/utils/statistics/writer.hpp>
+
+namespace pg {
+
+// Repository that merges concurrent GetGameById and GetGameBySlug calls into
+// `= ANY($1)` queries and passes everything else through
+class BatchingRepository final : public IGameRepository
+{
+public:
+    BatchingRepository(const IGameRepository& repository,
+                       BatchSettings settings);
+
+    GamePostgres CreateGame(const GameInfo& kGameIgdbInfo) const override;
+    GamesPostgres FindGame(std::string_view query,
+                           std::int32_t limit = 10) const override;
+    std::optional<GamePostgres>
+    GetGameBySlug(std::string_view slug) const override;
+    std::optional<GamePostgres>
+    GetGameById(std::string_view postgresId) const override;
+    GamesPostgres
+    GetGamesByIds(const std::vector<std::string>& ids) const override;
+    GamesPostgres
+    GetGamesBySlugs(const std::vector<std::string>& slugs) const override;
+    GamesPostgres
+    GetGamesByKeys(const std::vector<std::string>& ids,
+                   const std::vector<std::string>& slugs) const override;
+    GamesPostgres GetGamesByGenre(std::string_view genre,
+                                  std::int32_t limit) const override;
+    GamesPostgres GetTopRatedGames(std::int32_t limit) const override;
+    GamesPostgres GetUpcomingGames(std::int32_t limit) const override;
+
+    GamesPostgres GetAllGames(std::int32_t limit, std::int32_t offset,
+                              ::games::SortingType filter) const override;
+
+    std::optional<bool> UpdateGameRating(std::string_view game_id,
+                                         std::int32_t rating) const override;
+    bool AddGameViews(const std::vector<GameViews>& views) const override;
+
+    std::vector<std::string>
+    GetRefreshCandidates(std::int32_t limit,
+                         std::chrono::seconds stale_after) const override;
+    bool MarkRefreshAttempted(
+        const std::vector<std::string>& igdb_ids) const override;
+    std::chrono::seconds GetMaxSyncLag() const override;
+    std::optional<std::int64_t> CountGames() const override;
+    std::optional<std::int64_t> EstimateGameCount() const override;
+
+    std::optional<GameKeys> ScanGameKeys(std::string_view after_id,
+                                         std::int32_t limit) const override;
+    std::optional<GamesFeatures>
+    ScanGameFeatures(std::string_view after_id,
+                     std::int32_t limit) const override;
+    std::optional<GamesPostgres> ScanGames(
+        std::string_view after_id,
+        userver::storages::postgres::TimePointWithoutTz updated_since,
+        std::int32_t limit) const override;
+
+    std::optional<GamesPostgres>
+    ScanChanges(const ChangeCursor& after, std::chrono::milliseconds settle,
+                std::int32_t limit) const override;
+    std::optional<ChangeCursor>
+    GetLatestChangeCursor(std::chrono::milliseconds settle) const override;
+
+    const BatchStatistics& GetIdStatistics() const;
+    const BatchStatistics& GetSlugStatistics() const;
+
+private:
+    const IGameRepository& repository_;
+    const bool enabled_;
+
+    mutable LookupBatcher by_id_;
+    mutable LookupBatcher by_slug_;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BatchingRepository& repository);
+
+} // namespace pg
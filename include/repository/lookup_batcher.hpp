@@ -0,0 +1,83 @@
+#pragma once
+
+// project headers
+#include <metrics/histogram.hpp>
+#include <repository/repository.hpp>
+
+// std
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// userver
+#include <userver/concurrent/background_task_storage.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace pg {
+
+struct BatchSettings
+{
+    bool enabled{ true };
+
+    // How long the first lookup of a batch waits for company
+    std::chrono::microseconds window{ 500 };
+    std::size_t max_batch{ 100 };
+};
+
+struct BatchStatistics
+{
+    metrics::SizeHistogram batch_size;
+
+    userver::utils::statistics::RateCounter lookups;
+    userver::utils::statistics::RateCounter batches;
+    // Lookups whose call deadline expired before their batch was loaded
+    userver::utils::statistics::RateCounter timeouts;
+};
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BatchStatistics& stats);
+
+// Merges single-key lookups arriving within `window` of each other into one
+// query by all their keys, DataLoader style. The query runs in a background
+// task with the latest deadline of the lookups it serves, so a cancelled
+// caller doesn't fail the rest of its batch
+class LookupBatcher final
+{
+public:
+    using Loader = std::function<IGameRepository::GamesPostgres(
+        const std::vector<std::string>&)>;
+    // Key a loaded row answers
+    using KeyOf = std::function<std::string(const GamePostgres&)>;
+
+    LookupBatcher(BatchSettings settings, Loader loader, KeyOf key_of);
+
+    std::optional<GamePostgres> Load(const std::string& key);
+
+    const BatchStatistics& GetStatistics() const;
+
+private:
+    struct Batch;
+
+    void Run(const std::shared_ptr<Batch>& batch);
+
+    const BatchSettings settings_;
+    const Loader loader_;
+    const KeyOf key_of_;
+
+    // The batch still accepting keys
+    userver::engine::Mutex mutex_;
+    std::shared_ptr<Batch> open_;
+
+    BatchStatistics stats_;
+
+    // Must be the last member: running batches use everything above
+    userver::concurrent::BackgroundTaskStorage tasks_;
+};
+
+} // namespace pg
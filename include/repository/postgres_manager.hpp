@@ -27,6 +27,13 @@ public:
     GetGameBySlug(std::string_view slug) const override;
     std::optional<GamePostgres>
     GetGameById(std::string_view postgresId) const override;
+    GamesPostgres
+    GetGamesByIds(const std::vector<std::string>& ids) const override;
+    GamesPostgres
+    GetGamesBySlugs(const std::vector<std::string>& slugs) const override;
+    GamesPostgres
+    GetGamesByKeys(const std::vector<std::string>& ids,
+                   const std::vector<std::string>& slugs) const override;
     GamesPostgres GetGamesByGenre(std::string_view genre,
                                   std::int32_t limit) const override;
     GamesPostgres GetTopRatedGames(std::int32_t limit) const override;
@@ -35,10 +42,39 @@ public:
     GamesPostgres GetAllGames(std::int32_t limit, std::int32_t offset,
                               ::games::SortingType filter) const override;
 
-    void UpdateGameRating(std::string_view game_id,
-                          std::int32_t rating) const override;
+    std::optional<bool> UpdateGameRating(std::string_view game_id,
+                                         std::int32_t rating) const override;
+    bool AddGameViews(const std::vector<GameViews>& views) const override;
+
+    std::vector<std::string>
+    GetRefreshCandidates(std::int32_t limit,
+                         std::chrono::seconds stale_after) const override;
+    bool MarkRefreshAttempted(
+        const std::vector<std::string>& igdb_ids) const override;
+    std::chrono::seconds GetMaxSyncLag() const override;
+    std::optional<std::int64_t> CountGames() const override;
+    std::optional<std::int64_t> EstimateGameCount() const override;
+
+    std::optional<GameKeys> ScanGameKeys(std::string_view after_id,
+                                         std::int32_t limit) const override;
+    std::optional<GamesFeatures>
+    ScanGameFeatures(std::string_view after_id,
+                     std::int32_t limit) const override;
+    std::optional<GamesPostgres> ScanGames(
+        std::string_view after_id,
+        userver::storages::postgres::TimePointWithoutTz updated_since,
+        std::int32_t limit) const override;
+
+    std::optional<GamesPostgres>
+    ScanChanges(const ChangeCursor& after, std::chrono::milliseconds settle,
+                std::int32_t limit) const override;
+    std::optional<ChangeCursor>
+    GetLatestChangeCursor(std::chrono::milliseconds settle) const override;
 
 private:
+    // Default command control clamped to the deadline of the current call
+    userver::storages::postgres::CommandControl GetCommandControl() const;
+
     userver::storages::postgres::ClusterPtr pg_cluster_;
 };
 
@@ -5,17 +5,24 @@
 #include <structs/game_info.hpp>
 #include <structs/game_postgres.hpp>
 
+#include <chrono>
 #include <optional>
 
 namespace pg {
 
 using entities::GameInfo;
+using entities::ChangeCursor;
+using entities::GameFeatures;
+using entities::GameKey;
+using entities::GameViews;
 using entities::GamePostgres;
 
 class IGameRepository
 {
 public:
     using GamesPostgres = std::vector<GamePostgres>;
+    using GameKeys = std::vector<GameKey>;
+    using GamesFeatures = std::vector<GameFeatures>;
 
     virtual ~IGameRepository() = default;
 
@@ -26,6 +33,14 @@ public:
     GetGameBySlug(std::string_view slug) const = 0;
     virtual std::optional<GamePostgres>
     GetGameById(std::string_view postgresId) const = 0;
+    virtual GamesPostgres
+    GetGamesByIds(const std::vector<std::string>& ids) const = 0;
+    virtual GamesPostgres
+    GetGamesBySlugs(const std::vector<std::string>& slugs) const = 0;
+    // Games matching any of the ids or any of the slugs, in one query
+    virtual GamesPostgres
+    GetGamesByKeys(const std::vector<std::string>& ids,
+                   const std::vector<std::string>& slugs) const = 0;
     virtual GamesPostgres GetGamesByGenre(std::string_view genre,
                                           std::int32_t limit) const = 0;
     virtual GamesPostgres GetTopRatedGames(std::int32_t limit) const = 0;
@@ -34,8 +49,56 @@ public:
     virtual GamesPostgres GetAllGames(std::int32_t limit, std::int32_t offset,
                                       ::games::SortingType filter) const = 0;
 
-    virtual void UpdateGameRating(std::string_view game_id,
-                                  std::int32_t rating) const = 0;
+    // Whether there was a game with the id to rate. Nullopt on a failure,
+    // so that nothing is derived from a rating that isn't stored
+    virtual std::optional<bool>
+    UpdateGameRating(std::string_view game_id, std::int32_t rating) const = 0;
+    // Adds to the view counts of the games in one statement, ids are
+    // unique. False on a failure, so that the views are kept for a retry
+    virtual bool AddGameViews(const std::vector<GameViews>& views) const = 0;
+
+    // IGDB ids of games synced longer than `stale_after` ago, the most
+    // viewed, hyped and recently released first
+    virtual std::vector<std::string>
+    GetRefreshCandidates(std::int32_t limit,
+                         std::chrono::seconds stale_after) const = 0;
+    // Moves the sync time of games IGDB no longer returns, so that they
+    // don't head every refresh run. False on a failure
+    virtual bool
+    MarkRefreshAttempted(const std::vector<std::string>& igdb_ids) const = 0;
+    virtual std::chrono::seconds GetMaxSyncLag() const = 0;
+    // Games in the catalog by a full count. Nullopt on a failure
+    virtual std::optional<std::int64_t> CountGames() const = 0;
+    // Games in the catalog as of the last ANALYZE, from the planner
+    // statistics. Nullopt on a failure and before the first ANALYZE
+    virtual std::optional<std::int64_t> EstimateGameCount() const = 0;
+
+    // Keys of the games with ids greater than `after_id` in id order.
+    // Nullopt on a failure, so that it's not taken for the end of the table
+    virtual std::optional<GameKeys>
+    ScanGameKeys(std::string_view after_id, std::int32_t limit) const = 0;
+    // Indexed attributes of the games with ids greater than `after_id` in id
+    // order
+    virtual std::optional<GamesFeatures>
+    ScanGameFeatures(std::string_view after_id, std::int32_t limit) const = 0;
+    // Games updated since `updated_since` with ids greater than `after_id`,
+    // in id order
+    virtual std::optional<GamesPostgres> ScanGames(
+        std::string_view after_id,
+        userver::storages::postgres::TimePointWithoutTz updated_since,
+        std::int32_t limit) const = 0;
+
+    // Games changed after `after` in (updated_at, id) order, leaving out
+    // changes younger than `settle` whose transactions may not have
+    // committed yet
+    virtual std::optional<GamesPostgres>
+    ScanChanges(const ChangeCursor& after, std::chrono::milliseconds settle,
+                std::int32_t limit) const = 0;
+    // Cursor of the latest change older than `settle`, so ScanChanges from
+    // it can't skip a commit that lands later. The default one when there is
+    // no such change
+    virtual std::optional<ChangeCursor>
+    GetLatestChangeCursor(std::chrono::milliseconds settle) const = 0;
 };
 
 } // namespace pg
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <boost/uuid/uuid.hpp>
 #include <userver/storages/postgres/io/chrono.hpp>
 
+#include <tools/utils.hpp>
+
 
 
 namespace entities {
@@ -36,7 +38,49 @@ struct GamePostgres
 
     userver::storages::postgres::TimePointWithoutTz created_at;
     userver::storages::postgres::TimePointWithoutTz updated_at;
+    // With a time zone, so that it compares with the clock of the service
+    // whatever the time zone of the database
+    userver::storages::postgres::TimePointTz igdb_synced_at;
+
+};
+
+// What identifies a game in requests
+struct GameKey
+{
+    std::string id;
+    std::string slug;
+};
 
+// What the in-memory indexes of the catalog are built from
+struct GameFeatures
+{
+    boost::uuids::uuid id;
+
+    std::vector<std::string> genres;
+    std::vector<std::string> themes;
+    std::vector<std::string> platforms;
+
+    std::string firstReleaseDate;
+    std::int32_t playhub_rating;
+
+    std::string name;
+    std::string slug;
+    std::int32_t hypes;
+    std::int32_t igdb_rating;
+};
+
+// Views of a game counted since the last flush
+struct GameViews
+{
+    boost::uuids::uuid id;
+    std::int64_t views{ 0 };
+};
+
+// Position in the (updated_at, id) order of changes
+struct ChangeCursor
+{
+    userver::storages::postgres::TimePointWithoutTz updated_at;
+    std::string id{ utils::kNilUuid };
 };
 
 } // namespace entities
\ No newline at end of file
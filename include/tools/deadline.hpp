@@ -0,0 +1,34 @@
+#pragma once
+
+// userver
+#include <userver/engine/deadline.hpp>
+
+// std
+#include <optional>
+
+namespace utils {
+
+// Deadline of the gRPC call the current task is working for. Inherited by
+// subtasks; unreachable when the task does not serve a call
+userver::engine::Deadline GetCallDeadline();
+
+// True when the call was cancelled or its deadline has passed, so any
+// further work for it would be wasted
+bool IsCallAbandoned();
+
+// Sets the call deadline for the current task until destruction. Passing an
+// unreachable deadline detaches the task from the deadline of its parent
+class CallDeadlineScope final
+{
+public:
+    explicit CallDeadlineScope(userver::engine::Deadline deadline);
+    ~CallDeadlineScope();
+
+    CallDeadlineScope(const CallDeadlineScope&) = delete;
+    CallDeadlineScope& operator=(const CallDeadlineScope&) = delete;
+
+private:
+    std::optional<userver::engine::Deadline> previous_;
+};
+
+} // namespace utils
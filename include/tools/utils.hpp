@@ -1,7 +1,10 @@
 #pragma once
 
 // std
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
 // userver
 #include <google/protobuf/timestamp.pb.h>
@@ -10,12 +13,43 @@
 
 namespace utils {
 
+// Smallest uuid, keyset scans of the catalog start after it
+inline constexpr std::string_view kNilUuid =
+    "00000000-0000-0000-0000-000000000000";
 
 const std::string TimestampToString(time_t timestamp);
 
 std::string ForceOriginalQuality(const std::string& url);
 
+// Lowercases ASCII letters, turns punctuation into spaces, trims and collapses
+// whitespace. Bytes of multibyte UTF-8 characters are kept as is
+std::string NormalizeQuery(std::string_view query);
+
+// Lowercase hyphenated spelling of a uuid given in any form Postgres
+// accepts; nullopt if it isn't a uuid
+std::optional<std::string> ToCanonicalUuid(std::string_view uuid);
+
 ::google::protobuf::Timestamp TimePointToProtobuf(
     const userver::storages::postgres::TimePointWithoutTz& time_point);
 
+userver::storages::postgres::TimePointWithoutTz
+ProtobufToTimePoint(const ::google::protobuf::Timestamp& timestamp);
+
+// Opaque token of the rows a response was built from. Changes whenever any
+// row is added, removed, reordered or updated
+class VersionToken final
+{
+public:
+    void Add(std::string_view id,
+             const userver::storages::postgres::TimePointWithoutTz& updated_at);
+
+    std::string Get() const;
+
+private:
+    void Mix(const void* data, std::size_t size);
+
+    // 64-bit FNV-1a
+    std::uint64_t hash_{ 14695981039346656037ULL };
+};
+
 } // namespace utils
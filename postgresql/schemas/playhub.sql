@@ -13,6 +13,7 @@ CREATE TABLE IF NOT EXISTS playhub.games (
     igdb_rating INTEGER DEFAULT 0,
     playhub_rating INTEGER DEFAULT 0,
     hypes INTEGER DEFAULT 0,
+    view_count BIGINT NOT NULL DEFAULT 0,
     
     first_release_date TEXT,
     release_dates TEXT[],
@@ -26,8 +27,11 @@ CREATE TABLE IF NOT EXISTS playhub.games (
     platforms TEXT[],
 
     created_at TIMESTAMP WITHOUT TIME ZONE NOT NULL DEFAULT NOW(),
-    updated_at TIMESTAMP WITHOUT TIME ZONE NOT NULL DEFAULT NOW()
+    updated_at TIMESTAMP WITHOUT TIME ZONE NOT NULL DEFAULT NOW(),
+    igdb_synced_at TIMESTAMP WITH TIME ZONE NOT NULL DEFAULT NOW()
 );
 
 CREATE INDEX IF NOT EXISTS idx_games_igdb_id ON playhub.games(igdb_id);
 CREATE UNIQUE INDEX IF NOT EXISTS idx_games_slug ON playhub.games(slug);
+CREATE INDEX IF NOT EXISTS idx_games_updated_at ON playhub.games(updated_at, id);
+CREATE INDEX IF NOT EXISTS idx_games_igdb_synced_at ON playhub.games(igdb_synced_at);
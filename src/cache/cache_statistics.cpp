@@ -0,0 +1,16 @@
+// project headers
+#include <cache/lru_cache.hpp>
+
+namespace cache {
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CacheStatistics& stats)
+{
+    writer["hits"] = stats.hits;
+    writer["misses"] = stats.misses;
+    writer["evictions"] = stats.evictions;
+    writer["expirations"] = stats.expirations;
+    writer["invalidations"] = stats.invalidations;
+}
+
+} // namespace cache
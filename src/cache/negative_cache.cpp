@@ -0,0 +1,63 @@
+// project headers
+#include <cache/negative_cache.hpp>
+
+// std
+#include <functional>
+#include <string>
+
+namespace cache {
+
+NegativeCache::NegativeCache(NegativeCacheSettings settings)
+    : enabled_(settings.enabled),
+      cache_(settings.shards, settings.capacity, settings.ttl)
+{}
+
+bool NegativeCache::Contains(std::string_view method,
+                             std::string_view normalized_key)
+{
+    if (!enabled_)
+        return false;
+
+    return cache_.Get(MakeKey(method, normalized_key)).has_value();
+}
+
+void NegativeCache::Add(std::string_view method,
+                        std::string_view normalized_key)
+{
+    if (!enabled_)
+        return;
+
+    cache_.Put(MakeKey(method, normalized_key), Miss{});
+}
+
+std::size_t NegativeCache::GetSize() const
+{
+    return cache_.GetSize();
+}
+
+const CacheStatistics& NegativeCache::GetStatistics() const
+{
+    return cache_.GetStatistics();
+}
+
+std::uint64_t NegativeCache::MakeKey(std::string_view method,
+                                     std::string_view normalized_key)
+{
+    std::string key;
+    key.reserve(method.size() + normalized_key.size() + 1);
+    key.append(method).append(1, '\n').append(normalized_key);
+
+    return std::hash<std::string>{}(key);
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const NegativeCache& cache)
+{
+    const auto& stats = cache.GetStatistics();
+
+    writer = stats;
+    writer["igdb-requests-saved"] = stats.hits;
+    writer["size"] = cache.GetSize();
+}
+
+} // namespace cache
@@ -0,0 +1,93 @@
+// project headers
+#include <cache/search_cache.hpp>
+
+// std
+#include <cctype>
+#include <fmt/format.h>
+
+namespace cache {
+
+namespace {
+
+// FindGame uses ILIKE, so only the case of a query doesn't change its result
+std::string FoldCase(std::string_view text)
+{
+    std::string folded;
+    folded.reserve(text.size());
+
+    for (const char kChar : text)
+    {
+        const auto kByte = static_cast<unsigned char>(kChar);
+        folded.push_back(
+            kByte < 0x80 ? static_cast<char>(std::tolower(kByte)) : kChar);
+    }
+
+    return folded;
+}
+
+} // namespace
+
+SearchCache::SearchCache(SearchCacheSettings settings)
+    : enabled_(settings.enabled),
+      cache_(settings.shards, settings.capacity, settings.ttl)
+{}
+
+std::optional<SearchCache::Ids>
+SearchCache::Get(std::string_view query, std::int32_t limit)
+{
+    if (!enabled_ || query.empty())
+        return std::nullopt;
+
+    auto entry = cache_.Get(MakeKey(FoldCase(query), limit));
+    if (!entry || entry->ids.empty())
+        return std::nullopt;
+
+    return std::move(entry->ids);
+}
+
+void SearchCache::Put(std::string_view query, std::int32_t limit, Ids ids)
+{
+    if (!enabled_ || query.empty() || ids.empty())
+        return;
+
+    auto folded = FoldCase(query);
+    auto key = MakeKey(folded, limit);
+    cache_.Put(std::move(key), Entry{ std::move(folded), std::move(ids) });
+}
+
+void SearchCache::InvalidateMatching(std::string_view title)
+{
+    if (!enabled_ || title.empty())
+        return;
+
+    // FindGame matches titles containing the query
+    const auto kFolded = FoldCase(title);
+    cache_.EraseIf([&kFolded](const std::string&, const Entry& entry) {
+        return kFolded.find(entry.query) != std::string::npos;
+    });
+}
+
+std::size_t SearchCache::GetSize() const
+{
+    return cache_.GetSize();
+}
+
+const CacheStatistics& SearchCache::GetStatistics() const
+{
+    return cache_.GetStatistics();
+}
+
+std::string SearchCache::MakeKey(std::string_view folded_query,
+                                 std::int32_t limit)
+{
+    return fmt::format("{}\n{}", limit, folded_query);
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SearchCache& cache)
+{
+    writer = cache.GetStatistics();
+    writer["size"] = cache.GetSize();
+}
+
+} // namespace cache
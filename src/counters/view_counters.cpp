@@ -0,0 +1,315 @@
+// project headers
+#include <counters/view_counters.hpp>
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// linux
+#include <sched.h>
+
+// userver
+#include <userver/engine/sleep.hpp>
+#include <userver/logging/log.hpp>
+
+namespace counters {
+
+namespace {
+
+// Slots a view looks at before it goes to the overflow map
+constexpr std::size_t kMaxProbes = 16;
+
+std::pair<std::uint64_t, std::uint64_t> Split(const boost::uuids::uuid& id)
+{
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+    std::memcpy(&high, id.data, sizeof(high));
+    std::memcpy(&low, id.data + sizeof(high), sizeof(low));
+    return { high, low };
+}
+
+boost::uuids::uuid Join(std::uint64_t high, std::uint64_t low)
+{
+    boost::uuids::uuid id{};
+    std::memcpy(id.data, &high, sizeof(high));
+    std::memcpy(id.data + sizeof(high), &low, sizeof(low));
+    return id;
+}
+
+std::size_t Hash(std::uint64_t high, std::uint64_t low)
+{
+    auto hash = (high ^ (low * 0x9e3779b97f4a7c15ULL));
+    hash ^= hash >> 32;
+    return static_cast<std::size_t>(hash * 0xff51afd7ed558ccdULL);
+}
+
+std::size_t RoundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t power = 1;
+    while (power < value)
+        power <<= 1;
+    return power;
+}
+
+} // namespace
+
+ViewCounters::Shard::Shard(std::size_t capacity)
+    : tables{ std::vector<Slot>(capacity), std::vector<Slot>(capacity) }
+{}
+
+ViewCounters::ViewCounters(ViewCounterSettings settings) : settings_(settings)
+{
+    const auto kCapacity = RoundUpToPowerOfTwo(
+        std::max(settings_.shard_capacity, kMaxProbes));
+    const auto kCores = std::max(std::thread::hardware_concurrency(), 1u);
+
+    shards_.reserve(kCores);
+    for (unsigned core = 0; core < kCores; ++core)
+        shards_.push_back(std::make_unique<Shard>(kCapacity));
+}
+
+void ViewCounters::Add(const boost::uuids::uuid& id)
+{
+    if (!settings_.enabled)
+        return;
+
+    const auto [kHigh, kLow] = Split(id);
+
+    // Zero marks free slots, such ids are counted under the mutex
+    if (kHigh != 0)
+    {
+        auto& shard = GetShard();
+
+        // A flush that switches the tables in between waits for this
+        // writer to leave the table it entered
+        std::uint32_t table = 0;
+        while (true)
+        {
+            table = shard.active.load();
+            shard.writers[table].fetch_add(1);
+            if (shard.active.load() == table)
+                break;
+            shard.writers[table].fetch_sub(1);
+        }
+
+        const auto kCounted = Increment(shard.tables[table], kHigh, kLow);
+        shard.writers[table].fetch_sub(1);
+        if (kCounted)
+            return;
+    }
+
+    std::lock_guard lock(overflow_mutex_);
+    ++overflow_[id];
+}
+
+std::vector<entities::GameViews> ViewCounters::Collect()
+{
+    std::lock_guard lock(flush_mutex_);
+    return CollectLocked();
+}
+
+std::vector<entities::GameViews>
+ViewCounters::Flush(const pg::IGameRepository& repository)
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+    std::lock_guard lock(flush_mutex_);
+
+    auto collected = CollectLocked();
+
+    std::int64_t views = 0;
+    for (const auto& game : collected)
+    {
+        pending_[game.id] += game.views;
+        views += game.views;
+    }
+    stats_.views.Add(
+        userver::utils::statistics::Rate{ static_cast<std::uint64_t>(views) });
+
+    // Batches are written until one fails, Postgres is likely down then
+    std::vector<entities::GameViews> batch;
+    batch.reserve(std::min(settings_.flush_batch, pending_.size()));
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+        batch.clear();
+        auto end = it;
+        for (; end != pending_.end() && batch.size() < settings_.flush_batch;
+             ++end)
+            batch.push_back({ end->first, end->second });
+
+        if (!repository.AddGameViews(batch))
+        {
+            ++stats_.flush_failures;
+            break;
+        }
+        it = pending_.erase(it, end);
+    }
+
+    if (pending_.size() > settings_.max_pending)
+    {
+        // The games with the fewest views go, which loses the fewest views
+        std::vector<ViewMap::const_iterator> games;
+        games.reserve(pending_.size());
+        for (auto it = pending_.cbegin(); it != pending_.cend(); ++it)
+            games.push_back(it);
+
+        const auto kExcess = games.begin() +
+                             static_cast<std::ptrdiff_t>(pending_.size() -
+                                                         settings_.max_pending);
+        std::nth_element(games.begin(), kExcess, games.end(),
+                         [](const auto& lhs, const auto& rhs) {
+                             return lhs->second < rhs->second;
+                         });
+
+        std::int64_t dropped = 0;
+        for (auto it = games.begin(); it != kExcess; ++it)
+        {
+            dropped += (*it)->second;
+            pending_.erase(*it);
+        }
+        stats_.dropped_views.Add(userver::utils::statistics::Rate{
+            static_cast<std::uint64_t>(dropped) });
+        LOG_WARNING() << "Dropped " << dropped
+                      << " views that couldn't be written";
+    }
+
+    stats_.pending_games = static_cast<std::int64_t>(pending_.size());
+    ++stats_.flushes;
+    stats_.flushing.Account(std::chrono::steady_clock::now() - kStarted);
+
+    return collected;
+}
+
+std::vector<entities::GameViews> ViewCounters::CollectLocked()
+{
+    ViewMap views;
+    for (auto& shard : shards_)
+        Drain(*shard, views);
+
+    ViewMap overflow;
+    {
+        std::lock_guard lock(overflow_mutex_);
+        overflow.swap(overflow_);
+    }
+
+    std::int64_t overflowed = 0;
+    for (const auto& [kId, kViews] : overflow)
+    {
+        views[kId] += kViews;
+        overflowed += kViews;
+    }
+    stats_.overflowed_views.Add(
+        userver::utils::statistics::Rate{
+            static_cast<std::uint64_t>(overflowed) });
+
+    std::vector<entities::GameViews> collected;
+    collected.reserve(views.size());
+    for (const auto& [kId, kViews] : views)
+        collected.push_back({ kId, kViews });
+    return collected;
+}
+
+const ViewCounterSettings& ViewCounters::GetSettings() const
+{
+    return settings_;
+}
+
+const ViewCounterStatistics& ViewCounters::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t ViewCounters::GetMemoryBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& shard : shards_)
+        bytes += sizeof(Shard) + 2 * shard->tables[0].size() * sizeof(Slot);
+
+    const auto kPending = static_cast<std::size_t>(stats_.pending_games.load());
+    return bytes + kPending * (sizeof(boost::uuids::uuid) +
+                               sizeof(std::int64_t) + sizeof(void*));
+}
+
+// Cores rarely change under a task, when they do the view is counted in
+// the table of another core, which is still correct
+ViewCounters::Shard& ViewCounters::GetShard()
+{
+    const auto kCore = sched_getcpu();
+    return *shards_[kCore < 0 ? 0
+                              : static_cast<std::size_t>(kCore) %
+                                    shards_.size()];
+}
+
+bool ViewCounters::Increment(std::vector<Slot>& table, std::uint64_t high,
+                             std::uint64_t low)
+{
+    const auto kMask = table.size() - 1;
+    const auto kHash = Hash(high, low);
+
+    for (std::size_t probe = 0; probe < kMaxProbes; ++probe)
+    {
+        auto& slot = table[(kHash + probe) & kMask];
+
+        auto current = slot.high.load(std::memory_order_acquire);
+        if (current == 0 &&
+            slot.high.compare_exchange_strong(current, high,
+                                              std::memory_order_acq_rel))
+        {
+            slot.low.store(low, std::memory_order_release);
+            slot.views.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // A writer that claimed the slot may not have stored the low half
+        // yet. The id then takes a second slot, which the flush sums up
+        if (current == high &&
+            slot.low.load(std::memory_order_acquire) == low)
+        {
+            slot.views.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ViewCounters::Drain(Shard& shard, ViewMap& views)
+{
+    const auto kDrained = shard.active.load();
+    shard.active.store(1 - kDrained);
+    while (shard.writers[kDrained].load() != 0)
+        userver::engine::Yield();
+
+    for (auto& slot : shard.tables[kDrained])
+    {
+        const auto kHigh = slot.high.load(std::memory_order_relaxed);
+        if (kHigh == 0)
+            continue;
+
+        const auto kViews = slot.views.exchange(0, std::memory_order_relaxed);
+        views[Join(kHigh, slot.low.load(std::memory_order_relaxed))] +=
+            kViews;
+        slot.low.store(0, std::memory_order_relaxed);
+        slot.high.store(0, std::memory_order_relaxed);
+    }
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const ViewCounters& counters)
+{
+    const auto& stats = counters.GetStatistics();
+
+    writer["pending-games"] = stats.pending_games.load();
+    writer["memory-bytes"] = counters.GetMemoryBytes();
+
+    writer["flushing"] = stats.flushing;
+    writer["views"] = stats.views;
+    writer["overflowed-views"] = stats.overflowed_views;
+    writer["dropped-views"] = stats.dropped_views;
+    writer["flushes"] = stats.flushes;
+    writer["flush-failures"] = stats.flush_failures;
+}
+
+} // namespace counters
@@ -0,0 +1,255 @@
+// project headers
+#include <feed/change_feed.hpp>
+#include <tools/utils.hpp>
+
+// std
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <utility>
+
+// boost
+#include <boost/uuid/uuid_io.hpp>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace feed {
+
+std::vector<Change> MakeChanges(pg::IGameRepository::GamesPostgres&& games)
+{
+    std::vector<Change> changes;
+    changes.reserve(games.size());
+
+    for (auto& game : games)
+    {
+        entities::ChangeCursor cursor{ game.updated_at,
+                                       boost::uuids::to_string(game.id) };
+        changes.push_back(Change{ std::move(cursor), std::move(game) });
+    }
+
+    return changes;
+}
+
+bool IsBefore(const entities::ChangeCursor& lhs,
+              const entities::ChangeCursor& rhs)
+{
+    const auto kLhs = lhs.updated_at.GetUnderlying();
+    const auto kRhs = rhs.updated_at.GetUnderlying();
+
+    if (kLhs != kRhs)
+        return kLhs < kRhs;
+    return lhs.id < rhs.id;
+}
+
+std::string EncodeResumeToken(const entities::ChangeCursor& cursor)
+{
+    const auto kMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            cursor.updated_at.GetUnderlying().time_since_epoch())
+            .count();
+
+    return std::to_string(kMicroseconds) + '.' + cursor.id;
+}
+
+std::optional<entities::ChangeCursor>
+DecodeResumeToken(std::string_view token)
+{
+    const auto kDot = token.find('.');
+    if (kDot == std::string_view::npos)
+        return std::nullopt;
+
+    std::int64_t microseconds = 0;
+    const auto kEnd = token.data() + kDot;
+    const auto [kParsedEnd, kError] =
+        std::from_chars(token.data(), kEnd, microseconds);
+    if (kError != std::errc{} || kParsedEnd != kEnd)
+        return std::nullopt;
+
+    auto id = utils::ToCanonicalUuid(token.substr(kDot + 1));
+    if (!id)
+        return std::nullopt;
+
+    const std::chrono::system_clock::time_point kUpdatedAt{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds{ microseconds })
+    };
+    return entities::ChangeCursor{
+        userver::storages::postgres::TimePointWithoutTz{ kUpdatedAt },
+        std::move(*id)
+    };
+}
+
+ChangeFeed::WatcherScope::WatcherScope(ChangeFeed& feed)
+    : feed_(feed),
+      admitted_(static_cast<std::size_t>(++feed.stats_.watchers) <=
+                feed.settings_.max_watchers)
+{}
+
+ChangeFeed::WatcherScope::~WatcherScope()
+{
+    --feed_.stats_.watchers;
+}
+
+ChangeFeed::WatcherScope::operator bool() const
+{
+    return admitted_;
+}
+
+ChangeFeed::ChangeFeed(FeedSettings settings) : settings_(settings) {}
+
+void ChangeFeed::Listen(Listener listener)
+{
+    listeners_.push_back(std::move(listener));
+}
+
+void ChangeFeed::Poll(const pg::IGameRepository& repository)
+{
+    if (!settings_.enabled)
+        return;
+
+    auto cursor = GetHead();
+    if (!cursor)
+    {
+        // Watchers without a resume token only want what happens from now
+        const auto kLatest =
+            repository.GetLatestChangeCursor(settings_.settle);
+        if (!kLatest)
+        {
+            ++stats_.poll_failures;
+            return;
+        }
+
+        std::lock_guard lock(mutex_);
+        floor_ = *kLatest;
+        head_ = *kLatest;
+        return;
+    }
+
+    ++stats_.polls;
+
+    while (true)
+    {
+        auto games = repository.ScanChanges(*cursor, settings_.settle,
+                                            settings_.page_size);
+        if (!games)
+        {
+            ++stats_.poll_failures;
+            return;
+        }
+
+        const auto kCount = games->size();
+        if (kCount == 0)
+            break;
+
+        auto changes = MakeChanges(std::move(*games));
+        cursor = changes.back().cursor;
+        for (const auto& listener : listeners_)
+            listener(changes);
+        Append(std::move(changes));
+
+        if (kCount < static_cast<std::size_t>(settings_.page_size))
+            break;
+    }
+}
+
+std::optional<entities::ChangeCursor> ChangeFeed::GetHead() const
+{
+    std::lock_guard lock(mutex_);
+    return head_;
+}
+
+ChangeFeed::Read ChangeFeed::ReadAfter(const entities::ChangeCursor& cursor,
+                                       std::size_t limit,
+                                       userver::engine::Deadline deadline)
+{
+    std::unique_lock lock(mutex_);
+
+    if (!floor_ || IsBefore(cursor, *floor_))
+        return Read{ true, {} };
+
+    const bool kHasChanges = changed_.WaitUntil(
+        lock, deadline, [this, &cursor] { return IsBefore(cursor, *head_); });
+    if (!kHasChanges)
+        return {};
+
+    // The log may have moved past the cursor while waiting
+    if (IsBefore(cursor, *floor_))
+        return Read{ true, {} };
+
+    auto first = std::upper_bound(
+        log_.begin(), log_.end(), cursor,
+        [](const entities::ChangeCursor& value, const Change& change) {
+            return IsBefore(value, change.cursor);
+        });
+
+    Read read;
+    const auto kCount = std::min<std::size_t>(
+        limit, static_cast<std::size_t>(std::distance(first, log_.end())));
+    read.changes.assign(first, first + kCount);
+    return read;
+}
+
+std::optional<std::vector<Change>>
+ChangeFeed::CatchUp(const pg::IGameRepository& repository,
+                    const entities::ChangeCursor& cursor, std::int32_t limit)
+{
+    ++stats_.catch_up_reads;
+
+    auto games = repository.ScanChanges(cursor, settings_.settle, limit);
+    if (!games)
+        return std::nullopt;
+
+    return MakeChanges(std::move(*games));
+}
+
+std::size_t ChangeFeed::GetSize() const
+{
+    std::lock_guard lock(mutex_);
+    return log_.size();
+}
+
+const FeedSettings& ChangeFeed::GetSettings() const
+{
+    return settings_;
+}
+
+const FeedStatistics& ChangeFeed::GetStatistics() const
+{
+    return stats_;
+}
+
+void ChangeFeed::Append(std::vector<Change>&& changes)
+{
+    stats_.changes.Add(userver::utils::statistics::Rate{ changes.size() });
+    {
+        std::lock_guard lock(mutex_);
+
+        for (auto& change : changes)
+            log_.push_back(std::move(change));
+
+        while (log_.size() > settings_.capacity)
+        {
+            floor_ = std::move(log_.front().cursor);
+            log_.pop_front();
+        }
+
+        head_ = log_.back().cursor;
+    }
+    changed_.NotifyAll();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const ChangeFeed& feed)
+{
+    const auto& stats = feed.GetStatistics();
+
+    writer["polls"] = stats.polls;
+    writer["poll-failures"] = stats.poll_failures;
+    writer["changes"] = stats.changes;
+    writer["catch-up-reads"] = stats.catch_up_reads;
+    writer["watchers"] = stats.watchers.load();
+    writer["size"] = feed.GetSize();
+}
+
+} // namespace feed
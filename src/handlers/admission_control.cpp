@@ -0,0 +1,270 @@
+// project headers
+#include <handlers/admission_control.hpp>
+
+// std
+#include <algorithm>
+#include <utility>
+
+namespace game_service {
+
+namespace {
+
+template <std::size_t... Indices>
+std::array<ConcurrencyLimiter, kRpcMethodCount>
+MakeLimiters(std::index_sequence<Indices...>)
+{
+    return { ConcurrencyLimiter{
+        GetDefaultLimits(static_cast<RpcMethod>(Indices)) }... };
+}
+
+template <typename Update>
+void AtomicUpdate(std::atomic<double>& value, Update update)
+{
+    auto current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, update(current),
+                                        std::memory_order_relaxed))
+    {
+    }
+}
+
+} // namespace
+
+MethodLimits GetDefaultLimits(RpcMethod method)
+{
+    using std::chrono::milliseconds;
+
+    switch (method)
+    {
+    case RpcMethod::kGetGame:
+    case RpcMethod::kGetTopRatedGames:
+        return { Priority::kCritical, 64, 8, 512, milliseconds{ 50 } };
+    // A call per keystroke, each answered from memory
+    case RpcMethod::kAutocomplete:
+        return { Priority::kNormal, 64, 8, 512, milliseconds{ 20 } };
+    case RpcMethod::kSearchGames:
+    case RpcMethod::kGetGamesByGenre:
+    case RpcMethod::kGetUpcomingGames:
+    case RpcMethod::kGetSimilarGames:
+    case RpcMethod::kSemanticSearch:
+    case RpcMethod::kGetTrendingGames:
+    case RpcMethod::kGetGenreRank:
+        return { Priority::kNormal, 32, 4, 256, milliseconds{ 300 } };
+    case RpcMethod::kListGames:
+    case RpcMethod::kListFilteredGames:
+    case RpcMethod::kGetFacetCounts:
+    case RpcMethod::kBatchGetGames:
+    case RpcMethod::kGetGamesUpdatedSince:
+        return { Priority::kNormal, 16, 2, 128, milliseconds{ 200 } };
+    case RpcMethod::kSetRating:
+        return { Priority::kBackground, 16, 2, 64, milliseconds{ 100 } };
+    // A few long scans at a time, however long they take
+    case RpcMethod::kExportGames:
+        return { Priority::kBackground, 2, 1, 4, std::chrono::hours{ 1 },
+                 false };
+    // Watchers are bounded by the change feed, not admitted per call
+    case RpcMethod::kWatchGames:
+        return {};
+    case RpcMethod::kCount:
+        break;
+    }
+    return {};
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(MethodLimits limits)
+    : limits_(limits), limit_(static_cast<double>(limits.initial_limit))
+{}
+
+bool ConcurrencyLimiter::TryAcquire()
+{
+    const auto kLimit = GetLimit();
+    auto in_flight = in_flight_.load(std::memory_order_relaxed);
+
+    do
+    {
+        if (in_flight >= kLimit)
+            return false;
+    } while (!in_flight_.compare_exchange_weak(in_flight, in_flight + 1,
+                                               std::memory_order_relaxed));
+
+    return true;
+}
+
+void ConcurrencyLimiter::Release(std::chrono::nanoseconds latency)
+{
+    const auto kInFlight = in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    const auto kLatencyNs = static_cast<double>(latency.count());
+
+    AtomicUpdate(expected_latency_ns_, [kLatencyNs](double current) {
+        if (current == 0.0)
+            return kLatencyNs;
+        return current + (kLatencyNs - current) * kLatencySmoothing;
+    });
+
+    const auto kTarget = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        limits_.target_latency);
+    const auto kMin = static_cast<double>(limits_.min_limit);
+    const auto kMax = static_cast<double>(limits_.max_limit);
+
+    if (latency > kTarget)
+    {
+        const auto kNowNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+
+        auto next_decrease = next_decrease_ns_.load(std::memory_order_relaxed);
+        if (kNowNs >= next_decrease &&
+            next_decrease_ns_.compare_exchange_strong(
+                next_decrease, kNowNs + latency.count(),
+                std::memory_order_relaxed))
+        {
+            AtomicUpdate(limit_, [kMin](double current) {
+                return std::max(kMin, current * kDecreaseFactor);
+            });
+        }
+    }
+    else if (static_cast<double>(kInFlight) * 2 >= limit_.load())
+    {
+        AtomicUpdate(limit_, [kMax](double current) {
+            return std::min(kMax, current + 1.0 / current);
+        });
+    }
+}
+
+bool ConcurrencyLimiter::FitsDeadline(std::chrono::nanoseconds remaining)
+{
+    if (!limits_.check_deadline)
+        return true;
+
+    const auto kExpected = std::min(
+        GetExpectedLatency(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            limits_.target_latency));
+    if (remaining >= kExpected)
+        return true;
+
+    // A probe that finishes, or is cancelled, sooner pulls the estimate down
+    const auto kRejections =
+        deadline_rejections_.fetch_add(1, std::memory_order_relaxed);
+    return kRejections % kProbeEvery == kProbeEvery - 1;
+}
+
+std::size_t ConcurrencyLimiter::GetLimit() const
+{
+    return static_cast<std::size_t>(limit_.load(std::memory_order_relaxed));
+}
+
+std::size_t ConcurrencyLimiter::GetInFlight() const
+{
+    return in_flight_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds ConcurrencyLimiter::GetExpectedLatency() const
+{
+    return std::chrono::nanoseconds{ static_cast<std::int64_t>(
+        expected_latency_ns_.load(std::memory_order_relaxed)) };
+}
+
+Priority ConcurrencyLimiter::GetPriority() const
+{
+    return limits_.priority;
+}
+
+AdmissionController::Permit::Permit(AdmissionController* controller,
+                                    ConcurrencyLimiter* limiter)
+    : controller_(controller), limiter_(limiter),
+      start_(std::chrono::steady_clock::now())
+{}
+
+AdmissionController::Permit::Permit(std::string_view reject_reason)
+    : reject_reason_(reject_reason)
+{}
+
+AdmissionController::Permit::Permit(Permit&& other) noexcept
+    : controller_(std::exchange(other.controller_, nullptr)),
+      limiter_(std::exchange(other.limiter_, nullptr)),
+      reject_reason_(other.reject_reason_), start_(other.start_),
+      excluded_(other.excluded_)
+{}
+
+AdmissionController::Permit::~Permit()
+{
+    if (!limiter_)
+        return;
+
+    limiter_->Release(std::chrono::steady_clock::now() - start_ - excluded_);
+    controller_->total_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AdmissionController::Permit::operator bool() const
+{
+    return reject_reason_.empty();
+}
+
+std::string_view AdmissionController::Permit::GetRejectReason() const
+{
+    return reject_reason_;
+}
+
+void AdmissionController::Permit::ExcludeLatency(
+    std::chrono::nanoseconds elapsed)
+{
+    excluded_ += elapsed;
+}
+
+AdmissionController::AdmissionController(AdmissionSettings settings)
+    : settings_(settings),
+      limiters_(MakeLimiters(std::make_index_sequence<kRpcMethodCount>{}))
+{}
+
+AdmissionController::Permit
+AdmissionController::Admit(RpcMethod method,
+                           std::chrono::nanoseconds remaining)
+{
+    if (!settings_.enabled)
+        return Permit{ nullptr, nullptr };
+
+    auto& limiter = limiters_[ToIndex(method)];
+
+    if (!limiter.FitsDeadline(remaining))
+        return Permit{ "Deadline is shorter than expected latency" };
+
+    if (!HasCapacityFor(limiter.GetPriority()))
+        return Permit{ "Service is overloaded, low priority call shed" };
+
+    if (!limiter.TryAcquire())
+        return Permit{ "Concurrency limit exceeded" };
+
+    total_in_flight_.fetch_add(1, std::memory_order_relaxed);
+    return Permit{ this, &limiter };
+}
+
+const ConcurrencyLimiter&
+AdmissionController::GetLimiter(RpcMethod method) const
+{
+    return limiters_[ToIndex(method)];
+}
+
+std::size_t AdmissionController::GetTotalInFlight() const
+{
+    return total_in_flight_.load(std::memory_order_relaxed);
+}
+
+bool AdmissionController::HasCapacityFor(Priority priority) const
+{
+    const auto kInFlight = static_cast<double>(GetTotalInFlight());
+    const auto kCapacity = static_cast<double>(settings_.total_capacity);
+
+    switch (priority)
+    {
+    case Priority::kCritical:
+        return kInFlight < kCapacity;
+    case Priority::kNormal:
+        return kInFlight < kCapacity * 0.8;
+    case Priority::kBackground:
+        return kInFlight < kCapacity * 0.5;
+    }
+    return true;
+}
+
+} // namespace game_service
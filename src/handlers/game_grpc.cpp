@@ -1,10 +1,20 @@
 #include <handlers/game_grpc.hpp>
 
+#include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/storages/postgres/component.hpp>
 #include <userver/storages/postgres/database.hpp>
 
+#include <managers/igdb_component.hpp>
+#include <tools/deadline.hpp>
 #include <tools/utils.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+
+#include <unordered_map>
+
 namespace {
 
 template <typename Source, typename Destination>
@@ -15,31 +25,296 @@ void MoveToProto(Source& src, Destination* dst)
         *dst->Add() = std::move(item);
 }
 
+void MoveGameToProto(entities::GamePostgres&& pgData, ::games::Game* game)
+{
+    game->set_id(boost::uuids::to_string(pgData.id));
+    game->set_igdb_id(std::move(pgData.igdb_id));
+
+    game->set_name(std::move(pgData.name));
+    game->set_slug(std::move(pgData.slug));
+    game->set_summary(std::move(pgData.summary));
+
+    game->set_igdb_rating(pgData.igdb_rating);
+    game->set_playhub_rating(pgData.playhub_rating);
+    game->set_hypes(pgData.hypes);
+
+    game->set_first_release_date(std::move(pgData.firstReleaseDate));
+    game->set_cover_url(std::move(pgData.coverUrl));
+
+    *game->mutable_created_at() = utils::TimePointToProtobuf(pgData.created_at);
+    *game->mutable_updated_at() = utils::TimePointToProtobuf(pgData.updated_at);
+
+    MoveToProto(pgData.releaseDates, game->mutable_release_dates());
+    MoveToProto(pgData.artworkUrls, game->mutable_artwork_urls());
+    MoveToProto(pgData.screenshots, game->mutable_screenshots());
+    MoveToProto(pgData.genres, game->mutable_genres());
+    MoveToProto(pgData.themes, game->mutable_themes());
+    MoveToProto(pgData.platforms, game->mutable_platforms());
+}
+
+template <typename Context>
+std::chrono::nanoseconds GetRemainingTime(Context& context)
+{
+    const auto kDeadline = context.GetServerContext().deadline();
+    if (kDeadline == std::chrono::system_clock::time_point::max())
+        return std::chrono::nanoseconds::max();
+
+    return kDeadline - std::chrono::system_clock::now();
+}
+
+template <typename Context>
+userver::engine::Deadline GetCallDeadline(Context& context)
+{
+    const auto kRemaining = GetRemainingTime(context);
+    if (kRemaining == std::chrono::nanoseconds::max())
+        return {};
+
+    return userver::engine::Deadline::FromDuration(kRemaining);
+}
+
+// Status to give up with if nobody waits for the call anymore
+template <typename Context>
+std::optional<grpc::Status> CheckAbandoned(Context& context)
+{
+    if (context.GetServerContext().IsCancelled() ||
+        userver::engine::current_task::ShouldCancel())
+        return grpc::Status(grpc::StatusCode::CANCELLED,
+                            "Call is cancelled by the client");
+
+    if (utils::GetCallDeadline().IsReached())
+        return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                            "Deadline exceeded");
+
+    return std::nullopt;
+}
+
+// Ids of the games that made it into Postgres
+std::vector<std::string>
+CollectIds(const pg::IGameRepository::GamesPostgres& games)
+{
+    std::vector<std::string> ids;
+    ids.reserve(games.size());
+
+    for (const auto& game : games)
+        if (!game.id.is_nil())
+            ids.push_back(boost::uuids::to_string(game.id));
+
+    return ids;
+}
+
+// Both ListFilteredGames and GetFacetCounts requests carry the facets
+template <typename Request>
+std::size_t CountFacetValues(const Request& request)
+{
+    return static_cast<std::size_t>(
+        request.genres_size() + request.themes_size() +
+        request.platforms_size() + request.release_years_size());
+}
+
+template <typename Request>
+indexes::FacetFilter MakeFacetFilter(const Request& request)
+{
+    indexes::FacetFilter filter;
+    filter.genres.assign(request.genres().begin(), request.genres().end());
+    filter.themes.assign(request.themes().begin(), request.themes().end());
+    filter.platforms.assign(request.platforms().begin(),
+                            request.platforms().end());
+    filter.release_years.assign(request.release_years().begin(),
+                                request.release_years().end());
+    return filter;
+}
+
+template <typename Destination>
+void MoveFacetCountsToProto(std::vector<indexes::FacetValueCount>& counts,
+                            Destination* dst)
+{
+    dst->Reserve(static_cast<int>(counts.size()));
+    for (auto& count : counts)
+    {
+        auto* item = dst->Add();
+        item->set_value(std::move(count.value));
+        item->set_count(static_cast<std::int64_t>(count.count));
+    }
+}
+
+// Keys of a single BatchGetGames call at most
+constexpr std::size_t kMaxBatchGetKeys = 500;
+
+constexpr std::int32_t kDefaultExportChunk = 100;
+constexpr std::int32_t kMaxExportChunk = 1000;
+
+// Changes per read of a watcher and the longest wait for them, so that
+// abandoned watchers are noticed
+constexpr std::size_t kWatchBatch = 100;
+constexpr std::chrono::seconds kMaxWatchWait{ 1 };
+
+constexpr std::size_t kDefaultSimilarLimit = 10;
+constexpr std::size_t kMaxSimilarLimit = 50;
+
+constexpr std::size_t kDefaultFilteredLimit = 10;
+constexpr std::size_t kMaxFilteredLimit = 100;
+// Values of all facets of a single ListFilteredGames or GetFacetCounts call
+// at most
+constexpr std::size_t kMaxFacetValues = 64;
+
+constexpr std::size_t kDefaultAutocompleteLimit = 5;
+// Longer prefixes only come from pasted text, which SearchGames is for
+constexpr std::size_t kMaxAutocompletePrefix = 128;
+
+constexpr std::size_t kDefaultSemanticLimit = 10;
+constexpr std::size_t kMaxSemanticLimit = 50;
+// A few sentences of description at most
+constexpr std::size_t kMaxSemanticQuery = 1024;
+
+constexpr std::size_t kDefaultTrendingLimit = 10;
+constexpr std::size_t kMaxTrendingLimit = 100;
+
+constexpr std::int32_t kDefaultDeltaLimit = 100;
+constexpr std::int32_t kMaxDeltaLimit = 1000;
+
+grpc::Status
+RejectCall(const game_service::AdmissionController::Permit& permit)
+{
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                        std::string{ permit.GetRejectReason() });
+}
+
 } // namespace
 
 game_service::GameService::GameService(std::string prefix,
                                        const pg::IGameRepository& manager,
-                                       igdb::IIGDBManager& igdb_manager)
+                                       igdb::IIGDBManager& igdb_manager,
+                                       ServiceSettings settings)
     : prefix_(std::move(prefix)), pg_manager_(manager),
-      igdb_manager_(igdb_manager)
-{}
+      igdb_manager_(igdb_manager),
+      refresher_(manager, igdb_manager, settings.refresh),
+      admission_(settings.admission), search_cache_(settings.search_cache),
+      negative_cache_(settings.negative_cache),
+      known_games_(settings.known_games),
+      change_feed_(settings.change_feed),
+      similar_games_(settings.similar_games), facets_(settings.facets),
+      autocomplete_(settings.autocomplete), spelling_(settings.spelling),
+      semantic_search_(settings.semantic_search),
+      trending_(settings.trending), views_(settings.views),
+      leaderboards_(settings.leaderboards),
+      catalog_sync_(settings.catalog_sync, change_feed_)
+{
+    const auto kAdd = [this](std::string name, indexes::ICatalogIndex& index,
+                             bool enabled, std::chrono::seconds period) {
+        if (enabled)
+            catalog_sync_.Add(std::move(name), index, period);
+    };
+    kAdd("known-games", known_games_, settings.known_games.enabled,
+         settings.known_games.rebuild_period);
+    kAdd("similar-games", similar_games_, settings.similar_games.enabled,
+         settings.similar_games.rebuild_period);
+    kAdd("facets", facets_, settings.facets.enabled,
+         settings.facets.rebuild_period);
+    kAdd("autocomplete", autocomplete_, settings.autocomplete.enabled,
+         settings.autocomplete.rebuild_period);
+    kAdd("spelling", spelling_, settings.spelling.enabled,
+         settings.spelling.rebuild_period);
+    kAdd("semantic-search", semantic_search_,
+         settings.semantic_search.enabled,
+         settings.semantic_search.rebuild_period);
+    kAdd("trending", trending_, settings.trending.enabled,
+         settings.trending.rebuild_period);
+    kAdd("leaderboards", leaderboards_, settings.leaderboards.enabled,
+         settings.leaderboards.rebuild_period);
+}
+
+template <typename Call>
+std::optional<igdb::IIGDBManager::GamesInfo>
+game_service::GameService::QueryIgdb(RpcMethod method, std::string_view key,
+                                     AdmissionController::Permit& permit,
+                                     Call&& call)
+{
+    const auto kMethod = ToString(method);
+
+    if (negative_cache_.Contains(kMethod, key))
+        return igdb::IIGDBManager::GamesInfo{};
+
+    if (!igdb_manager_.IsAvailable())
+        return std::nullopt;
+
+    const auto kStarted = std::chrono::steady_clock::now();
+    try
+    {
+        auto games = call();
+        permit.ExcludeLatency(std::chrono::steady_clock::now() - kStarted);
+        if (games.empty())
+            negative_cache_.Add(kMethod, key);
+
+        return games;
+    }
+    catch (const igdb::IgdbError& ex)
+    {
+        permit.ExcludeLatency(std::chrono::steady_clock::now() - kStarted);
+        LOG_WARNING() << kMethod << " answered without IGDB: " << ex.what();
+        return std::nullopt;
+    }
+}
 
 ::games::GameServiceBase::SearchGamesResult
 game_service::GameService::SearchGames(CallContext& context,
                                        ::games::SearchGamesRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kSearchGames);
+    return recorder.Finish(
+        DoSearchGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::SearchGamesResult
+game_service::GameService::DoSearchGames(CallContext& context,
+                                         ::games::SearchGamesRequest&& request,
+                                         CallRecorder& recorder)
+{
+    auto permit =
+        admission_.Admit(RpcMethod::kSearchGames, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
     if (request.query().empty())
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                             "Query cannot be empty");
 
+    const auto kNormalized = utils::NormalizeQuery(request.query());
+
     ::games::GamesListResponse response;
 
     try
     {
+        if (const auto kCachedIds =
+                search_cache_.Get(request.query(), request.limit()))
+        {
+            auto cached_games = pg_manager_.GetGamesByIds(*kCachedIds);
+
+            // Some of the games are gone, search again
+            if (cached_games.size() == kCachedIds->size())
+            {
+                recorder.SetPath(ServingPath::kCacheHit);
+                recorder.SetResultSize(cached_games.size());
+
+                response.mutable_games()->Reserve(cached_games.size());
+                for (auto& game : cached_games)
+                    FillResponseWithPgData(response, std::move(game));
+
+                return response;
+            }
+        }
+
         auto pg_games = pg_manager_.FindGame(request.query(), request.limit());
 
         if (!pg_games.empty())
         {
+            search_cache_.Put(request.query(), request.limit(),
+                              CollectIds(pg_games));
+
+            recorder.SetPath(ServingPath::kPgHit);
+            recorder.SetResultSize(pg_games.size());
+
             response.mutable_games()->Reserve(pg_games.size());
             for (auto& game : pg_games)
                 FillResponseWithPgData(response, std::move(game));
@@ -47,20 +322,73 @@ game_service::GameService::SearchGames(CallContext& context,
             return response;
         }
 
-        const auto kIgdbResults =
-            igdb_manager_.SearchGames(request.query(), request.limit());
+        // Misspelled queries rarely find anything in IGDB either
+        if (const auto kCorrected = spelling_.CorrectQuery(kNormalized))
+        {
+            auto corrected_games =
+                pg_manager_.FindGame(*kCorrected, request.limit());
 
-        if (kIgdbResults.empty())
-            return response;
+            if (!corrected_games.empty())
+            {
+                spelling_.AccountHit();
+                search_cache_.Put(request.query(), request.limit(),
+                                  CollectIds(corrected_games));
+
+                recorder.SetPath(ServingPath::kCorrected);
+                recorder.SetResultSize(corrected_games.size());
+
+                response.mutable_games()->Reserve(corrected_games.size());
+                for (auto& game : corrected_games)
+                    FillResponseWithPgData(response, std::move(game));
+
+                return response;
+            }
+        }
 
-        response.mutable_games()->Reserve(kIgdbResults.size());
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        const auto kIgdbResults =
+            QueryIgdb(RpcMethod::kSearchGames, kNormalized, permit, [&] {
+                return igdb_manager_.SearchGames(request.query(),
+                                                 request.limit());
+            });
 
-        for (const auto& igdb_game : kIgdbResults)
+        if (!kIgdbResults)
         {
-            auto saved_game = pg_manager_.CreateGame(igdb_game);
-            FillResponseWithPgData(response, std::move(saved_game));
+            if (auto status = CheckAbandoned(context))
+                return *status;
+
+            recorder.SetPath(ServingPath::kFallback);
+            recorder.SetResultSize(0);
+            return response;
         }
 
+        recorder.SetResultSize(kIgdbResults->size());
+
+        if (kIgdbResults->empty())
+            return response;
+
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        recorder.SetPath(ServingPath::kIgdbMiss);
+
+        pg::IGameRepository::GamesPostgres saved_games;
+        saved_games.reserve(kIgdbResults->size());
+        for (const auto& igdb_game : *kIgdbResults)
+            saved_games.push_back(SaveIgdbGame(igdb_game));
+
+        // A game that failed to save would be missing from every cached hit
+        auto saved_ids = CollectIds(saved_games);
+        if (saved_ids.size() == saved_games.size())
+            search_cache_.Put(request.query(), request.limit(),
+                              std::move(saved_ids));
+
+        response.mutable_games()->Reserve(saved_games.size());
+        for (auto& game : saved_games)
+            FillResponseWithPgData(response, std::move(game));
+
         return response;
     }
     catch (const std::exception& ex)
@@ -76,17 +404,42 @@ game_service::GameService::SearchGames(CallContext& context,
 game_service::GameService::GetGame(CallContext& context,
                                    ::games::GetGameRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kGetGame);
+    return recorder.Finish(DoGetGame(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetGameResult
+game_service::GameService::DoGetGame(CallContext& context,
+                                     ::games::GetGameRequest&& request,
+                                     CallRecorder& recorder)
+{
+    auto permit =
+        admission_.Admit(RpcMethod::kGetGame, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
     std::optional<entities::GamePostgres> pg_game;
 
     try
     {
+        // A game committed elsewhere passes the filter once the change feed
+        // polls it, up to its settle plus poll period later
         if (request.has_game_id())
         {
+            if (!known_games_.MayContainId(request.game_id()))
+                return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                                    "Game not found by postgres ID");
+
             pg_game = pg_manager_.GetGameById(request.game_id());
 
             if (!pg_game)
+            {
+                known_games_.AccountFalsePositive();
                 return grpc::Status(grpc::StatusCode::NOT_FOUND,
                                     "Game not found by postgres ID");
+            }
         }
 
         else if (request.has_slug())
@@ -96,18 +449,42 @@ game_service::GameService::GetGame(CallContext& context,
                 return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                                     "Slug cannot be empty");
 
+            if (!known_games_.MayContainSlug(kSlug))
+                return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                                    "Game not found in DB or IGDB");
+
             pg_game = pg_manager_.GetGameBySlug(kSlug);
 
             if (!pg_game)
+            {
+                known_games_.AccountFalsePositive();
                 return grpc::Status(grpc::StatusCode::NOT_FOUND,
                                     "Game not found in DB or IGDB");
+            }
         }
 
         else
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                                 "Request must have game_id or slug");
 
+        recorder.SetResultSize(1);
+        views_.Add(pg_game->id);
+
+        utils::VersionToken version;
+        version.Add(boost::uuids::to_string(pg_game->id), pg_game->updated_at);
+
         ::games::GetGameResponse response;
+        response.set_version(version.Get());
+
+        if (request.if_none_match() == response.version())
+        {
+            recorder.SetPath(ServingPath::kNotModified);
+            refresher_.RefreshIfStale(*pg_game);
+            response.set_not_modified(true);
+            return response;
+        }
+
+        recorder.SetPath(ServingPath::kPgHit);
         FillGameProto(response.mutable_game(), std::move(*pg_game));
         return response;
     }
@@ -122,6 +499,23 @@ game_service::GameService::GetGame(CallContext& context,
 game_service::GameService::GetGamesByGenre(
     CallContext& context, ::games::GetGamesByGenreRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kGetGamesByGenre);
+    return recorder.Finish(
+        DoGetGamesByGenre(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetGamesByGenreResult
+game_service::GameService::DoGetGamesByGenre(
+    CallContext& context, ::games::GetGamesByGenreRequest&& request,
+    CallRecorder& recorder)
+{
+    auto permit = admission_.Admit(RpcMethod::kGetGamesByGenre,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
     if (request.genre_name().empty())
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                             "Genre name cannot be empty");
@@ -132,30 +526,68 @@ game_service::GameService::GetGamesByGenre(
 
     try
     {
-        auto pg_games =
-            pg_manager_.GetGamesByGenre(request.genre_name(), kLimit);
+        // The leaderboard keeps the order of the query, so only the rows of
+        // its best games are read. Postgres sorts until it is built
+        pg::IGameRepository::GamesPostgres pg_games;
+        if (const auto kTop =
+                leaderboards_.GetTop(request.genre_name(), kLimit))
+        {
+            std::vector<std::string> ids;
+            ids.reserve(kTop->size());
+            for (const auto& id : *kTop)
+                ids.push_back(boost::uuids::to_string(id));
+
+            // Rows come back in the order of the ids, best rated first
+            pg_games = pg_manager_.GetGamesByIds(ids);
+        }
+        else
+            pg_games =
+                pg_manager_.GetGamesByGenre(request.genre_name(), kLimit);
 
         if (!pg_games.empty())
         {
-            response.mutable_games()->Reserve(pg_games.size());
-            for (auto& game : pg_games)
-            {
-                FillResponseWithPgData(response, std::move(game));
-            }
+            recorder.SetPath(ServingPath::kPgHit);
+            recorder.SetResultSize(pg_games.size());
+
+            FillListResponse(response, request.if_none_match(),
+                             std::move(pg_games), recorder);
             return response;
         }
 
-        const auto kIgdbResults =
-            igdb_manager_.GetGamesByGenre(request.genre_name(), kLimit);
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        const auto kIgdbResults = QueryIgdb(
+            RpcMethod::kGetGamesByGenre,
+            utils::NormalizeQuery(request.genre_name()), permit, [&] {
+                return igdb_manager_.GetGamesByGenre(request.genre_name(),
+                                                     kLimit);
+            });
+
+        if (!kIgdbResults)
+        {
+            if (auto status = CheckAbandoned(context))
+                return *status;
 
-        if (kIgdbResults.empty())
+            recorder.SetPath(ServingPath::kFallback);
+            recorder.SetResultSize(0);
+            return response;
+        }
+
+        recorder.SetResultSize(kIgdbResults->size());
+
+        if (kIgdbResults->empty())
             return response;
 
-        response.mutable_games()->Reserve(kIgdbResults.size());
+        if (auto status = CheckAbandoned(context))
+            return *status;
 
-        for (const auto& igdb_game : kIgdbResults)
+        recorder.SetPath(ServingPath::kIgdbMiss);
+        response.mutable_games()->Reserve(kIgdbResults->size());
+
+        for (const auto& igdb_game : *kIgdbResults)
         {
-            auto saved_game = pg_manager_.CreateGame(igdb_game);
+            auto saved_game = SaveIgdbGame(igdb_game);
             FillResponseWithPgData(response, std::move(saved_game));
         }
 
@@ -173,6 +605,22 @@ game_service::GameService::GetGamesByGenre(
 game_service::GameService::GetTopRatedGames(
     CallContext& context, ::games::GetDiscoveryRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kGetTopRatedGames);
+    return recorder.Finish(
+        DoGetTopRatedGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetTopRatedGamesResult
+game_service::GameService::DoGetTopRatedGames(
+    CallContext& context, ::games::GetDiscoveryRequest&& request,
+    CallRecorder& recorder)
+{
+    auto permit = admission_.Admit(RpcMethod::kGetTopRatedGames,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
 
     const uint32_t kLimit = request.limit() > 0 ? request.limit() : 10;
 
@@ -184,14 +632,15 @@ game_service::GameService::GetTopRatedGames(
 
         if (!pg_games.empty())
         {
-            response.mutable_games()->Reserve(pg_games.size());
-            for (auto& game : pg_games)
-            {
-                FillResponseWithPgData(response, std::move(game));
-            }
+            recorder.SetPath(ServingPath::kPgHit);
+            recorder.SetResultSize(pg_games.size());
+
+            FillListResponse(response, request.if_none_match(),
+                             std::move(pg_games), recorder);
             return response;
         }
 
+        recorder.SetResultSize(0);
         return response;
     }
     catch (const std::exception& ex)
@@ -202,10 +651,141 @@ game_service::GameService::GetTopRatedGames(
     }
 }
 
+::games::GameServiceBase::GetTrendingGamesResult
+game_service::GameService::GetTrendingGames(
+    CallContext& context, ::games::GetDiscoveryRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kGetTrendingGames);
+    return recorder.Finish(
+        DoGetTrendingGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetTrendingGamesResult
+game_service::GameService::DoGetTrendingGames(
+    CallContext& context, ::games::GetDiscoveryRequest&& request,
+    CallRecorder& recorder)
+{
+    auto permit = admission_.Admit(RpcMethod::kGetTrendingGames,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kLimit =
+        request.limit() > 0
+            ? std::min(static_cast<std::size_t>(request.limit()),
+                       kMaxTrendingLimit)
+            : kDefaultTrendingLimit;
+
+    const auto kTop = trending_.GetTop(kLimit);
+    if (!kTop)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Trending index is being built");
+
+    ::games::GamesListResponse response;
+    if (kTop->empty())
+    {
+        recorder.SetPath(ServingPath::kEmpty);
+        recorder.SetResultSize(0);
+        return response;
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(kTop->size());
+    for (const auto& id : *kTop)
+        ids.push_back(boost::uuids::to_string(id));
+
+    try
+    {
+        // Rows come back in the order of the ids, best scored first
+        auto pg_games = pg_manager_.GetGamesByIds(ids);
+
+        recorder.SetResultSize(pg_games.size());
+        recorder.SetPath(pg_games.empty() ? ServingPath::kEmpty
+                                          : ServingPath::kPgHit);
+
+        FillListResponse(response, request.if_none_match(),
+                         std::move(pg_games), recorder);
+        return response;
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR() << "GetTrendingGames failed: " << ex.what();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Internal database error");
+    }
+}
+
+::games::GameServiceBase::GetGenreRankResult
+game_service::GameService::GetGenreRank(
+    CallContext& context, ::games::GetGenreRankRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kGetGenreRank);
+    return recorder.Finish(
+        DoGetGenreRank(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetGenreRankResult
+game_service::GameService::DoGetGenreRank(
+    CallContext& context, ::games::GetGenreRankRequest&& request,
+    CallRecorder& recorder)
+{
+    const auto kCanonical = utils::ToCanonicalUuid(request.game_id());
+    if (!kCanonical)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "game_id is not a uuid");
+    if (request.genre_name().empty())
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Genre name cannot be empty");
+
+    auto permit = admission_.Admit(RpcMethod::kGetGenreRank,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    if (!leaderboards_.IsReady())
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Genre leaderboards are being built");
+
+    const auto kRank =
+        leaderboards_.GetRank(boost::uuids::string_generator{}(*kCanonical),
+                              request.genre_name());
+    if (!kRank)
+        return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                            "Game not found in the genre");
+
+    recorder.SetPath(ServingPath::kIndexHit);
+    recorder.SetResultSize(1);
+
+    ::games::GetGenreRankResponse response;
+    response.set_igdb_rank(static_cast<std::int32_t>(kRank->igdb_rank));
+    response.set_playhub_rank(static_cast<std::int32_t>(kRank->playhub_rank));
+    response.set_games(static_cast<std::int32_t>(kRank->games));
+    return response;
+}
+
 ::games::GameServiceBase::GetUpcomingGamesResult
 game_service::GameService::GetUpcomingGames(
     CallContext& context, ::games::GetDiscoveryRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kGetUpcomingGames);
+    return recorder.Finish(
+        DoGetUpcomingGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetUpcomingGamesResult
+game_service::GameService::DoGetUpcomingGames(
+    CallContext& context, ::games::GetDiscoveryRequest&& request,
+    CallRecorder& recorder)
+{
+    auto permit = admission_.Admit(RpcMethod::kGetUpcomingGames,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
     const uint32_t kLimit = request.limit() > 0 ? request.limit() : 5;
 
     ::games::GamesListResponse response;
@@ -216,24 +796,46 @@ game_service::GameService::GetUpcomingGames(
 
         if (!pg_games.empty())
         {
-            response.mutable_games()->Reserve(pg_games.size());
-            for (auto& game : pg_games)
-            {
-                FillResponseWithPgData(response, std::move(game));
-            }
+            recorder.SetPath(ServingPath::kPgHit);
+            recorder.SetResultSize(pg_games.size());
+
+            FillListResponse(response, request.if_none_match(),
+                             std::move(pg_games), recorder);
+            return response;
+        }
+
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        const auto kIgdbResults =
+            QueryIgdb(RpcMethod::kGetUpcomingGames, "", permit, [&] {
+                return igdb_manager_.GetUpcomingGames(kLimit);
+            });
+
+        if (!kIgdbResults)
+        {
+            if (auto status = CheckAbandoned(context))
+                return *status;
+
+            recorder.SetPath(ServingPath::kFallback);
+            recorder.SetResultSize(0);
             return response;
         }
 
-        const auto kIgdbResults = igdb_manager_.GetUpcomingGames(kLimit);
+        recorder.SetResultSize(kIgdbResults->size());
 
-        if (kIgdbResults.empty())
+        if (kIgdbResults->empty())
             return response;
 
-        response.mutable_games()->Reserve(kIgdbResults.size());
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        recorder.SetPath(ServingPath::kIgdbMiss);
+        response.mutable_games()->Reserve(kIgdbResults->size());
 
-        for (const auto& igdb_game : kIgdbResults)
+        for (const auto& igdb_game : *kIgdbResults)
         {
-            auto saved_game = pg_manager_.CreateGame(igdb_game);
+            auto saved_game = SaveIgdbGame(igdb_game);
             FillResponseWithPgData(response, std::move(saved_game));
         }
 
@@ -251,6 +853,21 @@ game_service::GameService::GetUpcomingGames(
 game_service::GameService::ListGames(CallContext& context,
                                      ::games::ListGamesRequest&& request)
 {
+    CallRecorder recorder(statistics_, RpcMethod::kListGames);
+    return recorder.Finish(DoListGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::ListGamesResult
+game_service::GameService::DoListGames(CallContext& context,
+                                       ::games::ListGamesRequest&& request,
+                                       CallRecorder& recorder)
+{
+    auto permit =
+        admission_.Admit(RpcMethod::kListGames, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
 
     LOG_INFO() << "Limit: " << request.limit()
                << " Offset: " << request.offset();
@@ -267,15 +884,20 @@ game_service::GameService::ListGames(CallContext& context,
 
     try
     {
+        // Pages past the end still tell how many there are
+        FillTotalCount(response, request.total_count());
+
         auto pg_games = pg_manager_.GetAllGames(kLimit, kOffset, kSortingType);
 
+        recorder.SetResultSize(pg_games.size());
+
         if (pg_games.empty())
             return response;
 
-        response.mutable_games()->Reserve(pg_games.size());
-        for (auto& game : pg_games)
-            FillResponseWithPgData(response, std::move(game));
+        recorder.SetPath(ServingPath::kPgHit);
 
+        FillListResponse(response, request.if_none_match(),
+                         std::move(pg_games), recorder);
         return response;
     }
     catch (const std::exception& ex)
@@ -290,63 +912,896 @@ game_service::GameService::ListGames(CallContext& context,
 game_service::GameService::SetRating(CallContext& context,
                                      ::games::RatingRequest&& request)
 {
-    try
-    {
-        if (request.game_id().empty())
-            return google::protobuf::Empty{};
+    CallRecorder recorder(statistics_, RpcMethod::kSetRating);
+    return recorder.Finish(DoSetRating(context, std::move(request), recorder));
+}
 
-        LOG_INFO() << "update rating" << request.rating() << request.game_id();
+::games::GameServiceBase::SetRatingResult
+game_service::GameService::DoSetRating(CallContext& context,
+                                       ::games::RatingRequest&& request,
+                                       CallRecorder& recorder)
+{
+    auto permit =
+        admission_.Admit(RpcMethod::kSetRating, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
 
-        pg_manager_.UpdateGameRating(request.game_id(), request.rating());
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kCanonical = utils::ToCanonicalUuid(request.game_id());
+    if (!kCanonical)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "game_id is not a uuid");
+
+    try
+    {
+        LOG_INFO() << "update rating" << request.rating() << *kCanonical;
+
+        const auto kUpdated =
+            pg_manager_.UpdateGameRating(*kCanonical, request.rating());
+        if (!kUpdated)
+            return grpc::Status(grpc::StatusCode::INTERNAL,
+                                "Rating is not updated");
+        if (!*kUpdated)
+            return grpc::Status(grpc::StatusCode::NOT_FOUND, "Game not found");
+        recorder.SetPath(ServingPath::kPgHit);
+
+        // Only a stored rating moves the game, catch-ups would never undo
+        // one that isn't
+        const auto kId = boost::uuids::string_generator{}(*kCanonical);
+        trending_.AccountRating(kId, request.rating());
+        leaderboards_.AccountRating(kId, request.rating());
 
         return google::protobuf::Empty{};
     }
-    catch (const std::runtime_error& ex)
+    catch (const std::exception& ex)
     {
-        LOG_ERROR() << "Invalid UUID in reviews: " << request.game_id();
+        LOG_ERROR() << "Rating is not updated " << ex.what();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Internal database error");
+    }
+}
+
+::games::GameServiceBase::BatchGetGamesResult
+game_service::GameService::BatchGetGames(
+    CallContext& context, ::games::BatchGetGamesRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kBatchGetGames);
+    return recorder.Finish(
+        DoBatchGetGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::BatchGetGamesResult
+game_service::GameService::DoBatchGetGames(
+    CallContext& context, ::games::BatchGetGamesRequest&& request,
+    CallRecorder& recorder)
+{
+    const auto kKeyCount = static_cast<std::size_t>(request.game_ids_size()) +
+                           static_cast<std::size_t>(request.slugs_size());
+    if (kKeyCount == 0)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Request must have game_ids or slugs");
+    if (kKeyCount > kMaxBatchGetKeys)
         return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                            "Invalid game_id in reviews");
+                            "Too many game_ids and slugs in one request");
+
+    auto permit =
+        admission_.Admit(RpcMethod::kBatchGetGames, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    // Malformed and surely unknown keys never reach Postgres
+    std::vector<std::optional<std::string>> canonical_ids;
+    canonical_ids.reserve(request.game_ids_size());
+
+    std::vector<std::string> ids;
+    for (const auto& id : request.game_ids())
+    {
+        auto canonical = utils::ToCanonicalUuid(id);
+        if (canonical && !known_games_.MayContainId(*canonical))
+            canonical.reset();
+
+        if (canonical)
+            ids.push_back(*canonical);
+        canonical_ids.push_back(std::move(canonical));
+    }
+
+    std::vector<std::string> slugs;
+    for (const auto& slug : request.slugs())
+        if (!slug.empty() && known_games_.MayContainSlug(slug))
+            slugs.push_back(slug);
+
+    try
+    {
+        auto pg_games = pg_manager_.GetGamesByKeys(ids, slugs);
+
+        std::unordered_map<std::string, std::size_t> by_id;
+        std::unordered_map<std::string_view, std::size_t> by_slug;
+        for (std::size_t i = 0; i < pg_games.size(); ++i)
+        {
+            by_id.emplace(boost::uuids::to_string(pg_games[i].id), i);
+            by_slug.emplace(pg_games[i].slug, i);
+        }
+
+        ::games::BatchGetGamesResponse response;
+        response.mutable_items()->Reserve(static_cast<int>(kKeyCount));
+        std::size_t found = 0;
+
+        const auto kFillItem = [this, &pg_games, &found](
+                               ::games::BatchGetGamesItem* item,
+                               const auto& index, const auto& key) {
+            const auto kGame = index.find(key);
+            if (kGame == index.end())
+                return;
+
+            item->set_found(true);
+            FillGameProto(item->mutable_game(),
+                          entities::GamePostgres{ pg_games[kGame->second] });
+            ++found;
+        };
+
+        for (std::size_t i = 0; i < canonical_ids.size(); ++i)
+        {
+            auto* item = response.add_items();
+            item->set_game_id(request.game_ids(static_cast<int>(i)));
+
+            if (canonical_ids[i])
+                kFillItem(item, by_id, *canonical_ids[i]);
+        }
+
+        for (const auto& slug : request.slugs())
+        {
+            auto* item = response.add_items();
+            item->set_slug(slug);
+            kFillItem(item, by_slug, std::string_view{ slug });
+        }
+
+        recorder.SetResultSize(found);
+        if (found != 0)
+            recorder.SetPath(ServingPath::kPgHit);
+
+        return response;
     }
     catch (const std::exception& ex)
     {
-        LOG_ERROR() << "Rating is not updated " << ex.what();
+        LOG_ERROR() << "BatchGetGames failed: " << ex.what();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Internal database error");
+    }
+}
+
+::games::GameServiceBase::ExportGamesResult
+game_service::GameService::ExportGames(CallContext& context,
+                                       ::games::ExportGamesRequest&& request,
+                                       ExportGamesWriter& writer)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kExportGames);
+    return recorder.Finish(
+        DoExportGames(context, std::move(request), writer, recorder));
+}
+
+grpc::Status
+game_service::GameService::DoExportGames(CallContext& context,
+                                         ::games::ExportGamesRequest&& request,
+                                         ExportGamesWriter& writer,
+                                         CallRecorder& recorder)
+{
+    auto permit =
+        admission_.Admit(RpcMethod::kExportGames, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kChunkSize =
+        request.chunk_size() > 0
+            ? std::min(request.chunk_size(), kMaxExportChunk)
+            : kDefaultExportChunk;
+
+    std::string after_id{ utils::kNilUuid };
+    if (!request.after_id().empty())
+    {
+        auto canonical = utils::ToCanonicalUuid(request.after_id());
+        if (!canonical)
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "after_id is not a uuid");
+        after_id = std::move(*canonical);
+    }
+
+    const auto kUpdatedSince =
+        request.has_updated_since()
+            ? utils::ProtobufToTimePoint(request.updated_since())
+            : userver::storages::postgres::TimePointWithoutTz{};
+
+    // One chunk in memory at a time. Write blocks until gRPC takes the
+    // chunk, so a slow reader slows the scan down
+    std::size_t exported = 0;
+    while (true)
+    {
+        if (auto status = CheckAbandoned(context))
+            return *status;
+
+        auto pg_games =
+            pg_manager_.ScanGames(after_id, kUpdatedSince, kChunkSize);
+        if (!pg_games)
+            return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                                "Catalog scan failed, resume from last_id");
+        if (pg_games->empty())
+            break;
+
+        after_id = boost::uuids::to_string(pg_games->back().id);
+        const auto kCount = pg_games->size();
+
+        ::games::ExportGamesChunk chunk;
+        chunk.mutable_games()->Reserve(static_cast<int>(kCount));
+        for (auto& game : *pg_games)
+            MoveGameToProto(std::move(game), chunk.add_games());
+        chunk.set_last_id(after_id);
+
+        writer.Write(chunk);
+
+        exported += kCount;
+        if (kCount < static_cast<std::size_t>(kChunkSize))
+            break;
+    }
+
+    recorder.SetResultSize(exported);
+    if (exported != 0)
+        recorder.SetPath(ServingPath::kPgHit);
+
+    return grpc::Status::OK;
+}
+
+::games::GameServiceBase::WatchGamesResult
+game_service::GameService::WatchGames(CallContext& context,
+                                      ::games::WatchGamesRequest&& request,
+                                      WatchGamesWriter& writer)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kWatchGames);
+    return recorder.Finish(
+        DoWatchGames(context, std::move(request), writer, recorder));
+}
+
+grpc::Status
+game_service::GameService::DoWatchGames(CallContext& context,
+                                        ::games::WatchGamesRequest&& request,
+                                        WatchGamesWriter& writer,
+                                        CallRecorder& recorder)
+{
+    const auto& kSettings = change_feed_.GetSettings();
+    if (!kSettings.enabled)
+        return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                            "Change feed is disabled");
+
+    feed::ChangeFeed::WatcherScope watcher(change_feed_);
+    if (!watcher)
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                            "Too many watchers");
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    std::optional<entities::ChangeCursor> cursor;
+    if (!request.resume_token().empty())
+    {
+        cursor = feed::DecodeResumeToken(request.resume_token());
+        if (!cursor)
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "resume_token is malformed");
+    }
+    else
+    {
+        cursor = change_feed_.GetHead();
+        if (!cursor)
+            return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                                "Change feed is starting, retry later");
+    }
+
+    // Every watcher waits on the same in-memory log. Only those behind it
+    // read Postgres, each from its own cursor
+    std::size_t sent = 0;
+    std::optional<grpc::Status> status;
+    while (!(status = CheckAbandoned(context)))
+    {
+        const auto kWaitDeadline =
+            std::min(utils::GetCallDeadline(),
+                     userver::engine::Deadline::FromDuration(kMaxWatchWait));
+
+        auto read = change_feed_.ReadAfter(*cursor, kWatchBatch, kWaitDeadline);
+        if (read.behind)
+        {
+            auto changes = change_feed_.CatchUp(
+                pg_manager_, *cursor, static_cast<std::int32_t>(kWatchBatch));
+            if (!changes)
+            {
+                status = grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                                      "Change scan failed, resume from the "
+                                      "last resume_token");
+                break;
+            }
+            if (changes->empty())
+                userver::engine::InterruptibleSleepFor(kSettings.poll_period);
+
+            read.changes = std::move(*changes);
+        }
+
+        for (auto& change : read.changes)
+        {
+            ::games::WatchGamesEvent event;
+            MoveGameToProto(std::move(change.game), event.mutable_game());
+            event.set_resume_token(feed::EncodeResumeToken(change.cursor));
+
+            writer.Write(event);
+            cursor = std::move(change.cursor);
+        }
+        sent += read.changes.size();
+    }
+
+    recorder.SetResultSize(sent);
+    if (sent != 0)
+        recorder.SetPath(ServingPath::kPgHit);
+
+    return *status;
+}
+
+::games::GameServiceBase::GetGamesUpdatedSinceResult
+game_service::GameService::GetGamesUpdatedSince(
+    CallContext& context, ::games::GetGamesUpdatedSinceRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kGetGamesUpdatedSince);
+    return recorder.Finish(
+        DoGetGamesUpdatedSince(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetGamesUpdatedSinceResult
+game_service::GameService::DoGetGamesUpdatedSince(
+    CallContext& context, ::games::GetGamesUpdatedSinceRequest&& request,
+    CallRecorder& recorder)
+{
+    auto permit = admission_.Admit(RpcMethod::kGetGamesUpdatedSince,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kLimit = request.limit() > 0
+                            ? std::min(request.limit(), kMaxDeltaLimit)
+                            : kDefaultDeltaLimit;
+
+    // An empty watermark asks for the whole catalog
+    entities::ChangeCursor after;
+    if (!request.watermark().empty())
+    {
+        auto cursor = feed::DecodeResumeToken(request.watermark());
+        if (!cursor)
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "watermark is malformed");
+        after = std::move(*cursor);
+    }
+
+    // Same settle delay as the change feed, so a transaction still running
+    // can't commit a change behind the returned watermark
+    auto pg_games = pg_manager_.ScanChanges(
+        after, change_feed_.GetSettings().settle, kLimit + 1);
+    if (!pg_games)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Change scan failed, retry later");
+
+    ::games::GetGamesUpdatedSinceResponse response;
+
+    const bool kHasMore = pg_games->size() > static_cast<std::size_t>(kLimit);
+    if (kHasMore)
+        pg_games->pop_back();
+    response.set_has_more(kHasMore);
+
+    auto changes = feed::MakeChanges(std::move(*pg_games));
+    if (!changes.empty())
+        after = changes.back().cursor;
+    response.set_watermark(feed::EncodeResumeToken(after));
+
+    recorder.SetResultSize(changes.size());
+    recorder.SetPath(changes.empty() ? ServingPath::kNotModified
+                                     : ServingPath::kPgHit);
+
+    response.mutable_games()->Reserve(static_cast<int>(changes.size()));
+    for (auto& change : changes)
+        FillGameProto(response.add_games(), std::move(change.game));
+
+    return response;
+}
+
+::games::GameServiceBase::GetSimilarGamesResult
+game_service::GameService::GetSimilarGames(
+    CallContext& context, ::games::GetSimilarGamesRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kGetSimilarGames);
+    return recorder.Finish(
+        DoGetSimilarGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetSimilarGamesResult
+game_service::GameService::DoGetSimilarGames(
+    CallContext& context, ::games::GetSimilarGamesRequest&& request,
+    CallRecorder& recorder)
+{
+    const auto kCanonical = utils::ToCanonicalUuid(request.game_id());
+    if (!kCanonical)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "game_id is not a uuid");
+
+    auto permit = admission_.Admit(RpcMethod::kGetSimilarGames,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    if (!similar_games_.IsReady())
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Similar games index is being built");
+
+    const auto kLimit =
+        request.limit() > 0
+            ? std::min(static_cast<std::size_t>(request.limit()),
+                       kMaxSimilarLimit)
+            : kDefaultSimilarLimit;
+
+    const auto kSimilar = similar_games_.FindSimilar(
+        boost::uuids::string_generator{}(*kCanonical), kLimit);
+    if (!kSimilar)
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Game not found");
+
+    std::vector<std::string> ids;
+    std::unordered_map<std::string, double> scores;
+    ids.reserve(kSimilar->size());
+    for (const auto& similar : *kSimilar)
+    {
+        ids.push_back(boost::uuids::to_string(similar.id));
+        scores.emplace(ids.back(), similar.score);
+    }
+
+    try
+    {
+        // Rows come back in the order of the ids, most similar first
+        auto pg_games = pg_manager_.GetGamesByIds(ids);
+
+        recorder.SetResultSize(pg_games.size());
+        recorder.SetPath(pg_games.empty() ? ServingPath::kEmpty
+                                          : ServingPath::kPgHit);
+
+        ::games::GetSimilarGamesResponse response;
+        response.mutable_games()->Reserve(static_cast<int>(pg_games.size()));
+        for (auto& game : pg_games)
+        {
+            auto* item = response.add_games();
+            item->set_score(scores[boost::uuids::to_string(game.id)]);
+            FillGameProto(item->mutable_game(), std::move(game));
+        }
+
+        return response;
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR() << "GetSimilarGames failed: " << ex.what();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Internal database error");
+    }
+}
+
+::games::GameServiceBase::ListFilteredGamesResult
+game_service::GameService::ListFilteredGames(
+    CallContext& context, ::games::ListFilteredGamesRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kListFilteredGames);
+    return recorder.Finish(
+        DoListFilteredGames(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::ListFilteredGamesResult
+game_service::GameService::DoListFilteredGames(
+    CallContext& context, ::games::ListFilteredGamesRequest&& request,
+    CallRecorder& recorder)
+{
+    if (CountFacetValues(request) > kMaxFacetValues)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Too many facet values in one request");
+
+    auto permit = admission_.Admit(RpcMethod::kListFilteredGames,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kLimit =
+        request.limit() > 0
+            ? std::min(static_cast<std::size_t>(request.limit()),
+                       kMaxFilteredLimit)
+            : kDefaultFilteredLimit;
+    const auto kOffset =
+        static_cast<std::size_t>(std::max(request.offset(), 0));
+
+    const auto kPage = facets_.Filter(MakeFacetFilter(request),
+                                      request.filter(), kLimit, kOffset);
+    if (!kPage)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Facet index is being built");
+
+    ::games::ListFilteredGamesResponse response;
+    response.set_total(static_cast<std::int64_t>(kPage->total));
+
+    if (kPage->ids.empty())
+    {
+        recorder.SetPath(ServingPath::kEmpty);
+        recorder.SetResultSize(0);
+        return response;
+    }
+
+    std::vector<std::string> ids;
+    ids.reserve(kPage->ids.size());
+    for (const auto& id : kPage->ids)
+        ids.push_back(boost::uuids::to_string(id));
+
+    try
+    {
+        // Rows come back in the order of the ids
+        auto pg_games = pg_manager_.GetGamesByIds(ids);
+
+        recorder.SetPath(ServingPath::kPgHit);
+        recorder.SetResultSize(pg_games.size());
+
+        response.mutable_games()->Reserve(static_cast<int>(pg_games.size()));
+        for (auto& game : pg_games)
+            FillGameProto(response.add_games(), std::move(game));
+
+        return response;
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR() << "ListFilteredGames failed: " << ex.what();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Internal database error");
+    }
+}
+
+::games::GameServiceBase::GetFacetCountsResult
+game_service::GameService::GetFacetCounts(
+    CallContext& context, ::games::GetFacetCountsRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kGetFacetCounts);
+    return recorder.Finish(
+        DoGetFacetCounts(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::GetFacetCountsResult
+game_service::GameService::DoGetFacetCounts(
+    CallContext& context, ::games::GetFacetCountsRequest&& request,
+    CallRecorder& recorder)
+{
+    if (CountFacetValues(request) > kMaxFacetValues)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Too many facet values in one request");
+
+    auto permit = admission_.Admit(RpcMethod::kGetFacetCounts,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    auto counts = facets_.Count(MakeFacetFilter(request));
+    if (!counts)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Facet index is being built");
+
+    recorder.SetPath(ServingPath::kIndexHit);
+    recorder.SetResultSize(counts->genres.size() + counts->themes.size() +
+                           counts->platforms.size() +
+                           counts->release_years.size());
+
+    ::games::GetFacetCountsResponse response;
+    response.set_total(static_cast<std::int64_t>(counts->total));
+    MoveFacetCountsToProto(counts->genres, response.mutable_genres());
+    MoveFacetCountsToProto(counts->themes, response.mutable_themes());
+    MoveFacetCountsToProto(counts->platforms, response.mutable_platforms());
+    MoveFacetCountsToProto(counts->release_years,
+                           response.mutable_release_years());
+
+    return response;
+}
+
+::games::GameServiceBase::AutocompleteResult
+game_service::GameService::Autocomplete(CallContext& context,
+                                        ::games::AutocompleteRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kAutocomplete);
+    return recorder.Finish(
+        DoAutocomplete(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::AutocompleteResult
+game_service::GameService::DoAutocomplete(
+    CallContext& context, ::games::AutocompleteRequest&& request,
+    CallRecorder& recorder)
+{
+    if (request.prefix().size() > kMaxAutocompletePrefix)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "prefix is too long");
+
+    auto permit =
+        admission_.Admit(RpcMethod::kAutocomplete, GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    const auto kLimit = request.limit() > 0
+                            ? static_cast<std::size_t>(request.limit())
+                            : kDefaultAutocompleteLimit;
+
+    const auto kSuggestions = autocomplete_.Suggest(request.prefix(), kLimit);
+    if (!kSuggestions)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Autocomplete index is being built");
+
+    recorder.SetPath(kSuggestions->empty() ? ServingPath::kEmpty
+                                           : ServingPath::kIndexHit);
+    recorder.SetResultSize(kSuggestions->size());
+
+    ::games::AutocompleteResponse response;
+    response.mutable_suggestions()->Reserve(
+        static_cast<int>(kSuggestions->size()));
+    for (const auto& suggestion : *kSuggestions)
+    {
+        auto* item = response.add_suggestions();
+        item->set_id(boost::uuids::to_string(suggestion.id));
+        item->set_name(suggestion.name);
+        item->set_slug(suggestion.slug);
+    }
+
+    return response;
+}
+
+::games::GameServiceBase::SemanticSearchResult
+game_service::GameService::SemanticSearch(
+    CallContext& context, ::games::SemanticSearchRequest&& request)
+{
+    CallRecorder recorder(statistics_, RpcMethod::kSemanticSearch);
+    return recorder.Finish(
+        DoSemanticSearch(context, std::move(request), recorder));
+}
+
+::games::GameServiceBase::SemanticSearchResult
+game_service::GameService::DoSemanticSearch(
+    CallContext& context, ::games::SemanticSearchRequest&& request,
+    CallRecorder& recorder)
+{
+    if (request.query().empty())
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Query cannot be empty");
+    if (request.query().size() > kMaxSemanticQuery)
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "Query is too long");
+
+    auto permit = admission_.Admit(RpcMethod::kSemanticSearch,
+                                   GetRemainingTime(context));
+    if (!permit)
+        return RejectCall(permit);
+
+    utils::CallDeadlineScope deadline_scope(GetCallDeadline(context));
+
+    const auto kLimit =
+        request.limit() > 0
+            ? std::min(static_cast<std::size_t>(request.limit()),
+                       kMaxSemanticLimit)
+            : kDefaultSemanticLimit;
+
+    const auto kMatches = semantic_search_.Search(request.query(), kLimit);
+    if (!kMatches)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                            "Semantic index is being built");
+
+    std::vector<std::string> ids;
+    std::unordered_map<std::string, double> scores;
+    ids.reserve(kMatches->size());
+    for (const auto& match : *kMatches)
+    {
+        ids.push_back(boost::uuids::to_string(match.id));
+        scores.emplace(ids.back(), match.score);
+    }
+
+    ::games::SemanticSearchResponse response;
+    if (ids.empty())
+    {
+        recorder.SetPath(ServingPath::kEmpty);
+        recorder.SetResultSize(0);
+        return response;
+    }
+
+    try
+    {
+        // Rows come back in the order of the ids, most similar first
+        auto pg_games = pg_manager_.GetGamesByIds(ids);
+
+        recorder.SetResultSize(pg_games.size());
+        recorder.SetPath(pg_games.empty() ? ServingPath::kEmpty
+                                          : ServingPath::kPgHit);
+
+        response.mutable_games()->Reserve(static_cast<int>(pg_games.size()));
+        for (auto& game : pg_games)
+        {
+            auto* item = response.add_games();
+            item->set_score(scores[boost::uuids::to_string(game.id)]);
+            FillGameProto(item->mutable_game(), std::move(game));
+        }
+
+        return response;
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR() << "SemanticSearch failed: " << ex.what();
         return grpc::Status(grpc::StatusCode::INTERNAL,
                             "Internal database error");
     }
 }
 
+const cache::SearchCache& game_service::GameService::GetSearchCache() const
+{
+    return search_cache_;
+}
+
+const cache::NegativeCache& game_service::GameService::GetNegativeCache() const
+{
+    return negative_cache_;
+}
+
+indexes::KnownGamesFilter& game_service::GameService::GetKnownGames()
+{
+    return known_games_;
+}
+
+feed::ChangeFeed& game_service::GameService::GetChangeFeed()
+{
+    return change_feed_;
+}
+
+indexes::SimilarGamesIndex& game_service::GameService::GetSimilarGames()
+{
+    return similar_games_;
+}
+
+indexes::FacetIndex& game_service::GameService::GetFacets()
+{
+    return facets_;
+}
+
+indexes::AutocompleteIndex& game_service::GameService::GetAutocomplete()
+{
+    return autocomplete_;
+}
+
+indexes::SpellingCorrector& game_service::GameService::GetSpelling()
+{
+    return spelling_;
+}
+
+indexes::SemanticIndex& game_service::GameService::GetSemanticSearch()
+{
+    return semantic_search_;
+}
+
+indexes::TrendingIndex& game_service::GameService::GetTrending()
+{
+    return trending_;
+}
+
+counters::ViewCounters& game_service::GameService::GetViewCounters()
+{
+    return views_;
+}
+
+indexes::GenreLeaderboards& game_service::GameService::GetLeaderboards()
+{
+    return leaderboards_;
+}
+
+indexes::CatalogSync& game_service::GameService::GetCatalogSync()
+{
+    return catalog_sync_;
+}
+
+const game_service::RpcStatistics&
+game_service::GameService::GetStatistics() const
+{
+    return statistics_;
+}
+
+entities::GamePostgres
+game_service::GameService::SaveIgdbGame(const entities::GameInfo& igdb_game)
+{
+    auto saved_game = pg_manager_.CreateGame(igdb_game);
+    if (!saved_game.id.is_nil())
+    {
+        known_games_.Add(boost::uuids::to_string(saved_game.id),
+                         saved_game.slug);
+        similar_games_.Upsert(saved_game);
+        facets_.Upsert(saved_game);
+        autocomplete_.Upsert(saved_game);
+        semantic_search_.Upsert(saved_game);
+        trending_.Upsert(saved_game);
+        leaderboards_.Upsert(saved_game);
+    }
+
+    search_cache_.InvalidateMatching(saved_game.name);
+    return saved_game;
+}
+
 void game_service::GameService::FillResponseWithPgData(
-    ::games::GamesListResponse& response, entities::GamePostgres&& pgData) const
+    ::games::GamesListResponse& response, entities::GamePostgres&& pgData)
 {
     FillGameProto(response.add_games(), std::move(pgData));
 }
 
+void game_service::GameService::FillListResponse(
+    ::games::GamesListResponse& response, std::string_view known_version,
+    pg::IGameRepository::GamesPostgres&& games, CallRecorder& recorder)
+{
+    utils::VersionToken version;
+    for (const auto& game : games)
+        version.Add(boost::uuids::to_string(game.id), game.updated_at);
+    response.set_version(version.Get());
+
+    if (known_version == response.version())
+    {
+        recorder.SetPath(ServingPath::kNotModified);
+        response.set_not_modified(true);
+
+        for (const auto& game : games)
+            refresher_.RefreshIfStale(game);
+        return;
+    }
+
+    response.mutable_games()->Reserve(games.size());
+    for (auto& game : games)
+        FillResponseWithPgData(response, std::move(game));
+}
+
 void game_service::GameService::FillGameProto(
-    ::games::Game* game, entities::GamePostgres&& pgData) const
+    ::games::Game* game, entities::GamePostgres&& pgData)
 {
-    game->set_id(boost::uuids::to_string(pgData.id));
-    game->set_igdb_id(std::move(pgData.igdb_id));
+    refresher_.RefreshIfStale(pgData);
+    MoveGameToProto(std::move(pgData), game);
+}
 
-    game->set_name(std::move(pgData.name));
-    game->set_slug(std::move(pgData.slug));
-    game->set_summary(std::move(pgData.summary));
+// An exact count scans the table, so it is done only on request and a
+// failed one falls back to the estimate. The facet index counts every
+// game up to its last catch-up, the planner statistics stand in until it
+// is built
+void game_service::GameService::FillTotalCount(
+    ::games::GamesListResponse& response, ::games::TotalCount requested)
+{
+    if (requested == ::games::TotalCount::TOTAL_COUNT_NONE)
+        return;
 
-    game->set_igdb_rating(pgData.igdb_rating);
-    game->set_playhub_rating(pgData.playhub_rating);
-    game->set_hypes(pgData.hypes);
+    if (requested == ::games::TotalCount::TOTAL_COUNT_EXACT)
+    {
+        if (const auto kCount = pg_manager_.CountGames())
+        {
+            response.set_total(*kCount);
+            response.set_total_count(::games::TotalCount::TOTAL_COUNT_EXACT);
+            return;
+        }
+    }
 
-    game->set_first_release_date(std::move(pgData.firstReleaseDate));
-    game->set_cover_url(std::move(pgData.coverUrl));
+    std::optional<std::int64_t> estimate;
+    if (const auto kIndexed = facets_.GetGameCount())
+        estimate = static_cast<std::int64_t>(*kIndexed);
+    else
+        estimate = pg_manager_.EstimateGameCount();
 
-    *game->mutable_created_at() = utils::TimePointToProtobuf(pgData.created_at);
-    *game->mutable_updated_at() = utils::TimePointToProtobuf(pgData.updated_at);
+    if (!estimate)
+        return;
 
-    MoveToProto(pgData.releaseDates, game->mutable_release_dates());
-    MoveToProto(pgData.artworkUrls, game->mutable_artwork_urls());
-    MoveToProto(pgData.screenshots, game->mutable_screenshots());
-    MoveToProto(pgData.genres, game->mutable_genres());
-    MoveToProto(pgData.themes, game->mutable_themes());
-    MoveToProto(pgData.platforms, game->mutable_platforms());
+    response.set_total(*estimate);
+    response.set_total_count(::games::TotalCount::TOTAL_COUNT_ESTIMATED);
 }
 
 game_service::GameServiceComponent::GameServiceComponent(
@@ -357,10 +1812,336 @@ game_service::GameServiceComponent::GameServiceComponent(
           context
               .FindComponent<userver::components::Postgres>("playhub-games-db")
               .GetCluster()),
-      igdb_manager_(), service_(config["game-prefix"].As<std::string>(),
-                                pg_manager_, igdb_manager_)
+      batching_repository_(pg_manager_, ParseBatchSettings(config)),
+      service_(config["game-prefix"].As<std::string>(), batching_repository_,
+               context.FindComponent<igdb::IgdbComponent>().GetManager(),
+               ParseSettings(config))
 {
     RegisterService(service_);
+
+    auto& storage =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage();
+    statistics_entry_ = storage.RegisterWriter(
+        "game-service.rpc",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = service_.GetStatistics();
+        });
+    cache_statistics_entry_ = storage.RegisterWriter(
+        "game-service.cache",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer["search"] = service_.GetSearchCache();
+            writer["negative"] = service_.GetNegativeCache();
+        });
+    batching_statistics_entry_ = storage.RegisterWriter(
+        "game-service.lookup-batching",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = batching_repository_;
+        });
+    change_feed_statistics_entry_ = storage.RegisterWriter(
+        "game-service.change-feed",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = service_.GetChangeFeed();
+        });
+    indexes_statistics_entry_ = storage.RegisterWriter(
+        "game-service.indexes",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer["known-games"] = service_.GetKnownGames();
+            writer["similar-games"] = service_.GetSimilarGames();
+            writer["facets"] = service_.GetFacets();
+            writer["autocomplete"] = service_.GetAutocomplete();
+            writer["spelling"] = service_.GetSpelling();
+            writer["semantic-search"] = service_.GetSemanticSearch();
+            writer["trending"] = service_.GetTrending();
+            writer["leaderboards"] = service_.GetLeaderboards();
+            writer["sync"] = service_.GetCatalogSync();
+        });
+    views_statistics_entry_ = storage.RegisterWriter(
+        "game-service.views",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = service_.GetViewCounters();
+        });
+
+    auto& change_feed = service_.GetChangeFeed();
+    if (change_feed.GetSettings().enabled)
+        change_feed_task_.Start(
+            "game-change-feed",
+            userver::utils::PeriodicTask::Settings{
+                change_feed.GetSettings().poll_period,
+                userver::utils::PeriodicTask::Flags::kNow },
+            [this] { service_.GetChangeFeed().Poll(pg_manager_); });
+
+    catalog_sync_task_.Start(
+        "catalog-sync",
+        userver::utils::PeriodicTask::Settings{
+            service_.GetCatalogSync().GetSettings().period,
+            userver::utils::PeriodicTask::Flags::kNow },
+        [this] { service_.GetCatalogSync().Run(pg_manager_); });
+
+    auto& views = service_.GetViewCounters();
+    if (views.GetSettings().enabled)
+        views_task_.Start(
+            "view-counters",
+            userver::utils::PeriodicTask::Settings{
+                views.GetSettings().flush_period },
+            [this] {
+                service_.GetTrending().AccountViews(
+                    service_.GetViewCounters().Flush(pg_manager_));
+            });
+}
+
+game_service::GameServiceComponent::~GameServiceComponent()
+{
+    // Views counted since the last flush are written before the service
+    // goes away
+    views_task_.Stop();
+    if (service_.GetViewCounters().GetSettings().enabled)
+        service_.GetViewCounters().Flush(pg_manager_);
+    catalog_sync_task_.Stop();
+    change_feed_task_.Stop();
+    views_statistics_entry_.Unregister();
+    indexes_statistics_entry_.Unregister();
+    change_feed_statistics_entry_.Unregister();
+    batching_statistics_entry_.Unregister();
+    cache_statistics_entry_.Unregister();
+    statistics_entry_.Unregister();
+}
+
+game_service::ServiceSettings
+game_service::GameServiceComponent::ParseSettings(
+    const userver::components::ComponentConfig& config)
+{
+    ServiceSettings settings;
+
+    const auto kRefresh = config["igdb-refresh"];
+    auto& refresh = settings.refresh;
+    refresh.enabled = kRefresh["enabled"].As<bool>(refresh.enabled);
+    refresh.ttl = kRefresh["ttl"].As<std::chrono::seconds>(refresh.ttl);
+    refresh.max_in_flight =
+        kRefresh["max-in-flight"].As<std::size_t>(refresh.max_in_flight);
+    refresh.burst = kRefresh["burst"].As<std::size_t>(refresh.burst);
+    refresh.token_interval =
+        kRefresh["token-interval"].As<std::chrono::milliseconds>(
+            refresh.token_interval);
+
+    const auto kAdmission = config["admission"];
+    auto& admission = settings.admission;
+    admission.enabled = kAdmission["enabled"].As<bool>(admission.enabled);
+    admission.total_capacity = kAdmission["total-capacity"].As<std::size_t>(
+        admission.total_capacity);
+
+    const auto kSearchCache = config["search-cache"];
+    auto& search_cache = settings.search_cache;
+    search_cache.enabled =
+        kSearchCache["enabled"].As<bool>(search_cache.enabled);
+    search_cache.shards =
+        kSearchCache["shards"].As<std::size_t>(search_cache.shards);
+    search_cache.capacity =
+        kSearchCache["capacity"].As<std::size_t>(search_cache.capacity);
+    search_cache.ttl =
+        kSearchCache["ttl"].As<std::chrono::milliseconds>(search_cache.ttl);
+
+    const auto kNegativeCache = config["negative-cache"];
+    auto& negative_cache = settings.negative_cache;
+    negative_cache.enabled =
+        kNegativeCache["enabled"].As<bool>(negative_cache.enabled);
+    negative_cache.shards =
+        kNegativeCache["shards"].As<std::size_t>(negative_cache.shards);
+    negative_cache.capacity =
+        kNegativeCache["capacity"].As<std::size_t>(negative_cache.capacity);
+    negative_cache.ttl = kNegativeCache["ttl"].As<std::chrono::milliseconds>(
+        negative_cache.ttl);
+
+    const auto kKnownGames = config["known-games-filter"];
+    auto& known_games = settings.known_games;
+    known_games.enabled =
+        kKnownGames["enabled"].As<bool>(known_games.enabled);
+    known_games.expected_items = kKnownGames["expected-items"].As<std::size_t>(
+        known_games.expected_items);
+    known_games.false_positive_rate =
+        kKnownGames["false-positive-rate"].As<double>(
+            known_games.false_positive_rate);
+    known_games.scan_batch =
+        kKnownGames["scan-batch"].As<std::int32_t>(known_games.scan_batch);
+    known_games.rebuild_period =
+        kKnownGames["rebuild-period"].As<std::chrono::seconds>(
+            known_games.rebuild_period);
+
+    const auto kChangeFeed = config["change-feed"];
+    auto& change_feed = settings.change_feed;
+    change_feed.enabled = kChangeFeed["enabled"].As<bool>(change_feed.enabled);
+    change_feed.poll_period =
+        kChangeFeed["poll-period"].As<std::chrono::milliseconds>(
+            change_feed.poll_period);
+    change_feed.settle = kChangeFeed["settle"].As<std::chrono::milliseconds>(
+        change_feed.settle);
+    change_feed.capacity =
+        kChangeFeed["capacity"].As<std::size_t>(change_feed.capacity);
+    change_feed.page_size =
+        kChangeFeed["page-size"].As<std::int32_t>(change_feed.page_size);
+    change_feed.max_watchers =
+        kChangeFeed["max-watchers"].As<std::size_t>(change_feed.max_watchers);
+
+    const auto kSimilarGames = config["similar-games"];
+    auto& similar_games = settings.similar_games;
+    similar_games.enabled =
+        kSimilarGames["enabled"].As<bool>(similar_games.enabled);
+    similar_games.scan_batch =
+        kSimilarGames["scan-batch"].As<std::int32_t>(similar_games.scan_batch);
+    similar_games.rebuild_period =
+        kSimilarGames["rebuild-period"].As<std::chrono::seconds>(
+            similar_games.rebuild_period);
+    similar_games.genre_weight =
+        kSimilarGames["genre-weight"].As<double>(similar_games.genre_weight);
+    similar_games.theme_weight =
+        kSimilarGames["theme-weight"].As<double>(similar_games.theme_weight);
+    similar_games.platform_weight =
+        kSimilarGames["platform-weight"].As<double>(
+            similar_games.platform_weight);
+
+    const auto kFacets = config["facet-index"];
+    auto& facets = settings.facets;
+    facets.enabled = kFacets["enabled"].As<bool>(facets.enabled);
+    facets.scan_batch =
+        kFacets["scan-batch"].As<std::int32_t>(facets.scan_batch);
+    facets.rebuild_period =
+        kFacets["rebuild-period"].As<std::chrono::seconds>(
+            facets.rebuild_period);
+
+    const auto kAutocomplete = config["autocomplete"];
+    auto& autocomplete = settings.autocomplete;
+    autocomplete.enabled =
+        kAutocomplete["enabled"].As<bool>(autocomplete.enabled);
+    autocomplete.scan_batch =
+        kAutocomplete["scan-batch"].As<std::int32_t>(autocomplete.scan_batch);
+    autocomplete.rebuild_period =
+        kAutocomplete["rebuild-period"].As<std::chrono::seconds>(
+            autocomplete.rebuild_period);
+    autocomplete.top_k =
+        kAutocomplete["top-k"].As<std::size_t>(autocomplete.top_k);
+    autocomplete.scan_limit =
+        kAutocomplete["scan-limit"].As<std::size_t>(autocomplete.scan_limit);
+    autocomplete.rating_weight =
+        kAutocomplete["rating-weight"].As<double>(autocomplete.rating_weight);
+    autocomplete.hypes_weight =
+        kAutocomplete["hypes-weight"].As<double>(autocomplete.hypes_weight);
+
+    const auto kSpelling = config["spelling"];
+    auto& spelling = settings.spelling;
+    spelling.enabled = kSpelling["enabled"].As<bool>(spelling.enabled);
+    spelling.scan_batch =
+        kSpelling["scan-batch"].As<std::int32_t>(spelling.scan_batch);
+    spelling.rebuild_period =
+        kSpelling["rebuild-period"].As<std::chrono::seconds>(
+            spelling.rebuild_period);
+    spelling.max_distance =
+        kSpelling["max-distance"].As<std::size_t>(spelling.max_distance);
+    spelling.prefix_length =
+        kSpelling["prefix-length"].As<std::size_t>(spelling.prefix_length);
+    spelling.max_words =
+        kSpelling["max-words"].As<std::size_t>(spelling.max_words);
+
+    const auto kSemantic = config["semantic-search"];
+    auto& semantic = settings.semantic_search;
+    semantic.enabled = kSemantic["enabled"].As<bool>(semantic.enabled);
+    semantic.scan_batch =
+        kSemantic["scan-batch"].As<std::int32_t>(semantic.scan_batch);
+    semantic.rebuild_period =
+        kSemantic["rebuild-period"].As<std::chrono::seconds>(
+            semantic.rebuild_period);
+    semantic.dimension =
+        kSemantic["dimension"].As<std::size_t>(semantic.dimension);
+    semantic.frequency_buckets =
+        kSemantic["frequency-buckets"].As<std::size_t>(
+            semantic.frequency_buckets);
+    semantic.m = kSemantic["m"].As<std::size_t>(semantic.m);
+    semantic.ef_construction =
+        kSemantic["ef-construction"].As<std::size_t>(semantic.ef_construction);
+    semantic.ef_search =
+        kSemantic["ef-search"].As<std::size_t>(semantic.ef_search);
+
+    const auto kTrending = config["trending"];
+    auto& trending = settings.trending;
+    trending.enabled = kTrending["enabled"].As<bool>(trending.enabled);
+    trending.scan_batch =
+        kTrending["scan-batch"].As<std::int32_t>(trending.scan_batch);
+    trending.rebuild_period =
+        kTrending["rebuild-period"].As<std::chrono::seconds>(
+            trending.rebuild_period);
+    trending.fold_period =
+        kTrending["fold-period"].As<std::chrono::milliseconds>(
+            trending.fold_period);
+    trending.half_life =
+        kTrending["half-life"].As<std::chrono::seconds>(trending.half_life);
+    trending.hypes_weight =
+        kTrending["hypes-weight"].As<double>(trending.hypes_weight);
+    trending.igdb_rating_weight =
+        kTrending["igdb-rating-weight"].As<double>(
+            trending.igdb_rating_weight);
+    trending.playhub_rating_weight =
+        kTrending["playhub-rating-weight"].As<double>(
+            trending.playhub_rating_weight);
+    trending.view_weight =
+        kTrending["view-weight"].As<double>(trending.view_weight);
+    trending.rating_change_weight =
+        kTrending["rating-change-weight"].As<double>(
+            trending.rating_change_weight);
+    trending.release_weight =
+        kTrending["release-weight"].As<double>(trending.release_weight);
+
+    const auto kViews = config["views"];
+    auto& views = settings.views;
+    views.enabled = kViews["enabled"].As<bool>(views.enabled);
+    views.flush_period = kViews["flush-period"].As<std::chrono::milliseconds>(
+        views.flush_period);
+    views.flush_batch =
+        kViews["flush-batch"].As<std::size_t>(views.flush_batch);
+    views.shard_capacity =
+        kViews["shard-capacity"].As<std::size_t>(views.shard_capacity);
+    views.max_pending =
+        kViews["max-pending"].As<std::size_t>(views.max_pending);
+
+    const auto kLeaderboards = config["leaderboards"];
+    auto& leaderboards = settings.leaderboards;
+    leaderboards.enabled =
+        kLeaderboards["enabled"].As<bool>(leaderboards.enabled);
+    leaderboards.scan_batch =
+        kLeaderboards["scan-batch"].As<std::int32_t>(leaderboards.scan_batch);
+    leaderboards.rebuild_period =
+        kLeaderboards["rebuild-period"].As<std::chrono::seconds>(
+            leaderboards.rebuild_period);
+    leaderboards.check_period =
+        kLeaderboards["check-period"].As<std::chrono::seconds>(
+            leaderboards.check_period);
+    leaderboards.check_depth = kLeaderboards["check-depth"].As<std::int32_t>(
+        leaderboards.check_depth);
+
+    const auto kCatalogSync = config["catalog-sync"];
+    auto& catalog_sync = settings.catalog_sync;
+    catalog_sync.period = kCatalogSync["period"].As<std::chrono::milliseconds>(
+        catalog_sync.period);
+    catalog_sync.settle = kCatalogSync["settle"].As<std::chrono::milliseconds>(
+        catalog_sync.settle);
+    catalog_sync.scan_batch =
+        kCatalogSync["scan-batch"].As<std::int32_t>(catalog_sync.scan_batch);
+
+    return settings;
+}
+
+pg::BatchSettings game_service::GameServiceComponent::ParseBatchSettings(
+    const userver::components::ComponentConfig& config)
+{
+    const auto kBatching = config["lookup-batching"];
+
+    pg::BatchSettings settings;
+    settings.enabled = kBatching["enabled"].As<bool>(settings.enabled);
+    settings.window = std::chrono::microseconds{
+        kBatching["window-us"].As<std::int64_t>(settings.window.count())
+    };
+    settings.max_batch =
+        kBatching["max-batch"].As<std::size_t>(settings.max_batch);
+
+    return settings;
 }
 
 userver::yaml_config::Schema
@@ -376,6 +2157,335 @@ game_service::GameServiceComponent::GetStaticConfigSchema()
                 game-prefix:
                     type: string
                     description: game prefix
+                igdb-refresh:
+                    type: object
+                    description: background refresh of stale IGDB-sourced rows
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: refresh stale rows on read
+                        ttl:
+                            type: string
+                            description: age of IGDB data that makes a row stale
+                        max-in-flight:
+                            type: integer
+                            description: concurrent refreshes limit
+                        burst:
+                            type: integer
+                            description: token bucket size for refreshes
+                        token-interval:
+                            type: string
+                            description: interval between refresh tokens
+                admission:
+                    type: object
+                    description: per-method adaptive concurrency limits
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: shed calls over the limits
+                        total-capacity:
+                            type: integer
+                            description: in-flight calls to size the limits for
+                search-cache:
+                    type: object
+                    description: cache of SearchGames result ids
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve repeated queries from the cache
+                        shards:
+                            type: integer
+                            description: independently locked parts
+                        capacity:
+                            type: integer
+                            description: cached queries at most
+                        ttl:
+                            type: string
+                            description: lifetime of a cached result
+                negative-cache:
+                    type: object
+                    description: requests IGDB recently had nothing for
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: skip IGDB for known misses
+                        shards:
+                            type: integer
+                            description: independently locked parts
+                        capacity:
+                            type: integer
+                            description: remembered misses at most
+                        ttl:
+                            type: string
+                            description: how long a miss is trusted
+                lookup-batching:
+                    type: object
+                    description: merging of concurrent lookups by id or slug
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: batch GetGame lookups
+                        window-us:
+                            type: integer
+                            description: microseconds a batch waits for keys
+                        max-batch:
+                            type: integer
+                            description: keys per query at most
+                known-games-filter:
+                    type: object
+                    description: Bloom filters of known game ids and slugs
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: answer unknown games without Postgres
+                        expected-items:
+                            type: integer
+                            description: games to size the filters for at least
+                        false-positive-rate:
+                            type: number
+                            description: target false positive rate
+                        scan-batch:
+                            type: integer
+                            description: keys per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                change-feed:
+                    type: object
+                    description: updated_at poller shared by WatchGames calls
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve WatchGames
+                        poll-period:
+                            type: string
+                            description: interval between polls of Postgres
+                        settle:
+                            type: string
+                            description: age of a change before it is read
+                        capacity:
+                            type: integer
+                            description: changes kept in memory at most
+                        page-size:
+                            type: integer
+                            description: changes per query
+                        max-watchers:
+                            type: integer
+                            description: concurrent WatchGames calls at most
+                similar-games:
+                    type: object
+                    description: in-memory feature bitsets for GetSimilarGames
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve GetSimilarGames
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                        genre-weight:
+                            type: number
+                            description: weight of a genre in the score
+                        theme-weight:
+                            type: number
+                            description: weight of a theme in the score
+                        platform-weight:
+                            type: number
+                            description: weight of a platform in the score
+                facet-index:
+                    type: object
+                    description: roaring bitmaps for ListFilteredGames
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve ListFilteredGames
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                autocomplete:
+                    type: object
+                    description: prefix index of names and slugs
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve Autocomplete
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                        top-k:
+                            type: integer
+                            description: suggestions kept per prefix
+                        scan-limit:
+                            type: integer
+                            description: keys of a prefix ranked on the fly
+                        rating-weight:
+                            type: number
+                            description: weight of the rating in the rank
+                        hypes-weight:
+                            type: number
+                            description: weight of log2(1 + hypes) in the rank
+                spelling:
+                    type: object
+                    description: correction of misspelled search queries
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: correct queries that find nothing
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between dictionary rebuilds
+                        max-distance:
+                            type: integer
+                            description: edits corrected in a word at most
+                        prefix-length:
+                            type: integer
+                            description: leading characters of a word indexed
+                        max-words:
+                            type: integer
+                            description: most frequent words kept
+                semantic-search:
+                    type: object
+                    description: ANN index of summaries, genres and themes
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve SemanticSearch
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                        dimension:
+                            type: integer
+                            description: floats per game vector
+                        frequency-buckets:
+                            type: integer
+                            description: buckets of word document frequencies
+                        m:
+                            type: integer
+                            description: graph links per node and layer
+                        ef-construction:
+                            type: integer
+                            description: candidates for the links of a node
+                        ef-search:
+                            type: integer
+                            description: candidates considered by a search
+                trending:
+                    type: object
+                    description: decayed popularity scores of the catalog
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve GetTrendingGames
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                        fold-period:
+                            type: string
+                            description: interval between folds of the decay
+                        half-life:
+                            type: string
+                            description: time for activity to halve its weight
+                        hypes-weight:
+                            type: number
+                            description: weight of log2(1 + hypes)
+                        igdb-rating-weight:
+                            type: number
+                            description: weight of the IGDB rating
+                        playhub-rating-weight:
+                            type: number
+                            description: weight of the PlayHub rating
+                        view-weight:
+                            type: number
+                            description: weight of a view
+                        rating-change-weight:
+                            type: number
+                            description: weight of a rating change
+                        release-weight:
+                            type: number
+                            description: weight of the release
+                views:
+                    type: object
+                    description: game view counts written in batches
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: count the games GetGame returns
+                        flush-period:
+                            type: string
+                            description: interval between writes to Postgres
+                        flush-batch:
+                            type: integer
+                            description: games per UPDATE statement
+                        shard-capacity:
+                            type: integer
+                            description: games a core counts without a lock
+                        max-pending:
+                            type: integer
+                            description: unwritten games kept for a retry
+                leaderboards:
+                    type: object
+                    description: games of every genre ranked by rating
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: serve genres and GetGenreRank
+                        scan-batch:
+                            type: integer
+                            description: games per query while building
+                        rebuild-period:
+                            type: string
+                            description: interval between full rebuilds
+                        check-period:
+                            type: string
+                            description: interval between Postgres checks
+                        check-depth:
+                            type: integer
+                            description: best games of a genre a check reads
+                catalog-sync:
+                    type: object
+                    description: rebuilds and catch-ups of the indexes above
+                    additionalProperties: false
+                    properties:
+                        period:
+                            type: string
+                            description: interval between runs
+                        settle:
+                            type: string
+                            description: age of a change before it is applied
+                        scan-batch:
+                            type: integer
+                            description: changes per catch-up query
                 database:
                     type: object
                     description: Database connection settings
@@ -0,0 +1,52 @@
+// project headers
+#include <handlers/rpc_method.hpp>
+
+namespace game_service {
+
+std::string_view ToString(RpcMethod method)
+{
+    switch (method)
+    {
+    case RpcMethod::kSearchGames:
+        return "SearchGames";
+    case RpcMethod::kGetGame:
+        return "GetGame";
+    case RpcMethod::kGetGamesByGenre:
+        return "GetGamesByGenre";
+    case RpcMethod::kGetTopRatedGames:
+        return "GetTopRatedGames";
+    case RpcMethod::kGetUpcomingGames:
+        return "GetUpcomingGames";
+    case RpcMethod::kListGames:
+        return "ListGames";
+    case RpcMethod::kSetRating:
+        return "SetRating";
+    case RpcMethod::kBatchGetGames:
+        return "BatchGetGames";
+    case RpcMethod::kExportGames:
+        return "ExportGames";
+    case RpcMethod::kWatchGames:
+        return "WatchGames";
+    case RpcMethod::kGetGamesUpdatedSince:
+        return "GetGamesUpdatedSince";
+    case RpcMethod::kGetSimilarGames:
+        return "GetSimilarGames";
+    case RpcMethod::kListFilteredGames:
+        return "ListFilteredGames";
+    case RpcMethod::kGetFacetCounts:
+        return "GetFacetCounts";
+    case RpcMethod::kAutocomplete:
+        return "Autocomplete";
+    case RpcMethod::kSemanticSearch:
+        return "SemanticSearch";
+    case RpcMethod::kGetTrendingGames:
+        return "GetTrendingGames";
+    case RpcMethod::kGetGenreRank:
+        return "GetGenreRank";
+    case RpcMethod::kCount:
+        break;
+    }
+    return "Unknown";
+}
+
+} // namespace game_service
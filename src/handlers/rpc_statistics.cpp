@@ -0,0 +1,137 @@
+// project headers
+#include <handlers/rpc_statistics.hpp>
+
+namespace game_service {
+
+namespace {
+
+constexpr std::array<std::string_view, kStatusCodeCount> kStatusCodeNames{
+    "OK",
+    "CANCELLED",
+    "UNKNOWN",
+    "INVALID_ARGUMENT",
+    "DEADLINE_EXCEEDED",
+    "NOT_FOUND",
+    "ALREADY_EXISTS",
+    "PERMISSION_DENIED",
+    "RESOURCE_EXHAUSTED",
+    "FAILED_PRECONDITION",
+    "ABORTED",
+    "OUT_OF_RANGE",
+    "UNIMPLEMENTED",
+    "INTERNAL",
+    "UNAVAILABLE",
+    "DATA_LOSS",
+    "UNAUTHENTICATED",
+};
+
+} // namespace
+
+std::string_view ToString(ServingPath path)
+{
+    switch (path)
+    {
+    case ServingPath::kCacheHit:
+        return "cache_hit";
+    case ServingPath::kPgHit:
+        return "pg_hit";
+    case ServingPath::kIgdbMiss:
+        return "igdb_miss";
+    case ServingPath::kFallback:
+        return "fallback";
+    case ServingPath::kEmpty:
+        return "empty";
+    case ServingPath::kNotModified:
+        return "not_modified";
+    case ServingPath::kIndexHit:
+        return "index_hit";
+    case ServingPath::kCorrected:
+        return "corrected";
+    case ServingPath::kError:
+        return "error";
+    case ServingPath::kCount:
+        break;
+    }
+    return "unknown";
+}
+
+MethodStatistics& RpcStatistics::ForMethod(RpcMethod method)
+{
+    return methods_[ToIndex(method)];
+}
+
+const MethodStatistics& RpcStatistics::ForMethod(RpcMethod method) const
+{
+    return methods_[ToIndex(method)];
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const MethodStatistics& stats)
+{
+    for (std::size_t i = 0; i < kServingPathCount; ++i)
+        writer["latency"].ValueWithLabels(
+            stats.latency[i],
+            { { "path", ToString(static_cast<ServingPath>(i)) } });
+
+    writer["result-size"] = stats.result_size;
+
+    for (std::size_t i = 0; i < kStatusCodeCount; ++i)
+    {
+        if (stats.status[i].Load().value == 0)
+            continue;
+
+        writer["status"].ValueWithLabels(
+            stats.status[i], { { "code", kStatusCodeNames[i] } });
+    }
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const RpcStatistics& stats)
+{
+    for (std::size_t i = 0; i < kRpcMethodCount; ++i)
+    {
+        const auto kMethod = static_cast<RpcMethod>(i);
+        writer.ValueWithLabels(stats.ForMethod(kMethod),
+                               { { "method", ToString(kMethod) } });
+    }
+}
+
+CallRecorder::CallRecorder(RpcStatistics& stats, RpcMethod method)
+    : stats_(stats.ForMethod(method)), start_(std::chrono::steady_clock::now())
+{}
+
+CallRecorder::~CallRecorder()
+{
+    stats_.latency[static_cast<std::size_t>(path_)].Account(
+        std::chrono::steady_clock::now() - start_);
+}
+
+void CallRecorder::SetPath(ServingPath path)
+{
+    path_ = path;
+}
+
+void CallRecorder::SetResultSize(std::size_t size)
+{
+    stats_.result_size.Account(size);
+}
+
+grpc::Status CallRecorder::Finish(grpc::Status status)
+{
+    AccountStatus(status.error_code());
+    return status;
+}
+
+void CallRecorder::AccountStatus(grpc::StatusCode code)
+{
+    // Failures are usually fast and would pass for healthy calls of the
+    // path they failed on
+    if (code != grpc::StatusCode::OK)
+        path_ = ServingPath::kError;
+
+    const auto kIndex = static_cast<std::size_t>(code);
+    if (kIndex < kStatusCodeCount)
+        ++stats_.status[kIndex];
+}
+
+} // namespace game_service
@@ -0,0 +1,435 @@
+// project headers
+#include <indexes/autocomplete.hpp>
+#include <tools/utils.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+namespace {
+
+bool StartsWith(std::string_view key, std::string_view prefix)
+{
+    return key.substr(0, prefix.size()) == prefix;
+}
+
+} // namespace
+
+std::size_t AutocompleteIndex::Keys::Size() const
+{
+    return rows.size();
+}
+
+std::string_view AutocompleteIndex::Keys::Get(std::size_t key) const
+{
+    return std::string_view{ buffer }.substr(
+        offsets[key], offsets[key + 1] - offsets[key]);
+}
+
+AutocompleteIndex::AutocompleteIndex(AutocompleteSettings settings)
+    : settings_(settings)
+{}
+
+std::optional<std::vector<Suggestion>>
+AutocompleteIndex::Suggest(std::string_view prefix, std::size_t limit) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+    const auto kPrefix = utils::NormalizeQuery(prefix);
+    const auto kLimit = std::min(limit, settings_.top_k);
+
+    std::vector<Suggestion> suggestions;
+    {
+        std::shared_lock lock(mutex_);
+
+        if (!ready_)
+            return std::nullopt;
+
+        // Keys starting with the prefix follow each other
+        std::size_t begin = 0;
+        std::size_t end = keys_.Size();
+        while (begin < end)
+        {
+            const auto kMiddle = begin + (end - begin) / 2;
+            if (keys_.Get(kMiddle) < kPrefix)
+                begin = kMiddle + 1;
+            else
+                end = kMiddle;
+        }
+        end = keys_.Size();
+        for (auto low = begin; low < end;)
+        {
+            const auto kMiddle = low + (end - low) / 2;
+            if (StartsWith(keys_.Get(kMiddle), kPrefix))
+                low = kMiddle + 1;
+            else
+                end = kMiddle;
+        }
+
+        std::vector<std::uint32_t> rows;
+        const auto& kTops = keys_.tops;
+        const auto kPrecomputed = end - begin > settings_.scan_limit
+                                      ? kTops.prefixes.find(kPrefix)
+                                      : kTops.prefixes.end();
+        if (kPrecomputed != kTops.prefixes.end())
+        {
+            const auto kTop = kTops.rows.begin() + kPrecomputed->second;
+            for (auto row = kTop; row != kTop + kLimit && *row != kNoRow;
+                 ++row)
+                rows.push_back(*row);
+        }
+        else
+            rows = Best(games_.ranks, keys_, begin, end, kLimit);
+
+        suggestions.reserve(rows.size());
+        for (const auto kRow : rows)
+        {
+            const auto& kGame = games_.rows[kRow];
+            suggestions.push_back(Suggestion{ kGame.id, kGame.name,
+                                              kGame.slug });
+        }
+    }
+
+    stats_.suggesting.Account(std::chrono::steady_clock::now() - kStarted);
+    return suggestions;
+}
+
+void AutocompleteIndex::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!ready_)
+        return;
+
+    MarkChanged(Set(games_, ToFeatures(game)));
+    stats_.games = static_cast<std::int64_t>(games_.rows.size());
+}
+
+bool AutocompleteIndex::Rebuild(const pg::IGameRepository& repository)
+{
+    Games games;
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [this, &games](const std::vector<entities::GameFeatures>& rows) {
+            for (const auto& game : rows)
+                Set(games, game);
+        });
+    if (!kScanned)
+        return false;
+
+    auto keys = Compact(games);
+    const auto kGames = games.rows.size();
+    const auto kKeys = keys.Size();
+    const auto kPrefixes = keys.tops.prefixes.size();
+    {
+        std::lock_guard lock(mutex_);
+        games_ = std::move(games);
+        keys_ = std::move(keys);
+        renamed_ = false;
+        reranked_ = false;
+        ready_ = true;
+    }
+    stats_.games = static_cast<std::int64_t>(kGames);
+    stats_.keys = static_cast<std::int64_t>(kKeys);
+    stats_.precomputed_prefixes = static_cast<std::int64_t>(kPrefixes);
+
+    LOG_INFO() << "Autocomplete index is rebuilt with " << kGames
+               << " games, " << kKeys << " keys";
+    return true;
+}
+
+void AutocompleteIndex::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    for (const auto& change : changes)
+        MarkChanged(Set(games_, ToFeatures(change.game)));
+    stats_.games = static_cast<std::int64_t>(games_.rows.size());
+}
+
+void AutocompleteIndex::Maintain(const pg::IGameRepository&,
+                                 const entities::ChangeCursor&)
+{
+    CompactIfChanged();
+}
+
+bool AutocompleteIndex::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return ready_;
+}
+
+const AutocompleteSettings& AutocompleteIndex::GetSettings() const
+{
+    return settings_;
+}
+
+const AutocompleteStatistics& AutocompleteIndex::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t AutocompleteIndex::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+
+    std::size_t bytes = games_.rows.capacity() * sizeof(Game) +
+                        games_.ranks.capacity() * sizeof(double) +
+                        keys_.buffer.capacity() +
+                        keys_.offsets.capacity() * sizeof(std::uint32_t) +
+                        keys_.rows.capacity() * sizeof(std::uint32_t) +
+                        keys_.tops.rows.capacity() * sizeof(std::uint32_t);
+    for (const auto& game : games_.rows)
+        bytes += game.name.capacity() + game.slug.capacity();
+    for (const auto& [prefix, offset] : keys_.tops.prefixes)
+        bytes += sizeof(prefix) + prefix.capacity() + sizeof(offset);
+
+    return bytes;
+}
+
+double AutocompleteIndex::Rank(std::int32_t playhub_rating,
+                               std::int32_t hypes) const
+{
+    return settings_.rating_weight * playhub_rating +
+           settings_.hypes_weight * std::log2(1.0 + std::max(hypes, 0));
+}
+
+// Ranks take effect at once for prefixes that are scanned and at the next
+// compaction for precomputed ones
+AutocompleteIndex::Change
+AutocompleteIndex::Set(Games& games, const entities::GameFeatures& game) const
+{
+    const auto [kPosition, kInserted] = games.positions.emplace(
+        game.id, static_cast<std::uint32_t>(games.rows.size()));
+    if (kInserted)
+    {
+        games.rows.push_back(Game{ game.id, {}, {} });
+        games.ranks.push_back(0.0);
+    }
+
+    auto& rank = games.ranks[kPosition->second];
+    const auto kRank = Rank(game.playhub_rating, game.hypes);
+    const auto kReranked = rank != kRank;
+    rank = kRank;
+
+    auto& row = games.rows[kPosition->second];
+    if (!kInserted && row.name == game.name && row.slug == game.slug)
+        return kReranked ? Change::kRanked : Change::kNone;
+
+    row.name = game.name;
+    row.slug = game.slug;
+    return Change::kRenamed;
+}
+
+void AutocompleteIndex::MarkChanged(Change change)
+{
+    switch (change)
+    {
+    case Change::kNone:
+        break;
+    case Change::kRanked:
+        reranked_ = true;
+        break;
+    case Change::kRenamed:
+        renamed_ = true;
+        break;
+    }
+}
+
+AutocompleteIndex::Keys AutocompleteIndex::Compact(const Games& games) const
+{
+    std::vector<std::pair<std::string, std::uint32_t>> entries;
+    entries.reserve(games.rows.size() * 2);
+
+    for (std::uint32_t row = 0; row < games.rows.size(); ++row)
+    {
+        auto name = utils::NormalizeQuery(games.rows[row].name);
+        auto slug = utils::NormalizeQuery(games.rows[row].slug);
+
+        // Slugs are mostly the name with dashes
+        if (!slug.empty() && slug != name)
+            entries.emplace_back(std::move(slug), row);
+        if (!name.empty())
+            entries.emplace_back(std::move(name), row);
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    Keys keys;
+    keys.offsets.reserve(entries.size() + 1);
+    keys.rows.reserve(entries.size());
+    keys.offsets.push_back(0);
+    for (const auto& [key, row] : entries)
+    {
+        keys.buffer += key;
+        keys.offsets.push_back(static_cast<std::uint32_t>(keys.buffer.size()));
+        keys.rows.push_back(row);
+    }
+
+    keys.tops = Precompute(games.ranks, keys);
+    return keys;
+}
+
+AutocompleteIndex::Tops
+AutocompleteIndex::Precompute(const std::vector<double>& ranks,
+                              const Keys& keys) const
+{
+    Tops tops;
+    Precompute(ranks, keys, 0, keys.Size(), 0, tops);
+    return tops;
+}
+
+// Every prefix of more than `scan_limit` keys is a range of a parent of
+// more than `scan_limit` keys too, so walking the heavy ranges one
+// character deeper at a time reaches all of them
+void AutocompleteIndex::Precompute(const std::vector<double>& ranks,
+                                   const Keys& keys, std::size_t begin,
+                                   std::size_t end, std::size_t depth,
+                                   Tops& tops) const
+{
+    if (end - begin <= settings_.scan_limit)
+        return;
+
+    auto best = Best(ranks, keys, begin, end, settings_.top_k);
+    best.resize(settings_.top_k, kNoRow);
+
+    tops.prefixes.emplace(std::string{ keys.Get(begin).substr(0, depth) },
+                          static_cast<std::uint32_t>(tops.rows.size()));
+    tops.rows.insert(tops.rows.end(), best.begin(), best.end());
+
+    // Keys that are the prefix itself come first
+    auto first = begin;
+    while (first < end && keys.Get(first).size() == depth)
+        ++first;
+
+    while (first < end)
+    {
+        const auto kChar = keys.Get(first)[depth];
+        auto last = first;
+        while (last < end && keys.Get(last)[depth] == kChar)
+            ++last;
+
+        Precompute(ranks, keys, first, last, depth + 1, tops);
+        first = last;
+    }
+}
+
+std::vector<std::uint32_t>
+AutocompleteIndex::Best(const std::vector<double>& ranks, const Keys& keys,
+                        std::size_t begin, std::size_t end, std::size_t limit)
+{
+    std::vector<std::uint32_t> best;
+    if (limit == 0)
+        return best;
+
+    // Min-heap of the best rows so far, ties go to the earlier row
+    const auto kBetter = [&ranks](std::uint32_t lhs, std::uint32_t rhs) {
+        const auto kLhs = ranks[lhs];
+        const auto kRhs = ranks[rhs];
+        return kLhs != kRhs ? kLhs > kRhs : lhs < rhs;
+    };
+    best.reserve(limit + 1);
+
+    for (auto key = begin; key < end; ++key)
+    {
+        const auto kRow = keys.rows[key];
+        if (best.size() == limit && !kBetter(kRow, best.front()))
+            continue;
+        // Both the name and the slug of a game may match
+        if (std::find(best.begin(), best.end(), kRow) != best.end())
+            continue;
+
+        best.push_back(kRow);
+        std::push_heap(best.begin(), best.end(), kBetter);
+        if (best.size() > limit)
+        {
+            std::pop_heap(best.begin(), best.end(), kBetter);
+            best.pop_back();
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end(), kBetter);
+    return best;
+}
+
+// Compacts a copy of the game table taken under the shared lock, so that
+// sorting and ranking the catalog doesn't hold up upserts and, behind them,
+// suggestions. Rows are never taken out of the table, so the keys stay
+// valid for upserts that land before they are swapped in; those set the
+// flags again and are compacted by the next run. Only the sync task
+// replaces the keys, so it reads them without the lock
+void AutocompleteIndex::CompactIfChanged()
+{
+    bool renamed = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (!ready_ || (!renamed_ && !reranked_))
+            return;
+        renamed = renamed_;
+        renamed_ = false;
+        reranked_ = false;
+    }
+
+    Games games;
+    {
+        std::shared_lock lock(mutex_);
+        if (renamed)
+            games.rows = games_.rows;
+        games.ranks = games_.ranks;
+    }
+
+    if (renamed)
+    {
+        auto keys = Compact(games);
+        stats_.keys = static_cast<std::int64_t>(keys.Size());
+        stats_.precomputed_prefixes =
+            static_cast<std::int64_t>(keys.tops.prefixes.size());
+
+        std::lock_guard lock(mutex_);
+        keys_ = std::move(keys);
+    }
+    else
+    {
+        auto tops = Precompute(games.ranks, keys_);
+        stats_.precomputed_prefixes =
+            static_cast<std::int64_t>(tops.prefixes.size());
+
+        std::lock_guard lock(mutex_);
+        keys_.tops = std::move(tops);
+    }
+
+    ++stats_.compactions;
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const AutocompleteIndex& index)
+{
+    const auto& stats = index.GetStatistics();
+
+    writer["ready"] = index.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["keys"] = stats.keys.load();
+    writer["precomputed-prefixes"] = stats.precomputed_prefixes.load();
+    writer["memory-bytes"] = index.GetMemoryBytes();
+
+    writer["suggesting"] = stats.suggesting;
+    writer["compactions"] = stats.compactions;
+}
+
+} // namespace indexes
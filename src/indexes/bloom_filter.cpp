@@ -0,0 +1,135 @@
+// project headers
+#include <indexes/bloom_filter.hpp>
+
+// std
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <functional>
+
+namespace indexes {
+
+namespace {
+
+constexpr std::size_t kWordBits = 64;
+constexpr std::size_t kMaxHashCount = 16;
+
+// splitmix64 finalizer, spreads std::hash output over all bits
+std::uint64_t Mix(std::uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+std::size_t GetOptimalBitCount(std::size_t items, double rate)
+{
+    const double kLn2 = std::log(2.0);
+    const double kBits =
+        std::ceil(-static_cast<double>(items) * std::log(rate) /
+                  (kLn2 * kLn2));
+
+    const auto kWords =
+        (static_cast<std::size_t>(kBits) + kWordBits - 1) / kWordBits;
+    return std::max<std::size_t>(kWords, 1) * kWordBits;
+}
+
+std::size_t GetOptimalHashCount(std::size_t bits, std::size_t items)
+{
+    const auto kHashes = std::lround(static_cast<double>(bits) /
+                                     static_cast<double>(items) *
+                                     std::log(2.0));
+    return std::clamp<std::size_t>(static_cast<std::size_t>(kHashes), 1,
+                                   kMaxHashCount);
+}
+
+} // namespace
+
+BloomFilter::BloomFilter(std::size_t expected_items,
+                         double false_positive_rate)
+    : bit_count_(GetOptimalBitCount(
+          std::max<std::size_t>(expected_items, 1),
+          std::clamp(false_positive_rate, 1e-9, 0.5))),
+      hash_count_(GetOptimalHashCount(
+          bit_count_, std::max<std::size_t>(expected_items, 1))),
+      word_count_(bit_count_ / kWordBits),
+      words_(std::make_unique<std::atomic<std::uint64_t>[]>(word_count_))
+{}
+
+void BloomFilter::Add(std::string_view key)
+{
+    const auto kProbe = MakeProbe(key);
+
+    for (std::size_t i = 0; i < hash_count_; ++i)
+    {
+        const auto kBit = GetBit(kProbe, i);
+        words_[kBit / kWordBits].fetch_or(std::uint64_t{ 1 }
+                                              << (kBit % kWordBits),
+                                          std::memory_order_relaxed);
+    }
+}
+
+bool BloomFilter::MayContain(std::string_view key) const
+{
+    const auto kProbe = MakeProbe(key);
+
+    for (std::size_t i = 0; i < hash_count_; ++i)
+    {
+        const auto kBit = GetBit(kProbe, i);
+        const auto kWord =
+            words_[kBit / kWordBits].load(std::memory_order_relaxed);
+        if (!(kWord & (std::uint64_t{ 1 } << (kBit % kWordBits))))
+            return false;
+    }
+
+    return true;
+}
+
+std::size_t BloomFilter::GetBitCount() const
+{
+    return bit_count_;
+}
+
+std::size_t BloomFilter::GetHashCount() const
+{
+    return hash_count_;
+}
+
+std::size_t BloomFilter::GetMemoryBytes() const
+{
+    return word_count_ * sizeof(std::uint64_t) + sizeof(*this);
+}
+
+double BloomFilter::EstimateFalsePositiveRate() const
+{
+    std::size_t set_bits = 0;
+    for (std::size_t i = 0; i < word_count_; ++i)
+    {
+        const std::bitset<kWordBits> kWord(
+            words_[i].load(std::memory_order_relaxed));
+        set_bits += kWord.count();
+    }
+
+    const double kFill =
+        static_cast<double>(set_bits) / static_cast<double>(bit_count_);
+    return std::pow(kFill, static_cast<double>(hash_count_));
+}
+
+// Double hashing: the i-th bit is first + i * step, which is as good as
+// independent hashes for a Bloom filter
+BloomFilter::Probe BloomFilter::MakeProbe(std::string_view key)
+{
+    const std::uint64_t kHash = std::hash<std::string_view>{}(key);
+    return Probe{ Mix(kHash), Mix(kHash ^ 0x9e3779b97f4a7c15ULL) | 1 };
+}
+
+std::size_t BloomFilter::GetBit(const Probe& probe, std::size_t i) const
+{
+    return static_cast<std::size_t>((probe.first + i * probe.step) %
+                                    bit_count_);
+}
+
+} // namespace indexes
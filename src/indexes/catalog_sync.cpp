@@ -0,0 +1,232 @@
+// project headers
+#include <indexes/catalog_sync.hpp>
+
+// std
+#include <algorithm>
+#include <mutex>
+
+// boost
+#include <boost/uuid/uuid_io.hpp>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+bool ICatalogIndex::IsRebuildRequested() const
+{
+    return false;
+}
+
+void ICatalogIndex::Maintain(const pg::IGameRepository&,
+                             const entities::ChangeCursor&)
+{}
+
+entities::GameFeatures ToFeatures(const entities::GamePostgres& game)
+{
+    return entities::GameFeatures{ game.id,
+                                   game.genres,
+                                   game.themes,
+                                   game.platforms,
+                                   game.firstReleaseDate,
+                                   game.playhub_rating,
+                                   game.name,
+                                   game.slug,
+                                   game.hypes,
+                                   game.igdb_rating };
+}
+
+std::string GetScanKey(const entities::GameKey& key)
+{
+    return key.id;
+}
+
+std::string GetScanKey(const entities::GameFeatures& game)
+{
+    return boost::uuids::to_string(game.id);
+}
+
+std::string GetScanKey(const entities::GamePostgres& game)
+{
+    return boost::uuids::to_string(game.id);
+}
+
+CatalogSync::Entry::Entry(std::string name, ICatalogIndex& index,
+                          std::chrono::seconds rebuild_period)
+    : name(std::move(name)), index(index), rebuild_period(rebuild_period)
+{}
+
+CatalogSync::CatalogSync(CatalogSyncSettings settings,
+                         feed::ChangeFeed& feed)
+    : settings_(settings), feed_(feed)
+{
+    feed.Listen([this](const std::vector<feed::Change>& changes) {
+        Apply(changes);
+    });
+}
+
+void CatalogSync::Add(std::string name, ICatalogIndex& index,
+                      std::chrono::seconds rebuild_period)
+{
+    entries_.push_back(
+        std::make_unique<Entry>(std::move(name), index, rebuild_period));
+}
+
+void CatalogSync::Run(const pg::IGameRepository& repository)
+{
+    // Changes made before the first poll of the feed would reach no index
+    const auto kFollowsFeed = feed_.GetSettings().enabled;
+    if (kFollowsFeed && !feed_.GetHead())
+        return;
+
+    for (auto& entry : entries_)
+    {
+        const auto kNow = std::chrono::steady_clock::now();
+        if (!entry->built || entry->index.IsRebuildRequested() ||
+            kNow - entry->last_rebuild >= entry->rebuild_period)
+            Rebuild(repository, *entry);
+        else if (!kFollowsFeed && !entry->catch_up)
+            entry->catch_up = entry->applied;
+
+        if (entry->catch_up)
+            CatchUp(repository, *entry);
+
+        if (!entry->built || entry->catch_up)
+            continue;
+
+        std::optional<entities::ChangeCursor> applied;
+        {
+            std::lock_guard lock(entry->mutex);
+            applied = entry->applied;
+        }
+        if (applied)
+            entry->index.Maintain(repository, *applied);
+    }
+}
+
+const CatalogSyncSettings& CatalogSync::GetSettings() const
+{
+    return settings_;
+}
+
+std::vector<std::pair<std::string, const CatalogIndexStatistics*>>
+CatalogSync::GetStatistics() const
+{
+    std::vector<std::pair<std::string, const CatalogIndexStatistics*>> stats;
+    stats.reserve(entries_.size());
+    for (const auto& entry : entries_)
+        stats.emplace_back(entry->name, &entry->stats);
+    return stats;
+}
+
+// Changes up to the latest one applied are skipped: they came in a page
+// polled before a catch-up page that already brought their games as they
+// are now
+void CatalogSync::Apply(const std::vector<feed::Change>& changes)
+{
+    if (changes.empty())
+        return;
+
+    for (auto& entry : entries_)
+    {
+        std::lock_guard lock(entry->mutex);
+
+        auto first = changes.begin();
+        if (entry->applied)
+            first = std::upper_bound(
+                changes.begin(), changes.end(), *entry->applied,
+                [](const entities::ChangeCursor& cursor,
+                   const feed::Change& change) {
+                    return feed::IsBefore(cursor, change.cursor);
+                });
+        if (first == changes.end())
+            continue;
+
+        if (first == changes.begin())
+            entry->index.Apply(changes);
+        else
+            entry->index.Apply(std::vector<feed::Change>(first, changes.end()));
+        entry->applied = changes.back().cursor;
+    }
+}
+
+void CatalogSync::Rebuild(const pg::IGameRepository& repository,
+                          Entry& entry)
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    // Changes made while scanning, or not yet settled, are applied by the
+    // catch-up that follows
+    const auto kCursor = repository.GetLatestChangeCursor(settings_.settle);
+    if (!kCursor || !entry.index.Rebuild(repository))
+    {
+        LOG_WARNING() << "Rebuild of the " << entry.name
+                      << " index failed, keeping the previous one";
+        ++entry.stats.rebuild_failures;
+        return;
+    }
+
+    {
+        std::lock_guard lock(entry.mutex);
+        if (!entry.applied || feed::IsBefore(*entry.applied, *kCursor))
+            entry.applied = *kCursor;
+    }
+    entry.catch_up = *kCursor;
+    entry.built = true;
+    entry.last_rebuild = kStarted;
+    ++entry.stats.rebuilds;
+}
+
+// A page is read and applied under the lock, so that the feed can't slip
+// an older state of its games in between
+void CatalogSync::CatchUp(const pg::IGameRepository& repository,
+                          Entry& entry)
+{
+    while (true)
+    {
+        std::lock_guard lock(entry.mutex);
+
+        auto games = repository.ScanChanges(
+            *entry.catch_up, settings_.settle, settings_.scan_batch);
+        if (!games)
+        {
+            // The next run continues from the same cursor
+            ++entry.stats.catch_up_failures;
+            return;
+        }
+
+        const auto kCount = games->size();
+        if (kCount != 0)
+        {
+            const auto kChanges = feed::MakeChanges(std::move(*games));
+            entry.index.Apply(kChanges);
+
+            entry.catch_up = kChanges.back().cursor;
+            if (feed::IsBefore(*entry.applied, *entry.catch_up))
+                entry.applied = entry.catch_up;
+        }
+
+        if (kCount < static_cast<std::size_t>(settings_.scan_batch))
+        {
+            entry.catch_up.reset();
+            return;
+        }
+    }
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CatalogIndexStatistics& stats)
+{
+    writer["rebuilds"] = stats.rebuilds;
+    writer["rebuild-failures"] = stats.rebuild_failures;
+    writer["catch-up-failures"] = stats.catch_up_failures;
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const CatalogSync& sync)
+{
+    for (const auto& [name, stats] : sync.GetStatistics())
+        writer.ValueWithLabels(*stats, { { "index", name } });
+}
+
+} // namespace indexes
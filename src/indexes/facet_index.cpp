@@ -0,0 +1,357 @@
+// project headers
+#include <indexes/facet_index.hpp>
+
+// std
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+namespace {
+
+// "YYYY-MM-DD" as YYYYMMDD, 0 for "N/A" and anything else
+std::int32_t ParseReleaseDate(std::string_view date)
+{
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-')
+        return 0;
+
+    std::int32_t value = 0;
+    for (const char kChar : date)
+    {
+        if (kChar == '-')
+            continue;
+        if (!std::isdigit(static_cast<unsigned char>(kChar)))
+            return 0;
+        value = value * 10 + (kChar - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+FacetIndex::FacetIndex(FacetSettings settings) : settings_(settings) {}
+
+std::optional<FacetPage> FacetIndex::Filter(const FacetFilter& filter,
+                                            ::games::SortingType order,
+                                            std::size_t limit,
+                                            std::size_t offset) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+    const auto kValues = ToValues(filter);
+
+    FacetPage page;
+    {
+        std::shared_lock lock(mutex_);
+
+        if (!ready_)
+            return std::nullopt;
+
+        const auto kMatches = Match(index_, kValues, std::nullopt);
+        auto positions =
+            kMatches ? kMatches->ToVector() : index_.all.ToVector();
+        page.total = positions.size();
+
+        const auto& kRows = index_.rows;
+        const auto kSortKey = [&kRows, order](std::uint32_t position) {
+            const auto& kRow = kRows[position];
+            return order == ::games::SortingType::FIRST_RELEASE_DATE
+                       ? kRow.release_date
+                       : kRow.playhub_rating;
+        };
+
+        const auto kBegin = std::min(offset, positions.size());
+        const auto kEnd = std::min(offset + limit, positions.size());
+        std::partial_sort(positions.begin(), positions.begin() + kEnd,
+                          positions.end(),
+                          [&kSortKey](std::uint32_t lhs, std::uint32_t rhs) {
+                              const auto kLhs = kSortKey(lhs);
+                              const auto kRhs = kSortKey(rhs);
+                              return kLhs != kRhs ? kLhs > kRhs : lhs < rhs;
+                          });
+
+        page.ids.reserve(kEnd - kBegin);
+        for (auto i = kBegin; i < kEnd; ++i)
+            page.ids.push_back(kRows[positions[i]].id);
+    }
+
+    stats_.filtering.Account(std::chrono::steady_clock::now() - kStarted);
+    stats_.matches.Account(page.total);
+    return page;
+}
+
+std::optional<FacetCounts> FacetIndex::Count(const FacetFilter& filter) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+    const auto kValues = ToValues(filter);
+
+    FacetCounts counts;
+    {
+        std::shared_lock lock(mutex_);
+
+        if (!ready_)
+            return std::nullopt;
+
+        const auto kMatches = Match(index_, kValues, std::nullopt);
+        counts.total = kMatches ? kMatches->GetCardinality()
+                                : index_.all.GetCardinality();
+
+        const auto kCountFacet = [this, &kValues](
+                                     Facet facet,
+                                     std::vector<FacetValueCount>& result) {
+            const auto kOthers = Match(index_, kValues, facet);
+
+            for (const auto& [value, id] :
+                 index_.values[static_cast<std::size_t>(facet)])
+            {
+                const auto& kBitmap = index_.bitmaps[id];
+                const auto kCount =
+                    kOthers ? GetIntersectionCardinality(kBitmap, *kOthers)
+                            : kBitmap.GetCardinality();
+                if (kCount != 0)
+                    result.push_back(FacetValueCount{ value, kCount });
+            }
+
+            std::sort(result.begin(), result.end(),
+                      [](const FacetValueCount& lhs,
+                         const FacetValueCount& rhs) {
+                          return lhs.count != rhs.count
+                                     ? lhs.count > rhs.count
+                                     : lhs.value < rhs.value;
+                      });
+        };
+
+        kCountFacet(Facet::kGenre, counts.genres);
+        kCountFacet(Facet::kTheme, counts.themes);
+        kCountFacet(Facet::kPlatform, counts.platforms);
+        kCountFacet(Facet::kReleaseYear, counts.release_years);
+    }
+
+    stats_.counting.Account(std::chrono::steady_clock::now() - kStarted);
+    return counts;
+}
+
+void FacetIndex::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!ready_)
+        return;
+
+    Set(index_, ToFeatures(game));
+    stats_.games = static_cast<std::int64_t>(index_.rows.size());
+}
+
+bool FacetIndex::Rebuild(const pg::IGameRepository& repository)
+{
+    Index index;
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [&index](const std::vector<entities::GameFeatures>& games) {
+            for (const auto& game : games)
+                Set(index, game);
+        });
+    if (!kScanned)
+        return false;
+
+    const auto kGames = index.rows.size();
+    {
+        std::lock_guard lock(mutex_);
+        index_ = std::move(index);
+        ready_ = true;
+    }
+    stats_.games = static_cast<std::int64_t>(kGames);
+
+    LOG_INFO() << "Facet index is rebuilt with " << kGames << " games";
+    return true;
+}
+
+void FacetIndex::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    for (const auto& change : changes)
+        Set(index_, ToFeatures(change.game));
+    stats_.games = static_cast<std::int64_t>(index_.rows.size());
+}
+
+bool FacetIndex::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return ready_;
+}
+
+const FacetSettings& FacetIndex::GetSettings() const
+{
+    return settings_;
+}
+
+const FacetStatistics& FacetIndex::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t FacetIndex::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+
+    std::size_t bytes = index_.rows.capacity() * sizeof(Row) +
+                        index_.all.GetMemoryBytes();
+    for (const auto& row : index_.rows)
+        bytes += row.values.capacity() * sizeof(std::uint32_t);
+    for (const auto& bitmap : index_.bitmaps)
+        bytes += bitmap.GetMemoryBytes();
+
+    return bytes;
+}
+
+std::optional<std::uint64_t> FacetIndex::GetGameCount() const
+{
+    std::shared_lock lock(mutex_);
+    if (!ready_)
+        return std::nullopt;
+    return index_.all.GetCardinality();
+}
+
+std::size_t FacetIndex::GetValueCount() const
+{
+    std::shared_lock lock(mutex_);
+    return index_.bitmaps.size();
+}
+
+void FacetIndex::Set(Index& index, const entities::GameFeatures& game)
+{
+    const auto [kPosition, kInserted] = index.positions.emplace(
+        game.id, static_cast<std::uint32_t>(index.rows.size()));
+    const auto kRow = kPosition->second;
+
+    if (kInserted)
+    {
+        index.rows.push_back(Row{});
+        index.rows.back().id = game.id;
+        index.all.Add(kRow);
+    }
+
+    auto& row = index.rows[kRow];
+    for (const auto kValue : row.values)
+        index.bitmaps[kValue].Remove(kRow);
+    row.values.clear();
+
+    row.playhub_rating = game.playhub_rating;
+    row.release_date = ParseReleaseDate(game.firstReleaseDate);
+
+    AddValues(index, row, kRow, Facet::kGenre, game.genres);
+    AddValues(index, row, kRow, Facet::kTheme, game.themes);
+    AddValues(index, row, kRow, Facet::kPlatform, game.platforms);
+    if (row.release_date != 0)
+        AddValues(index, row, kRow, Facet::kReleaseYear,
+                  { std::to_string(row.release_date / 10000) });
+}
+
+void FacetIndex::AddValues(Index& index, Row& row, std::uint32_t position,
+                           Facet facet,
+                           const std::vector<std::string>& values)
+{
+    auto& ids = index.values[static_cast<std::size_t>(facet)];
+
+    for (const auto& value : values)
+    {
+        const auto [kFound, kInserted] = ids.emplace(
+            value, static_cast<std::uint32_t>(index.bitmaps.size()));
+        if (kInserted)
+            index.bitmaps.emplace_back();
+
+        index.bitmaps[kFound->second].Add(position);
+        row.values.push_back(kFound->second);
+    }
+}
+
+FacetIndex::FacetValues FacetIndex::ToValues(const FacetFilter& filter)
+{
+    FacetValues values;
+    values[static_cast<std::size_t>(Facet::kGenre)] = filter.genres;
+    values[static_cast<std::size_t>(Facet::kTheme)] = filter.themes;
+    values[static_cast<std::size_t>(Facet::kPlatform)] = filter.platforms;
+
+    auto& years = values[static_cast<std::size_t>(Facet::kReleaseYear)];
+    years.reserve(filter.release_years.size());
+    for (const auto kYear : filter.release_years)
+        years.push_back(std::to_string(kYear));
+
+    return values;
+}
+
+std::optional<RoaringBitmap>
+FacetIndex::MatchAny(const Index& index, Facet facet,
+                     const std::vector<std::string>& values)
+{
+    if (values.empty())
+        return std::nullopt;
+
+    const auto& ids = index.values[static_cast<std::size_t>(facet)];
+
+    RoaringBitmap any;
+    for (const auto& value : values)
+    {
+        const auto kFound = ids.find(value);
+        if (kFound != ids.end())
+            any |= index.bitmaps[kFound->second];
+    }
+    return any;
+}
+
+std::optional<RoaringBitmap> FacetIndex::Match(const Index& index,
+                                              const FacetValues& values,
+                                              std::optional<Facet> skipped)
+{
+    std::optional<RoaringBitmap> matches;
+
+    for (std::size_t i = 0; i < kFacetCount; ++i)
+    {
+        const auto kFacet = static_cast<Facet>(i);
+        if (kFacet == skipped)
+            continue;
+
+        auto any = MatchAny(index, kFacet, values[i]);
+        if (!any)
+            continue;
+
+        if (matches)
+            *matches &= *any;
+        else
+            matches = std::move(any);
+    }
+
+    return matches;
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const FacetIndex& index)
+{
+    const auto& stats = index.GetStatistics();
+
+    writer["ready"] = index.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["values"] = index.GetValueCount();
+    writer["memory-bytes"] = index.GetMemoryBytes();
+
+    writer["filtering"] = stats.filtering;
+    writer["counting"] = stats.counting;
+    writer["matches"] = stats.matches;
+}
+
+} // namespace indexes
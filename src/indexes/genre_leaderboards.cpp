@@ -0,0 +1,326 @@
+// project headers
+#include <indexes/genre_leaderboards.hpp>
+
+// std
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+GenreLeaderboards::GenreLeaderboards(GenreLeaderboardSettings settings)
+    : settings_(settings)
+{}
+
+std::optional<std::vector<boost::uuids::uuid>>
+GenreLeaderboards::GetTop(std::string_view genre, std::size_t limit,
+                          Order order) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    std::vector<boost::uuids::uuid> top;
+    {
+        std::shared_lock lock(mutex_);
+        if (!ready_)
+            return std::nullopt;
+
+        const auto kGenre = boards_.genre_numbers.find(std::string{ genre });
+        if (kGenre == boards_.genre_numbers.end())
+            return top;
+
+        const auto& board = boards_.boards[kGenre->second];
+        const auto kRows = order == Order::kIgdbRating
+                               ? board.by_igdb_rating.Top(limit)
+                               : board.by_playhub_rating.Top(limit);
+        top.reserve(kRows.size());
+        for (const auto kRow : kRows)
+            top.push_back(boards_.rows[kRow].id);
+    }
+
+    stats_.ranking.Account(std::chrono::steady_clock::now() - kStarted);
+    return top;
+}
+
+std::optional<GenreRank>
+GenreLeaderboards::GetRank(const boost::uuids::uuid& id,
+                           std::string_view genre) const
+{
+    std::shared_lock lock(mutex_);
+    if (!ready_)
+        return std::nullopt;
+
+    const auto kGenre = boards_.genre_numbers.find(std::string{ genre });
+    const auto kGame = boards_.positions.find(id);
+    if (kGenre == boards_.genre_numbers.end() ||
+        kGame == boards_.positions.end())
+        return std::nullopt;
+
+    const auto& board = boards_.boards[kGenre->second];
+    const auto kIgdbRank = board.by_igdb_rating.GetRank(kGame->second);
+    const auto kPlayhubRank = board.by_playhub_rating.GetRank(kGame->second);
+    if (!kIgdbRank || !kPlayhubRank)
+        return std::nullopt;
+
+    return GenreRank{ *kIgdbRank + 1, *kPlayhubRank + 1,
+                      board.by_igdb_rating.Size() };
+}
+
+void GenreLeaderboards::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!ready_)
+        return;
+
+    Set(boards_, ToFeatures(game));
+    stats_.games = static_cast<std::int64_t>(boards_.rows.size());
+    stats_.genres = static_cast<std::int64_t>(boards_.boards.size());
+}
+
+void GenreLeaderboards::AccountRating(const boost::uuids::uuid& id,
+                                      std::int32_t playhub_rating)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    const auto kFound = boards_.positions.find(id);
+    if (kFound == boards_.positions.end())
+        return;
+
+    auto& game = boards_.rows[kFound->second];
+    if (game.playhub_rating == playhub_rating)
+        return;
+
+    game.playhub_rating = playhub_rating;
+    for (const auto kGenre : game.genres)
+        boards_.boards[kGenre].by_playhub_rating.Set(kFound->second,
+                                                     playhub_rating);
+    ++stats_.rating_changes;
+}
+
+bool GenreLeaderboards::Rebuild(const pg::IGameRepository& repository)
+{
+    Boards boards;
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [&boards](const std::vector<entities::GameFeatures>& games) {
+            for (const auto& game : games)
+                Set(boards, game);
+        });
+    if (!kScanned)
+        return false;
+
+    const auto kGames = boards.rows.size();
+    const auto kGenres = boards.boards.size();
+    {
+        std::lock_guard lock(mutex_);
+        boards_ = std::move(boards);
+        ready_ = true;
+    }
+    rebuild_requested_ = false;
+    stats_.games = static_cast<std::int64_t>(kGames);
+    stats_.genres = static_cast<std::int64_t>(kGenres);
+
+    LOG_INFO() << "Genre leaderboards are rebuilt with " << kGames
+               << " games in " << kGenres << " genres";
+    return true;
+}
+
+void GenreLeaderboards::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    for (const auto& change : changes)
+        Set(boards_, ToFeatures(change.game));
+    stats_.games = static_cast<std::int64_t>(boards_.rows.size());
+    stats_.genres = static_cast<std::int64_t>(boards_.boards.size());
+}
+
+bool GenreLeaderboards::IsRebuildRequested() const
+{
+    return rebuild_requested_;
+}
+
+void GenreLeaderboards::Maintain(const pg::IGameRepository& repository,
+                                 const entities::ChangeCursor& applied)
+{
+    if (std::chrono::steady_clock::now() - last_check_ >=
+        settings_.check_period)
+        Check(repository, applied);
+}
+
+bool GenreLeaderboards::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return ready_;
+}
+
+const GenreLeaderboardSettings& GenreLeaderboards::GetSettings() const
+{
+    return settings_;
+}
+
+const GenreLeaderboardStatistics& GenreLeaderboards::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t GenreLeaderboards::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+
+    auto bytes = boards_.rows.capacity() * sizeof(Game) +
+                 boards_.positions.size() *
+                     (sizeof(boost::uuids::uuid) + sizeof(std::uint32_t) +
+                      sizeof(void*));
+    for (const auto& game : boards_.rows)
+        bytes += game.genres.capacity() * sizeof(std::uint32_t);
+    for (const auto& board : boards_.boards)
+        bytes += board.by_igdb_rating.GetMemoryBytes() +
+                 board.by_playhub_rating.GetMemoryBytes();
+    return bytes;
+}
+
+bool GenreLeaderboards::Set(Boards& boards,
+                            const entities::GameFeatures& game)
+{
+    const auto [kPosition, kInserted] = boards.positions.emplace(
+        game.id, static_cast<std::uint32_t>(boards.rows.size()));
+    if (kInserted)
+        boards.rows.push_back(Game{ game.id });
+    const auto kRow = kPosition->second;
+
+    std::vector<std::uint32_t> genres;
+    genres.reserve(game.genres.size());
+    for (const auto& name : game.genres)
+    {
+        const auto [kGenre, kNew] = boards.genre_numbers.emplace(
+            name, static_cast<std::uint32_t>(boards.genre_names.size()));
+        if (kNew)
+        {
+            boards.genre_names.push_back(name);
+            boards.boards.emplace_back();
+        }
+        genres.push_back(kGenre->second);
+    }
+    std::sort(genres.begin(), genres.end());
+    genres.erase(std::unique(genres.begin(), genres.end()), genres.end());
+
+    auto& row = boards.rows[kRow];
+    if (!kInserted && row.genres == genres &&
+        row.igdb_rating == game.igdb_rating &&
+        row.playhub_rating == game.playhub_rating)
+        return false;
+
+    for (const auto kGenre : row.genres)
+        if (!std::binary_search(genres.begin(), genres.end(), kGenre))
+        {
+            boards.boards[kGenre].by_igdb_rating.Erase(kRow);
+            boards.boards[kGenre].by_playhub_rating.Erase(kRow);
+        }
+
+    for (const auto kGenre : genres)
+    {
+        boards.boards[kGenre].by_igdb_rating.Set(kRow, game.igdb_rating);
+        boards.boards[kGenre].by_playhub_rating.Set(kRow,
+                                                    game.playhub_rating);
+    }
+
+    row.genres = std::move(genres);
+    row.igdb_rating = game.igdb_rating;
+    row.playhub_rating = game.playhub_rating;
+    return true;
+}
+
+// Every game Postgres ranks among the best of the genre has to be on its
+// leaderboard with the same ratings. Games changed at or after the latest
+// applied change are skipped, they may not be applied yet. The order isn't
+// compared, Postgres breaks rating ties arbitrarily
+void GenreLeaderboards::Check(const pg::IGameRepository& repository,
+                              const entities::ChangeCursor& applied)
+{
+    last_check_ = std::chrono::steady_clock::now();
+
+    std::string genre;
+    {
+        std::shared_lock lock(mutex_);
+        if (boards_.genre_names.empty())
+            return;
+        genre = boards_.genre_names[next_checked_++ %
+                                    boards_.genre_names.size()];
+    }
+
+    const auto kGames =
+        repository.GetGamesByGenre(genre, settings_.check_depth);
+    ++stats_.checks;
+
+    std::int64_t mismatches = 0;
+    {
+        std::shared_lock lock(mutex_);
+        const auto kGenre = boards_.genre_numbers.find(genre);
+        for (const auto& game : kGames)
+        {
+            if (game.updated_at.GetUnderlying() >=
+                applied.updated_at.GetUnderlying())
+                continue;
+
+            const auto kFound = boards_.positions.find(game.id);
+            if (kFound == boards_.positions.end() ||
+                kGenre == boards_.genre_numbers.end() ||
+                !boards_.boards[kGenre->second].by_igdb_rating.Contains(
+                    kFound->second))
+            {
+                ++mismatches;
+                continue;
+            }
+
+            const auto& row = boards_.rows[kFound->second];
+            if (row.igdb_rating != game.igdb_rating ||
+                row.playhub_rating != game.playhub_rating)
+                ++mismatches;
+        }
+    }
+
+    if (mismatches == 0)
+        return;
+
+    LOG_WARNING() << "Leaderboard of genre " << genre
+                  << " differs from Postgres in " << mismatches
+                  << " games, rebuilding";
+    stats_.inconsistencies.Add(userver::utils::statistics::Rate{
+        static_cast<std::uint64_t>(mismatches) });
+    rebuild_requested_ = true;
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const GenreLeaderboards& leaderboards)
+{
+    const auto& stats = leaderboards.GetStatistics();
+
+    writer["ready"] = leaderboards.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["genres"] = stats.genres.load();
+    writer["memory-bytes"] = leaderboards.GetMemoryBytes();
+
+    writer["ranking"] = stats.ranking;
+    writer["rating-changes"] = stats.rating_changes;
+    writer["checks"] = stats.checks;
+    writer["inconsistencies"] = stats.inconsistencies;
+}
+
+} // namespace indexes
@@ -0,0 +1,310 @@
+// project headers
+#include <indexes/hnsw_index.hpp>
+
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <queue>
+
+namespace indexes {
+
+namespace {
+
+struct CloserFirst
+{
+    bool operator()(const HnswIndex::Neighbor& lhs,
+                    const HnswIndex::Neighbor& rhs) const
+    {
+        return lhs.similarity < rhs.similarity;
+    }
+};
+
+struct FartherFirst
+{
+    bool operator()(const HnswIndex::Neighbor& lhs,
+                    const HnswIndex::Neighbor& rhs) const
+    {
+        return lhs.similarity > rhs.similarity;
+    }
+};
+
+} // namespace
+
+HnswIndex::HnswIndex(std::size_t dimension, std::size_t m,
+                     std::size_t ef_construction, std::uint64_t seed)
+    : dimension_(dimension), m_(std::max<std::size_t>(m, 2)),
+      ef_construction_(std::max(ef_construction, m_)),
+      level_factor_(1.0 / std::log(static_cast<double>(m_))), random_(seed)
+{}
+
+std::uint32_t HnswIndex::Add(const float* vector)
+{
+    const auto kNode = static_cast<std::uint32_t>(Size());
+
+    // Levels are geometric, a node is on layer l with odds m^-l
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const auto kLevel = std::min(
+        static_cast<std::size_t>(-std::log(1.0 - uniform(random_)) *
+                                 level_factor_),
+        kMaxLevel);
+
+    vectors_.insert(vectors_.end(), vector, vector + dimension_);
+    levels_.push_back(static_cast<std::uint8_t>(kLevel));
+    base_links_.resize(base_links_.size() + 1 + GetMaxLinks(0), 0);
+    upper_links_.emplace_back(kLevel * (1 + m_), 0);
+
+    if (kNode == 0)
+    {
+        entry_ = kNode;
+        top_level_ = kLevel;
+        return kNode;
+    }
+
+    const auto* query = GetVector(kNode);
+    auto entry = entry_;
+    for (auto level = top_level_; level > kLevel; --level)
+        entry = SearchGreedy(query, entry, level);
+
+    for (auto level = std::min(kLevel, top_level_) + 1; level-- > 0;)
+    {
+        auto candidates =
+            SearchLayer(query, entry, ef_construction_, level);
+        entry = candidates.front().node;
+
+        const auto kNeighbors = SelectNeighbors(std::move(candidates), m_);
+        auto* links = GetLinks(kNode, level);
+        for (const auto& neighbor : kNeighbors)
+        {
+            links[1 + links[0]++] = neighbor.node;
+            Link(neighbor.node, kNode, level);
+        }
+    }
+
+    if (kLevel > top_level_)
+    {
+        entry_ = kNode;
+        top_level_ = kLevel;
+    }
+
+    return kNode;
+}
+
+std::vector<HnswIndex::Neighbor>
+HnswIndex::Search(const float* query, std::size_t k,
+                  std::size_t ef) const
+{
+    if (Size() == 0 || k == 0 ||
+        GetDotProduct(query, query, dimension_) == 0.0f)
+        return {};
+
+    auto entry = entry_;
+    for (auto level = top_level_; level > 0; --level)
+        entry = SearchGreedy(query, entry, level);
+
+    auto neighbors = SearchLayer(query, entry, std::max(ef, k), 0);
+    if (neighbors.size() > k)
+        neighbors.resize(k);
+    return neighbors;
+}
+
+const float* HnswIndex::GetVector(std::uint32_t node) const
+{
+    return vectors_.data() + std::size_t{ node } * dimension_;
+}
+
+void HnswIndex::Reserve(std::size_t nodes)
+{
+    vectors_.reserve(nodes * dimension_);
+    levels_.reserve(nodes);
+    base_links_.reserve(nodes * (1 + GetMaxLinks(0)));
+    upper_links_.reserve(nodes);
+}
+
+std::size_t HnswIndex::Size() const
+{
+    return levels_.size();
+}
+
+std::size_t HnswIndex::GetMemoryBytes() const
+{
+    auto bytes = vectors_.capacity() * sizeof(float) + levels_.capacity() +
+                 base_links_.capacity() * sizeof(std::uint32_t) +
+                 upper_links_.capacity() * sizeof(std::vector<std::uint32_t>);
+    for (const auto& links : upper_links_)
+        bytes += links.capacity() * sizeof(std::uint32_t);
+    return bytes;
+}
+
+float HnswIndex::GetSimilarity(const float* query, std::uint32_t node) const
+{
+    return GetDotProduct(query, GetVector(node), dimension_);
+}
+
+std::uint32_t* HnswIndex::GetLinks(std::uint32_t node, std::size_t level)
+{
+    if (level == 0)
+        return base_links_.data() + std::size_t{ node } * (1 + GetMaxLinks(0));
+    return upper_links_[node].data() + (level - 1) * (1 + m_);
+}
+
+const std::uint32_t* HnswIndex::GetLinks(std::uint32_t node,
+                                         std::size_t level) const
+{
+    return const_cast<HnswIndex*>(this)->GetLinks(node, level);
+}
+
+std::size_t HnswIndex::GetMaxLinks(std::size_t level) const
+{
+    return level == 0 ? 2 * m_ : m_;
+}
+
+std::uint32_t HnswIndex::SearchGreedy(const float* query, std::uint32_t entry,
+                                      std::size_t level) const
+{
+    auto best = entry;
+    auto best_similarity = GetSimilarity(query, best);
+
+    for (bool moved = true; moved;)
+    {
+        moved = false;
+        const auto* links = GetLinks(best, level);
+        for (std::uint32_t i = 1; i <= links[0]; ++i)
+        {
+            const auto kSimilarity = GetSimilarity(query, links[i]);
+            if (kSimilarity > best_similarity)
+            {
+                best = links[i];
+                best_similarity = kSimilarity;
+                moved = true;
+            }
+        }
+    }
+
+    return best;
+}
+
+std::vector<HnswIndex::Neighbor>
+HnswIndex::SearchLayer(const float* query, std::uint32_t entry,
+                       std::size_t ef, std::size_t level) const
+{
+    std::vector<bool> visited(Size(), false);
+    std::priority_queue<Neighbor, std::vector<Neighbor>, CloserFirst>
+        candidates;
+    // The farthest of the closest nodes so far on top
+    std::priority_queue<Neighbor, std::vector<Neighbor>, FartherFirst> found;
+
+    const Neighbor kEntry{ entry, GetSimilarity(query, entry) };
+    visited[entry] = true;
+    candidates.push(kEntry);
+    found.push(kEntry);
+
+    while (!candidates.empty())
+    {
+        const auto kCandidate = candidates.top();
+        // Every node left is farther than all of the ones found
+        if (found.size() == ef &&
+            kCandidate.similarity < found.top().similarity)
+            break;
+        candidates.pop();
+
+        const auto* links = GetLinks(kCandidate.node, level);
+        for (std::uint32_t i = 1; i <= links[0]; ++i)
+        {
+            const auto kNode = links[i];
+            if (visited[kNode])
+                continue;
+            visited[kNode] = true;
+
+            const Neighbor kNeighbor{ kNode, GetSimilarity(query, kNode) };
+            if (found.size() < ef ||
+                kNeighbor.similarity > found.top().similarity)
+            {
+                candidates.push(kNeighbor);
+                found.push(kNeighbor);
+                if (found.size() > ef)
+                    found.pop();
+            }
+        }
+    }
+
+    std::vector<Neighbor> neighbors(found.size());
+    for (auto i = neighbors.size(); i-- > 0; found.pop())
+        neighbors[i] = found.top();
+    return neighbors;
+}
+
+std::vector<HnswIndex::Neighbor>
+HnswIndex::SelectNeighbors(std::vector<Neighbor> candidates,
+                           std::size_t limit) const
+{
+    std::vector<Neighbor> selected;
+    selected.reserve(limit);
+
+    for (const auto& candidate : candidates)
+    {
+        if (selected.size() == limit)
+            break;
+
+        const auto* vector = GetVector(candidate.node);
+        const auto kCovered =
+            std::any_of(selected.begin(), selected.end(),
+                        [&](const Neighbor& kept) {
+                            return GetSimilarity(vector, kept.node) >
+                                   candidate.similarity;
+                        });
+        if (!kCovered)
+            selected.push_back(candidate);
+    }
+
+    return selected;
+}
+
+void HnswIndex::Link(std::uint32_t node, std::uint32_t neighbor,
+                     std::size_t level)
+{
+    auto* links = GetLinks(node, level);
+    const auto kMaxLinks = GetMaxLinks(level);
+    if (links[0] < kMaxLinks)
+    {
+        links[1 + links[0]++] = neighbor;
+        return;
+    }
+
+    // A full node keeps the most diverse of its links and the new one
+    const auto* vector = GetVector(node);
+    std::vector<Neighbor> candidates;
+    candidates.reserve(kMaxLinks + 1);
+    for (std::uint32_t i = 1; i <= links[0]; ++i)
+        candidates.push_back({ links[i], GetSimilarity(vector, links[i]) });
+    candidates.push_back({ neighbor, GetSimilarity(vector, neighbor) });
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Neighbor& lhs, const Neighbor& rhs) {
+                  return lhs.similarity > rhs.similarity;
+              });
+
+    const auto kSelected = SelectNeighbors(std::move(candidates), kMaxLinks);
+    links[0] = static_cast<std::uint32_t>(kSelected.size());
+    for (std::size_t i = 0; i < kSelected.size(); ++i)
+        links[1 + i] = kSelected[i].node;
+}
+
+float GetDotProduct(const float* lhs, const float* rhs, std::size_t dimension)
+{
+    constexpr std::size_t kLanes = 8;
+
+    std::array<float, kLanes> lanes{};
+    std::size_t i = 0;
+    for (; i + kLanes <= dimension; i += kLanes)
+        for (std::size_t lane = 0; lane < kLanes; ++lane)
+            lanes[lane] += lhs[i + lane] * rhs[i + lane];
+
+    float sum = 0.0f;
+    for (; i < dimension; ++i)
+        sum += lhs[i] * rhs[i];
+    for (const auto kLane : lanes)
+        sum += kLane;
+    return sum;
+}
+
+} // namespace indexes
@@ -0,0 +1,145 @@
+// project headers
+#include <indexes/indexed_heap.hpp>
+
+// std
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace indexes {
+
+void IndexedHeap::Set(Item item, double key)
+{
+    if (item >= slots_.size())
+    {
+        keys_.resize(std::size_t{ item } + 1, 0.0);
+        slots_.resize(std::size_t{ item } + 1, kAbsent);
+    }
+
+    const auto kPrevious = keys_[item];
+    keys_[item] = key;
+
+    if (slots_[item] == kAbsent)
+    {
+        heap_.push_back(item);
+        slots_[item] = static_cast<std::uint32_t>(heap_.size() - 1);
+        SiftUp(heap_.size() - 1);
+    }
+    else if (key > kPrevious)
+        SiftUp(slots_[item]);
+    else
+        SiftDown(slots_[item]);
+}
+
+void IndexedHeap::Assign(std::vector<double> keys)
+{
+    keys_ = std::move(keys);
+    heap_.resize(keys_.size());
+    slots_.resize(keys_.size());
+    for (std::size_t i = 0; i < keys_.size(); ++i)
+    {
+        heap_[i] = static_cast<Item>(i);
+        slots_[i] = static_cast<std::uint32_t>(i);
+    }
+
+    for (auto slot = heap_.size() / 2; slot-- > 0;)
+        SiftDown(slot);
+}
+
+// A child is never above its parent, so the next best item is always a
+// child of one already taken
+std::vector<IndexedHeap::Item> IndexedHeap::Top(std::size_t k) const
+{
+    const auto kLower = [this](std::uint32_t lhs, std::uint32_t rhs) {
+        return keys_[heap_[lhs]] < keys_[heap_[rhs]];
+    };
+    std::priority_queue<std::uint32_t, std::vector<std::uint32_t>,
+                        decltype(kLower)>
+        frontier(kLower);
+
+    std::vector<Item> top;
+    top.reserve(std::min(k, heap_.size()));
+    if (!heap_.empty())
+        frontier.push(0);
+
+    while (top.size() < k && !frontier.empty())
+    {
+        const auto kSlot = frontier.top();
+        frontier.pop();
+        top.push_back(heap_[kSlot]);
+
+        for (const auto kChild : { 2 * kSlot + 1, 2 * kSlot + 2 })
+            if (kChild < heap_.size())
+                frontier.push(kChild);
+    }
+
+    return top;
+}
+
+bool IndexedHeap::Contains(Item item) const
+{
+    return item < slots_.size() && slots_[item] != kAbsent;
+}
+
+double IndexedHeap::GetKey(Item item) const
+{
+    return keys_[item];
+}
+
+const std::vector<double>& IndexedHeap::GetKeys() const
+{
+    return keys_;
+}
+
+std::size_t IndexedHeap::Size() const
+{
+    return heap_.size();
+}
+
+std::size_t IndexedHeap::GetMemoryBytes() const
+{
+    return keys_.capacity() * sizeof(double) +
+           heap_.capacity() * sizeof(Item) +
+           slots_.capacity() * sizeof(std::uint32_t);
+}
+
+void IndexedHeap::SiftUp(std::size_t slot)
+{
+    const auto kItem = heap_[slot];
+    while (slot > 0)
+    {
+        const auto kParent = (slot - 1) / 2;
+        if (keys_[heap_[kParent]] >= keys_[kItem])
+            break;
+        Place(slot, heap_[kParent]);
+        slot = kParent;
+    }
+    Place(slot, kItem);
+}
+
+void IndexedHeap::SiftDown(std::size_t slot)
+{
+    const auto kItem = heap_[slot];
+    while (true)
+    {
+        auto child = 2 * slot + 1;
+        if (child >= heap_.size())
+            break;
+        if (child + 1 < heap_.size() &&
+            keys_[heap_[child + 1]] > keys_[heap_[child]])
+            ++child;
+        if (keys_[kItem] >= keys_[heap_[child]])
+            break;
+        Place(slot, heap_[child]);
+        slot = child;
+    }
+    Place(slot, kItem);
+}
+
+void IndexedHeap::Place(std::size_t slot, Item item)
+{
+    heap_[slot] = item;
+    slots_[item] = static_cast<std::uint32_t>(slot);
+}
+
+} // namespace indexes
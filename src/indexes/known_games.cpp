@@ -0,0 +1,195 @@
+// project headers
+#include <indexes/known_games.hpp>
+#include <tools/utils.hpp>
+
+// std
+#include <algorithm>
+#include <string>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+KnownGamesFilter::Filters::Filters(std::size_t expected_items,
+                                   double false_positive_rate)
+    : ids(expected_items, false_positive_rate),
+      slugs(expected_items, false_positive_rate)
+{}
+
+KnownGamesFilter::KnownGamesFilter(KnownGamesSettings settings)
+    : settings_(settings), capacity_(settings.expected_items)
+{}
+
+bool KnownGamesFilter::MayContainId(std::string_view id) const
+{
+    const auto kFilters = GetCurrent();
+    if (!kFilters)
+        return true;
+
+    // Postgres accepts uuids spelled in several ways, only the canonical
+    // spelling is in the filter
+    const auto kCanonical = utils::ToCanonicalUuid(id);
+    if (!kCanonical || kFilters->ids.MayContain(*kCanonical))
+        return true;
+
+    ++stats_.rejected;
+    return false;
+}
+
+bool KnownGamesFilter::MayContainSlug(std::string_view slug) const
+{
+    const auto kFilters = GetCurrent();
+    if (!kFilters || kFilters->slugs.MayContain(slug))
+        return true;
+
+    ++stats_.rejected;
+    return false;
+}
+
+void KnownGamesFilter::Add(std::string_view id, std::string_view slug)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    if (auto current = GetCurrent())
+        AddTo(*current, id, slug);
+    if (next_)
+        AddTo(*next_, id, slug);
+}
+
+void KnownGamesFilter::AccountFalsePositive()
+{
+    if (IsReady())
+        ++stats_.false_positives;
+}
+
+bool KnownGamesFilter::Rebuild(const pg::IGameRepository& repository)
+{
+    const auto kCapacity = std::max(
+        settings_.expected_items,
+        2 * static_cast<std::size_t>(std::max<std::int64_t>(
+                stats_.items.load(), 0)));
+
+    auto filters =
+        std::make_shared<Filters>(kCapacity, settings_.false_positive_rate);
+    {
+        std::lock_guard lock(mutex_);
+        next_ = filters;
+    }
+
+    std::int64_t items = 0;
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameKeys(after, batch);
+        },
+        settings_.scan_batch,
+        [&filters, &items](const std::vector<entities::GameKey>& keys) {
+            for (const auto& key : keys)
+            {
+                filters->ids.Add(key.id);
+                filters->slugs.Add(key.slug);
+            }
+            items += static_cast<std::int64_t>(keys.size());
+        });
+
+    {
+        std::lock_guard lock(mutex_);
+        if (kScanned)
+            current_.Assign(filters);
+        next_.reset();
+    }
+    if (!kScanned)
+        return false;
+
+    capacity_ = kCapacity;
+    stats_.items = items;
+
+    LOG_INFO() << "Known games filter is rebuilt with " << items
+               << " games, capacity " << kCapacity;
+    return true;
+}
+
+void KnownGamesFilter::Apply(const std::vector<feed::Change>& changes)
+{
+    for (const auto& change : changes)
+        Add(change.cursor.id, change.game.slug);
+}
+
+bool KnownGamesFilter::IsRebuildRequested() const
+{
+    return static_cast<std::size_t>(stats_.items.load()) > capacity_;
+}
+
+bool KnownGamesFilter::IsReady() const
+{
+    return GetCurrent() != nullptr;
+}
+
+const KnownGamesSettings& KnownGamesFilter::GetSettings() const
+{
+    return settings_;
+}
+
+const KnownGamesStatistics& KnownGamesFilter::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t KnownGamesFilter::GetMemoryBytes() const
+{
+    const auto kFilters = GetCurrent();
+    if (!kFilters)
+        return 0;
+
+    return kFilters->ids.GetMemoryBytes() + kFilters->slugs.GetMemoryBytes();
+}
+
+double KnownGamesFilter::GetIdFalsePositiveRate() const
+{
+    const auto kFilters = GetCurrent();
+    return kFilters ? kFilters->ids.EstimateFalsePositiveRate() : 0.0;
+}
+
+double KnownGamesFilter::GetSlugFalsePositiveRate() const
+{
+    const auto kFilters = GetCurrent();
+    return kFilters ? kFilters->slugs.EstimateFalsePositiveRate() : 0.0;
+}
+
+KnownGamesFilter::FiltersPtr KnownGamesFilter::GetCurrent() const
+{
+    return *current_.Read();
+}
+
+void KnownGamesFilter::AddTo(Filters& filters, std::string_view id,
+                             std::string_view slug)
+{
+    if (!filters.ids.MayContain(id) || !filters.slugs.MayContain(slug))
+        ++stats_.items;
+
+    filters.ids.Add(id);
+    filters.slugs.Add(slug);
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const KnownGamesFilter& filter)
+{
+    const auto& stats = filter.GetStatistics();
+
+    writer["ready"] = filter.IsReady() ? 1 : 0;
+    writer["items"] = stats.items.load();
+    writer["memory-bytes"] = filter.GetMemoryBytes();
+
+    writer["false-positive-rate"].ValueWithLabels(
+        filter.GetIdFalsePositiveRate(), { { "key", "id" } });
+    writer["false-positive-rate"].ValueWithLabels(
+        filter.GetSlugFalsePositiveRate(), { { "key", "slug" } });
+
+    writer["rejected"] = stats.rejected;
+    writer["false-positives"] = stats.false_positives;
+}
+
+} // namespace indexes
@@ -0,0 +1,213 @@
+// project headers
+#include <indexes/rank_tree.hpp>
+
+// std
+#include <algorithm>
+#include <utility>
+
+namespace indexes {
+
+void RankTree::Set(Item item, double key)
+{
+    std::uint32_t node = 0;
+    if (const auto kFound = nodes_of_.find(item); kFound != nodes_of_.end())
+    {
+        // A moved item keeps its node
+        node = kFound->second;
+        if (nodes_[node].key == key)
+            return;
+        root_ = Remove(root_, nodes_[node].key, item);
+        nodes_[node] = Node{ item, key, NextPriority() };
+    }
+    else if (free_.empty())
+    {
+        node = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back(Node{ item, key, NextPriority() });
+        nodes_of_.emplace(item, node);
+    }
+    else
+    {
+        node = free_.back();
+        free_.pop_back();
+        nodes_[node] = Node{ item, key, NextPriority() };
+        nodes_of_.emplace(item, node);
+    }
+
+    const auto [kBefore, kAfter] = Split(root_, key, item);
+    root_ = Merge(Merge(kBefore, node), kAfter);
+}
+
+void RankTree::Erase(Item item)
+{
+    const auto kFound = nodes_of_.find(item);
+    if (kFound == nodes_of_.end())
+        return;
+
+    const auto kNode = kFound->second;
+    root_ = Remove(root_, nodes_[kNode].key, item);
+    free_.push_back(kNode);
+    nodes_of_.erase(kFound);
+}
+
+std::optional<std::size_t> RankTree::GetRank(Item item) const
+{
+    const auto kFound = nodes_of_.find(item);
+    if (kFound == nodes_of_.end())
+        return std::nullopt;
+
+    const auto kKey = nodes_[kFound->second].key;
+    std::size_t rank = 0;
+    auto node = root_;
+    while (node != kNull)
+    {
+        const auto& current = nodes_[node];
+        if (current.item == item)
+            return rank + SizeOf(current.left);
+
+        if (Before(kKey, item, current))
+            node = current.left;
+        else
+        {
+            rank += SizeOf(current.left) + 1;
+            node = current.right;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<RankTree::Item> RankTree::Top(std::size_t k) const
+{
+    std::vector<Item> top;
+    top.reserve(std::min(k, nodes_of_.size()));
+
+    // In-order walk that stops after `k` nodes
+    std::vector<std::uint32_t> path;
+    auto node = root_;
+    while (top.size() < k && (node != kNull || !path.empty()))
+    {
+        if (node != kNull)
+        {
+            path.push_back(node);
+            node = nodes_[node].left;
+            continue;
+        }
+
+        node = path.back();
+        path.pop_back();
+        top.push_back(nodes_[node].item);
+        node = nodes_[node].right;
+    }
+
+    return top;
+}
+
+bool RankTree::Contains(Item item) const
+{
+    return nodes_of_.count(item) != 0;
+}
+
+std::optional<double> RankTree::GetKey(Item item) const
+{
+    const auto kFound = nodes_of_.find(item);
+    if (kFound == nodes_of_.end())
+        return std::nullopt;
+    return nodes_[kFound->second].key;
+}
+
+std::size_t RankTree::Size() const
+{
+    return nodes_of_.size();
+}
+
+std::size_t RankTree::GetMemoryBytes() const
+{
+    return nodes_.capacity() * sizeof(Node) +
+           free_.capacity() * sizeof(std::uint32_t) +
+           nodes_of_.size() *
+               (sizeof(Item) + sizeof(std::uint32_t) + sizeof(void*));
+}
+
+bool RankTree::Before(double key, Item item, const Node& node)
+{
+    return key > node.key || (key == node.key && item < node.item);
+}
+
+std::uint32_t RankTree::SizeOf(std::uint32_t node) const
+{
+    return node == kNull ? 0 : nodes_[node].size;
+}
+
+void RankTree::Resize(std::uint32_t node)
+{
+    auto& current = nodes_[node];
+    current.size = 1 + SizeOf(current.left) + SizeOf(current.right);
+}
+
+std::pair<std::uint32_t, std::uint32_t>
+RankTree::Split(std::uint32_t node, double key, Item item)
+{
+    if (node == kNull)
+        return { kNull, kNull };
+
+    // The node is after the key, so is its right subtree
+    if (Before(key, item, nodes_[node]))
+    {
+        const auto [kBefore, kAfter] = Split(nodes_[node].left, key, item);
+        nodes_[node].left = kAfter;
+        Resize(node);
+        return { kBefore, node };
+    }
+
+    const auto [kBefore, kAfter] = Split(nodes_[node].right, key, item);
+    nodes_[node].right = kBefore;
+    Resize(node);
+    return { node, kAfter };
+}
+
+std::uint32_t RankTree::Merge(std::uint32_t first, std::uint32_t second)
+{
+    if (first == kNull)
+        return second;
+    if (second == kNull)
+        return first;
+
+    if (nodes_[first].priority > nodes_[second].priority)
+    {
+        nodes_[first].right = Merge(nodes_[first].right, second);
+        Resize(first);
+        return first;
+    }
+
+    nodes_[second].left = Merge(first, nodes_[second].left);
+    Resize(second);
+    return second;
+}
+
+std::uint32_t RankTree::Remove(std::uint32_t node, double key, Item item)
+{
+    if (node == kNull)
+        return kNull;
+
+    auto& current = nodes_[node];
+    if (current.item == item)
+        return Merge(current.left, current.right);
+
+    if (Before(key, item, current))
+        current.left = Remove(current.left, key, item);
+    else
+        current.right = Remove(current.right, key, item);
+    Resize(node);
+    return node;
+}
+
+// xorshift64, priorities only need to look random to keep the treap
+// balanced
+std::uint32_t RankTree::NextPriority()
+{
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 7;
+    random_ ^= random_ << 17;
+    return static_cast<std::uint32_t>(random_ >> 32);
+}
+
+} // namespace indexes
@@ -0,0 +1,417 @@
+// project headers
+#include <indexes/roaring_bitmap.hpp>
+
+// std
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace indexes {
+
+namespace {
+
+constexpr std::size_t kBitsPerWord = 64;
+constexpr std::size_t kBitmapWords = (1 << 16) / kBitsPerWord;
+
+// An array of this many values takes as much memory as a bitmap
+constexpr std::size_t kMaxArraySize = 4096;
+
+std::uint16_t High(std::uint32_t value)
+{
+    return static_cast<std::uint16_t>(value >> 16);
+}
+
+std::uint16_t Low(std::uint32_t value)
+{
+    return static_cast<std::uint16_t>(value & 0xFFFF);
+}
+
+std::uint32_t CountBits(std::uint64_t word)
+{
+    return static_cast<std::uint32_t>(std::bitset<kBitsPerWord>(word).count());
+}
+
+bool TestBit(const std::vector<std::uint64_t>& bits, std::uint16_t low)
+{
+    return (bits[low / kBitsPerWord] >> (low % kBitsPerWord)) & 1;
+}
+
+std::vector<std::uint64_t> ToBits(const std::vector<std::uint16_t>& array)
+{
+    std::vector<std::uint64_t> bits(kBitmapWords, 0);
+    for (const auto kLow : array)
+        bits[kLow / kBitsPerWord] |= std::uint64_t{ 1 }
+                                     << (kLow % kBitsPerWord);
+    return bits;
+}
+
+std::vector<std::uint16_t> ToArray(const std::vector<std::uint64_t>& bits)
+{
+    std::vector<std::uint16_t> array;
+    for (std::size_t word = 0; word < bits.size(); ++word)
+    {
+        auto remaining = bits[word];
+        while (remaining != 0)
+        {
+            const auto kLowest = remaining & (~remaining + 1);
+            array.push_back(static_cast<std::uint16_t>(
+                word * kBitsPerWord + CountBits(kLowest - 1)));
+            remaining ^= kLowest;
+        }
+    }
+    return array;
+}
+
+} // namespace
+
+void RoaringBitmap::Add(std::uint32_t value)
+{
+    const auto kHigh = High(value);
+    const auto kLow = Low(value);
+
+    auto container = std::lower_bound(
+        containers_.begin(), containers_.end(), kHigh,
+        [](const Container& c, std::uint16_t key) { return c.key < key; });
+    if (container == containers_.end() || container->key != kHigh)
+    {
+        container = containers_.insert(container, Container{});
+        container->key = kHigh;
+    }
+
+    if (!container->bits.empty())
+    {
+        auto& word = container->bits[kLow / kBitsPerWord];
+        const auto kMask = std::uint64_t{ 1 } << (kLow % kBitsPerWord);
+        if (!(word & kMask))
+        {
+            word |= kMask;
+            ++container->cardinality;
+        }
+        return;
+    }
+
+    auto& array = container->array;
+    const auto kPosition = std::lower_bound(array.begin(), array.end(), kLow);
+    if (kPosition != array.end() && *kPosition == kLow)
+        return;
+
+    array.insert(kPosition, kLow);
+    ++container->cardinality;
+
+    if (array.size() > kMaxArraySize)
+    {
+        container->bits = ToBits(array);
+        container->array = {};
+    }
+}
+
+void RoaringBitmap::Remove(std::uint32_t value)
+{
+    auto* container = Find(High(value));
+    if (!container)
+        return;
+
+    const auto kLow = Low(value);
+    if (!container->bits.empty())
+    {
+        auto& word = container->bits[kLow / kBitsPerWord];
+        const auto kMask = std::uint64_t{ 1 } << (kLow % kBitsPerWord);
+        if (!(word & kMask))
+            return;
+
+        word &= ~kMask;
+        if (--container->cardinality <= kMaxArraySize)
+        {
+            container->array = ToArray(container->bits);
+            container->bits = {};
+        }
+    }
+    else
+    {
+        auto& array = container->array;
+        const auto kPosition =
+            std::lower_bound(array.begin(), array.end(), kLow);
+        if (kPosition == array.end() || *kPosition != kLow)
+            return;
+
+        array.erase(kPosition);
+        --container->cardinality;
+    }
+
+    if (container->cardinality == 0)
+        containers_.erase(containers_.begin() +
+                          std::distance(containers_.data(), container));
+}
+
+bool RoaringBitmap::Contains(std::uint32_t value) const
+{
+    const auto* container = Find(High(value));
+    if (!container)
+        return false;
+
+    const auto kLow = Low(value);
+    if (!container->bits.empty())
+        return TestBit(container->bits, kLow);
+
+    return std::binary_search(container->array.begin(),
+                              container->array.end(), kLow);
+}
+
+std::uint64_t RoaringBitmap::GetCardinality() const
+{
+    std::uint64_t cardinality = 0;
+    for (const auto& container : containers_)
+        cardinality += container.cardinality;
+    return cardinality;
+}
+
+bool RoaringBitmap::IsEmpty() const
+{
+    return containers_.empty();
+}
+
+std::size_t RoaringBitmap::GetMemoryBytes() const
+{
+    std::size_t bytes = containers_.capacity() * sizeof(Container);
+    for (const auto& container : containers_)
+        bytes += container.array.capacity() * sizeof(std::uint16_t) +
+                 container.bits.capacity() * sizeof(std::uint64_t);
+    return bytes;
+}
+
+std::vector<std::uint32_t> RoaringBitmap::ToVector() const
+{
+    std::vector<std::uint32_t> values;
+    values.reserve(GetCardinality());
+
+    for (const auto& container : containers_)
+    {
+        const std::uint32_t kBase = std::uint32_t{ container.key } << 16;
+        const auto kLows =
+            container.bits.empty() ? container.array : ToArray(container.bits);
+
+        for (const auto kLow : kLows)
+            values.push_back(kBase | kLow);
+    }
+
+    return values;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other)
+{
+    *this = *this & other;
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other)
+{
+    *this = *this | other;
+    return *this;
+}
+
+RoaringBitmap operator&(const RoaringBitmap& lhs, const RoaringBitmap& rhs)
+{
+    RoaringBitmap result;
+
+    auto left = lhs.containers_.begin();
+    auto right = rhs.containers_.begin();
+    while (left != lhs.containers_.end() && right != rhs.containers_.end())
+    {
+        if (left->key < right->key)
+            ++left;
+        else if (right->key < left->key)
+            ++right;
+        else
+        {
+            auto container = RoaringBitmap::Intersect(*left, *right);
+            if (container.cardinality != 0)
+                result.containers_.push_back(std::move(container));
+            ++left;
+            ++right;
+        }
+    }
+
+    return result;
+}
+
+RoaringBitmap operator|(const RoaringBitmap& lhs, const RoaringBitmap& rhs)
+{
+    RoaringBitmap result;
+    result.containers_.reserve(
+        std::max(lhs.containers_.size(), rhs.containers_.size()));
+
+    auto left = lhs.containers_.begin();
+    auto right = rhs.containers_.begin();
+    while (left != lhs.containers_.end() || right != rhs.containers_.end())
+    {
+        if (right == rhs.containers_.end() ||
+            (left != lhs.containers_.end() && left->key < right->key))
+            result.containers_.push_back(*left++);
+        else if (left == lhs.containers_.end() || right->key < left->key)
+            result.containers_.push_back(*right++);
+        else
+            result.containers_.push_back(
+                RoaringBitmap::Unite(*left++, *right++));
+    }
+
+    return result;
+}
+
+std::uint64_t GetIntersectionCardinality(const RoaringBitmap& lhs,
+                                         const RoaringBitmap& rhs)
+{
+    std::uint64_t cardinality = 0;
+
+    auto left = lhs.containers_.begin();
+    auto right = rhs.containers_.begin();
+    while (left != lhs.containers_.end() && right != rhs.containers_.end())
+    {
+        if (left->key < right->key)
+            ++left;
+        else if (right->key < left->key)
+            ++right;
+        else
+            cardinality += RoaringBitmap::CountIntersection(*left++, *right++);
+    }
+
+    return cardinality;
+}
+
+RoaringBitmap::Container RoaringBitmap::Intersect(const Container& lhs,
+                                                  const Container& rhs)
+{
+    Container result;
+    result.key = lhs.key;
+
+    if (!lhs.bits.empty() && !rhs.bits.empty())
+    {
+        result.bits.resize(kBitmapWords);
+        for (std::size_t i = 0; i < kBitmapWords; ++i)
+        {
+            result.bits[i] = lhs.bits[i] & rhs.bits[i];
+            result.cardinality += CountBits(result.bits[i]);
+        }
+
+        if (result.cardinality <= kMaxArraySize)
+        {
+            result.array = ToArray(result.bits);
+            result.bits = {};
+        }
+        return result;
+    }
+
+    // The result is no larger than the smaller side, so it is an array
+    if (lhs.bits.empty() && rhs.bits.empty())
+        std::set_intersection(lhs.array.begin(), lhs.array.end(),
+                              rhs.array.begin(), rhs.array.end(),
+                              std::back_inserter(result.array));
+    else
+    {
+        const auto& kArray = lhs.bits.empty() ? lhs.array : rhs.array;
+        const auto& kBits = lhs.bits.empty() ? rhs.bits : lhs.bits;
+
+        for (const auto kLow : kArray)
+            if (TestBit(kBits, kLow))
+                result.array.push_back(kLow);
+    }
+
+    result.cardinality = static_cast<std::uint32_t>(result.array.size());
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::Unite(const Container& lhs,
+                                              const Container& rhs)
+{
+    Container result;
+    result.key = lhs.key;
+
+    if (lhs.bits.empty() && rhs.bits.empty() &&
+        lhs.cardinality + rhs.cardinality <= kMaxArraySize)
+    {
+        std::set_union(lhs.array.begin(), lhs.array.end(), rhs.array.begin(),
+                       rhs.array.end(), std::back_inserter(result.array));
+        result.cardinality = static_cast<std::uint32_t>(result.array.size());
+        return result;
+    }
+
+    result.bits = lhs.bits.empty() ? ToBits(lhs.array) : lhs.bits;
+    if (rhs.bits.empty())
+        for (const auto kLow : rhs.array)
+            result.bits[kLow / kBitsPerWord] |= std::uint64_t{ 1 }
+                                                << (kLow % kBitsPerWord);
+    else
+        for (std::size_t i = 0; i < kBitmapWords; ++i)
+            result.bits[i] |= rhs.bits[i];
+
+    for (const auto kWord : result.bits)
+        result.cardinality += CountBits(kWord);
+
+    if (result.cardinality <= kMaxArraySize)
+    {
+        result.array = ToArray(result.bits);
+        result.bits = {};
+    }
+    return result;
+}
+
+std::uint32_t RoaringBitmap::CountIntersection(const Container& lhs,
+                                               const Container& rhs)
+{
+    std::uint32_t cardinality = 0;
+
+    if (!lhs.bits.empty() && !rhs.bits.empty())
+    {
+        for (std::size_t i = 0; i < kBitmapWords; ++i)
+            cardinality += CountBits(lhs.bits[i] & rhs.bits[i]);
+    }
+    else if (lhs.bits.empty() && rhs.bits.empty())
+    {
+        auto left = lhs.array.begin();
+        auto right = rhs.array.begin();
+        while (left != lhs.array.end() && right != rhs.array.end())
+        {
+            if (*left < *right)
+                ++left;
+            else if (*right < *left)
+                ++right;
+            else
+            {
+                ++cardinality;
+                ++left;
+                ++right;
+            }
+        }
+    }
+    else
+    {
+        const auto& kArray = lhs.bits.empty() ? lhs.array : rhs.array;
+        const auto& kBits = lhs.bits.empty() ? rhs.bits : lhs.bits;
+
+        for (const auto kLow : kArray)
+            cardinality += TestBit(kBits, kLow) ? 1 : 0;
+    }
+
+    return cardinality;
+}
+
+RoaringBitmap::Container* RoaringBitmap::Find(std::uint16_t key)
+{
+    const auto kFound = std::lower_bound(
+        containers_.begin(), containers_.end(), key,
+        [](const Container& c, std::uint16_t k) { return c.key < k; });
+    if (kFound == containers_.end() || kFound->key != key)
+        return nullptr;
+    return &*kFound;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::Find(std::uint16_t key) const
+{
+    const auto kFound = std::lower_bound(
+        containers_.begin(), containers_.end(), key,
+        [](const Container& c, std::uint16_t k) { return c.key < k; });
+    if (kFound == containers_.end() || kFound->key != key)
+        return nullptr;
+    return &*kFound;
+}
+
+} // namespace indexes
@@ -0,0 +1,243 @@
+// project headers
+#include <indexes/semantic_index.hpp>
+#include <tools/utils.hpp>
+
+// std
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+
+// userver
+#include <userver/engine/sleep.hpp>
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+namespace {
+
+// Embedding a batch takes a while at catalog scale, other tasks of the
+// processor run in between
+constexpr std::size_t kYieldEvery = 32;
+
+} // namespace
+
+SemanticIndex::Graph::Graph(const SemanticSearchSettings& settings)
+    : embedder(settings.dimension, settings.frequency_buckets),
+      hnsw(settings.dimension, settings.m, settings.ef_construction)
+{}
+
+SemanticIndex::SemanticIndex(SemanticSearchSettings settings)
+    : settings_(settings)
+{}
+
+std::optional<std::vector<SemanticMatch>>
+SemanticIndex::Search(std::string_view query, std::size_t limit) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    TextEmbedder::Tokens tokens;
+    TextEmbedder::Tokenize(utils::NormalizeQuery(query), tokens);
+
+    std::vector<SemanticMatch> matches;
+    {
+        std::shared_lock lock(mutex_);
+
+        if (!graph_)
+            return std::nullopt;
+
+        const auto kQuery = graph_->embedder.Embed(tokens);
+
+        // Stale nodes are among the candidates, all of them are asked for
+        // so that they can be skipped
+        const auto kEf = std::max(settings_.ef_search, limit);
+        for (const auto& neighbor :
+             graph_->hnsw.Search(kQuery.data(), kEf, kEf))
+        {
+            if (matches.size() == limit)
+                break;
+            if (graph_->stale[neighbor.node])
+                continue;
+
+            matches.push_back(
+                { graph_->ids[neighbor.node], neighbor.similarity });
+        }
+    }
+
+    stats_.searching.Account(std::chrono::steady_clock::now() - kStarted);
+    return matches;
+}
+
+void SemanticIndex::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!graph_)
+        return;
+
+    Set(*graph_, game);
+    stats_.games = static_cast<std::int64_t>(graph_->nodes.size());
+    stats_.stale_nodes = static_cast<std::int64_t>(graph_->stale_count);
+}
+
+bool SemanticIndex::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return graph_ != nullptr;
+}
+
+const SemanticSearchSettings& SemanticIndex::GetSettings() const
+{
+    return settings_;
+}
+
+const SemanticSearchStatistics& SemanticIndex::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t SemanticIndex::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+    if (!graph_)
+        return 0;
+
+    return graph_->embedder.GetMemoryBytes() +
+           graph_->hnsw.GetMemoryBytes() +
+           graph_->ids.capacity() * sizeof(boost::uuids::uuid) +
+           graph_->stale.capacity() / 8;
+}
+
+TextEmbedder::Tokens
+SemanticIndex::Tokenize(const entities::GamePostgres& game)
+{
+    TextEmbedder::Tokens tokens;
+    TextEmbedder::Tokenize(utils::NormalizeQuery(game.summary), tokens);
+    for (const auto& genre : game.genres)
+        TextEmbedder::Tokenize(utils::NormalizeQuery(genre), tokens);
+    for (const auto& theme : game.themes)
+        TextEmbedder::Tokenize(utils::NormalizeQuery(theme), tokens);
+    return tokens;
+}
+
+void SemanticIndex::Set(Graph& graph, const entities::GamePostgres& game)
+{
+    const auto kVector = graph.embedder.Embed(Tokenize(game));
+    const auto kEmpty = std::all_of(kVector.begin(), kVector.end(),
+                                    [](float value) { return value == 0.0f; });
+
+    if (const auto kFound = graph.nodes.find(game.id);
+        kFound != graph.nodes.end())
+    {
+        // Most changes are to ratings and release dates
+        const auto* current = graph.hnsw.GetVector(kFound->second);
+        if (std::equal(kVector.begin(), kVector.end(), current))
+            return;
+
+        graph.stale[kFound->second] = true;
+        ++graph.stale_count;
+        graph.nodes.erase(kFound);
+    }
+
+    // Nothing to find the game by
+    if (kEmpty)
+        return;
+
+    const auto kNode = graph.hnsw.Add(kVector.data());
+    graph.ids.push_back(game.id);
+    graph.stale.push_back(false);
+    graph.nodes.emplace(game.id, kNode);
+}
+
+template <typename Visit>
+bool SemanticIndex::Scan(const pg::IGameRepository& repository, Visit visit)
+{
+    return ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGames(
+                after, userver::storages::postgres::TimePointWithoutTz{},
+                batch);
+        },
+        settings_.scan_batch,
+        [&visit](const pg::IGameRepository::GamesPostgres& games) {
+            for (std::size_t i = 0; i < games.size(); ++i)
+            {
+                visit(games[i]);
+                if ((i + 1) % kYieldEvery == 0)
+                    userver::engine::Yield();
+            }
+        });
+}
+
+bool SemanticIndex::Rebuild(const pg::IGameRepository& repository)
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    // Vectors are weighted by the frequencies of the whole catalog, so
+    // they are counted before anything is embedded
+    auto graph = std::make_unique<Graph>(settings_);
+    const auto kCounted = Scan(repository, [&](const auto& game) {
+        graph->embedder.AddDocument(Tokenize(game));
+    });
+    if (!kCounted)
+        return false;
+
+    graph->hnsw.Reserve(graph->embedder.GetDocumentCount());
+    const auto kEmbedded =
+        Scan(repository, [&](const auto& game) { Set(*graph, game); });
+    if (!kEmbedded)
+        return false;
+
+    const auto kGames = graph->nodes.size();
+    const auto kStaleNodes = graph->stale_count;
+    {
+        std::lock_guard lock(mutex_);
+        graph_ = std::move(graph);
+    }
+    stats_.games = static_cast<std::int64_t>(kGames);
+    stats_.stale_nodes = static_cast<std::int64_t>(kStaleNodes);
+
+    LOG_INFO() << "Semantic index is rebuilt with " << kGames << " games in "
+               << std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::steady_clock::now() - kStarted)
+                      .count()
+               << "s";
+    return true;
+}
+
+void SemanticIndex::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!graph_)
+        return;
+
+    for (const auto& change : changes)
+        Set(*graph_, change.game);
+    stats_.games = static_cast<std::int64_t>(graph_->nodes.size());
+    stats_.stale_nodes = static_cast<std::int64_t>(graph_->stale_count);
+}
+
+bool SemanticIndex::IsRebuildRequested() const
+{
+    return 4 * stats_.stale_nodes.load() > stats_.games.load();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SemanticIndex& index)
+{
+    const auto& stats = index.GetStatistics();
+
+    writer["ready"] = index.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["stale-nodes"] = stats.stale_nodes.load();
+    writer["memory-bytes"] = index.GetMemoryBytes();
+
+    writer["searching"] = stats.searching;
+}
+
+} // namespace indexes
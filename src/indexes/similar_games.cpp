@@ -0,0 +1,275 @@
+// project headers
+#include <indexes/similar_games.hpp>
+
+// std
+#include <algorithm>
+#include <bitset>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+namespace {
+
+// First word and number of words of every kind in a row
+constexpr std::array<std::size_t, 3> kFirstWord{ 0, 1, 2 };
+constexpr std::array<std::size_t, 3> kWordCount{ 1, 1, 6 };
+
+constexpr std::size_t kBitsPerWord = 64;
+
+std::uint32_t CountBits(std::uint64_t word)
+{
+    return static_cast<std::uint32_t>(std::bitset<kBitsPerWord>(word).count());
+}
+
+// Weighted Jaccard of two rows. The loops have fixed trip counts and no
+// branches, so they are unrolled into straight popcounts
+double Score(const SimilarGamesIndex::Row& lhs,
+             const SimilarGamesIndex::Row& rhs,
+             const std::array<double, SimilarGamesIndex::kRowWords>& weights)
+{
+    std::array<std::uint32_t, SimilarGamesIndex::kRowWords> common{};
+    std::array<std::uint32_t, SimilarGamesIndex::kRowWords> total{};
+
+    for (std::size_t i = 0; i < SimilarGamesIndex::kRowWords; ++i)
+    {
+        common[i] = CountBits(lhs[i] & rhs[i]);
+        total[i] = CountBits(lhs[i] | rhs[i]);
+    }
+
+    double weighted_common = 0.0;
+    double weighted_total = 0.0;
+    for (std::size_t i = 0; i < SimilarGamesIndex::kRowWords; ++i)
+    {
+        weighted_common += weights[i] * common[i];
+        weighted_total += weights[i] * total[i];
+    }
+
+    return weighted_total > 0.0 ? weighted_common / weighted_total : 0.0;
+}
+
+std::array<double, SimilarGamesIndex::kRowWords>
+MakeWeights(const SimilarGamesSettings& settings)
+{
+    const std::array<double, 3> kByKind{ settings.genre_weight,
+                                         settings.theme_weight,
+                                         settings.platform_weight };
+
+    std::array<double, SimilarGamesIndex::kRowWords> weights{};
+    for (std::size_t kind = 0; kind < kByKind.size(); ++kind)
+        for (std::size_t i = 0; i < kWordCount[kind]; ++i)
+            weights[kFirstWord[kind] + i] = kByKind[kind];
+
+    return weights;
+}
+
+} // namespace
+
+SimilarGamesIndex::SimilarGamesIndex(SimilarGamesSettings settings)
+    : settings_(settings), weights_(MakeWeights(settings))
+{}
+
+std::optional<std::vector<SimilarGame>>
+SimilarGamesIndex::FindSimilar(const boost::uuids::uuid& id,
+                               std::size_t limit) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    // Min-heap of the best matches so far, ties go to the earlier row
+    using Match = std::pair<double, std::size_t>;
+    const auto kBetter = [](const Match& lhs, const Match& rhs) {
+        return lhs.first != rhs.first ? lhs.first > rhs.first
+                                      : lhs.second < rhs.second;
+    };
+    std::vector<Match> best;
+    best.reserve(limit + 1);
+
+    std::vector<SimilarGame> similar;
+    {
+        std::shared_lock lock(mutex_);
+
+        if (!ready_)
+            return std::nullopt;
+
+        const auto kPosition = matrix_.positions.find(id);
+        if (kPosition == matrix_.positions.end())
+            return std::nullopt;
+
+        const auto kQuery = matrix_.rows[kPosition->second];
+        const auto kRows = matrix_.rows.size();
+
+        for (std::size_t i = 0; i < kRows && limit != 0; ++i)
+        {
+            const auto kScore = Score(kQuery, matrix_.rows[i], weights_);
+            if (kScore <= 0.0 || i == kPosition->second)
+                continue;
+
+            if (best.size() == limit && !kBetter({ kScore, i }, best.front()))
+                continue;
+
+            best.emplace_back(kScore, i);
+            std::push_heap(best.begin(), best.end(), kBetter);
+            if (best.size() > limit)
+            {
+                std::pop_heap(best.begin(), best.end(), kBetter);
+                best.pop_back();
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end(), kBetter);
+
+        similar.reserve(best.size());
+        for (const auto& [score, row] : best)
+            similar.push_back(SimilarGame{ matrix_.ids[row], score });
+    }
+
+    stats_.scoring.Account(std::chrono::steady_clock::now() - kStarted);
+    return similar;
+}
+
+void SimilarGamesIndex::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!ready_)
+        return;
+
+    Set(matrix_, game.id, game.genres, game.themes, game.platforms);
+    stats_.games = static_cast<std::int64_t>(matrix_.rows.size());
+}
+
+bool SimilarGamesIndex::Rebuild(const pg::IGameRepository& repository)
+{
+    Matrix matrix;
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [this, &matrix](const std::vector<entities::GameFeatures>& games) {
+            for (const auto& game : games)
+                Set(matrix, game.id, game.genres, game.themes, game.platforms);
+        });
+    if (!kScanned)
+        return false;
+
+    const auto kGames = matrix.rows.size();
+    {
+        std::lock_guard lock(mutex_);
+        matrix_ = std::move(matrix);
+        ready_ = true;
+    }
+    stats_.games = static_cast<std::int64_t>(kGames);
+
+    LOG_INFO() << "Similar games index is rebuilt with " << kGames
+               << " games";
+    return true;
+}
+
+void SimilarGamesIndex::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    for (const auto& change : changes)
+        Set(matrix_, change.game.id, change.game.genres, change.game.themes,
+            change.game.platforms);
+    stats_.games = static_cast<std::int64_t>(matrix_.rows.size());
+}
+
+bool SimilarGamesIndex::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return ready_;
+}
+
+const SimilarGamesSettings& SimilarGamesIndex::GetSettings() const
+{
+    return settings_;
+}
+
+const SimilarGamesStatistics& SimilarGamesIndex::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t SimilarGamesIndex::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+    return matrix_.rows.capacity() * sizeof(Row) +
+           matrix_.ids.capacity() * sizeof(boost::uuids::uuid);
+}
+
+void SimilarGamesIndex::Set(Matrix& matrix, const boost::uuids::uuid& id,
+                            const std::vector<std::string>& genres,
+                            const std::vector<std::string>& themes,
+                            const std::vector<std::string>& platforms)
+{
+    Row row{};
+    SetBits(matrix, row, Kind::kGenre, genres);
+    SetBits(matrix, row, Kind::kTheme, themes);
+    SetBits(matrix, row, Kind::kPlatform, platforms);
+
+    const auto [kPosition, kInserted] =
+        matrix.positions.emplace(id, matrix.rows.size());
+    if (!kInserted)
+    {
+        matrix.rows[kPosition->second] = row;
+        return;
+    }
+
+    matrix.rows.push_back(row);
+    matrix.ids.push_back(id);
+}
+
+// Values get bits in the order they are first seen. Once the bits of a
+// kind run out new values are left out, which only makes the score coarser
+void SimilarGamesIndex::SetBits(Matrix& matrix, Row& row, Kind kind,
+                                const std::vector<std::string>& values)
+{
+    const auto kKind = static_cast<std::size_t>(kind);
+    const auto kCapacity = kWordCount[kKind] * kBitsPerWord;
+    auto& bits = matrix.bits[kKind];
+
+    for (const auto& value : values)
+    {
+        auto found = bits.find(value);
+        if (found == bits.end())
+        {
+            if (bits.size() == kCapacity)
+            {
+                ++stats_.dropped_values;
+                continue;
+            }
+            found = bits.emplace(value, bits.size()).first;
+        }
+
+        const auto kBit = found->second;
+        row[kFirstWord[kKind] + kBit / kBitsPerWord] |=
+            std::uint64_t{ 1 } << (kBit % kBitsPerWord);
+    }
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SimilarGamesIndex& index)
+{
+    const auto& stats = index.GetStatistics();
+
+    writer["ready"] = index.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["memory-bytes"] = index.GetMemoryBytes();
+
+    writer["scoring"] = stats.scoring;
+    writer["dropped-values"] = stats.dropped_values;
+}
+
+} // namespace indexes
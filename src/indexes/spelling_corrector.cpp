@@ -0,0 +1,113 @@
+// project headers
+#include <indexes/spelling_corrector.hpp>
+#include <tools/utils.hpp>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+SpellingCorrector::SpellingCorrector(SpellingCorrectorSettings settings)
+    : settings_(settings)
+{}
+
+std::optional<std::string>
+SpellingCorrector::CorrectQuery(std::string_view normalized) const
+{
+    const auto kDictionary = GetCurrent();
+    if (!kDictionary)
+        return std::nullopt;
+
+    const auto kStarted = std::chrono::steady_clock::now();
+    auto corrected = kDictionary->CorrectQuery(normalized);
+    stats_.correcting.Account(std::chrono::steady_clock::now() - kStarted);
+
+    if (corrected)
+        ++stats_.corrections;
+    return corrected;
+}
+
+void SpellingCorrector::AccountHit()
+{
+    ++stats_.hits;
+}
+
+bool SpellingCorrector::Rebuild(const pg::IGameRepository& repository)
+{
+    auto dictionary = std::make_shared<SpellingDictionary>(
+        settings_.max_distance, settings_.prefix_length);
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [&dictionary](const std::vector<entities::GameFeatures>& games) {
+            for (const auto& game : games)
+            {
+                const auto kName = utils::NormalizeQuery(game.name);
+                std::size_t begin = 0;
+                while (begin < kName.size())
+                {
+                    auto end = kName.find(' ', begin);
+                    if (end == std::string::npos)
+                        end = kName.size();
+
+                    dictionary->Add(
+                        std::string_view{ kName }.substr(begin, end - begin));
+                    begin = end + 1;
+                }
+            }
+        });
+    if (!kScanned)
+        return false;
+
+    dictionary->Build(settings_.max_words);
+
+    stats_.words = static_cast<std::int64_t>(dictionary->GetWordCount());
+    stats_.memory_bytes =
+        static_cast<std::int64_t>(dictionary->GetMemoryBytes());
+    current_.Assign(std::move(dictionary));
+
+    LOG_INFO() << "Spelling dictionary is rebuilt with " << stats_.words.load()
+               << " words";
+    return true;
+}
+
+void SpellingCorrector::Apply(const std::vector<feed::Change>&)
+{}
+
+bool SpellingCorrector::IsReady() const
+{
+    return GetCurrent() != nullptr;
+}
+
+const SpellingCorrectorSettings& SpellingCorrector::GetSettings() const
+{
+    return settings_;
+}
+
+const SpellingCorrectorStatistics& SpellingCorrector::GetStatistics() const
+{
+    return stats_;
+}
+
+SpellingCorrector::DictionaryPtr SpellingCorrector::GetCurrent() const
+{
+    return *current_.Read();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SpellingCorrector& corrector)
+{
+    const auto& stats = corrector.GetStatistics();
+
+    writer["ready"] = corrector.IsReady() ? 1 : 0;
+    writer["words"] = stats.words.load();
+    writer["memory-bytes"] = stats.memory_bytes.load();
+
+    writer["correcting"] = stats.correcting;
+    writer["corrections"] = stats.corrections;
+    writer["hits"] = stats.hits;
+}
+
+} // namespace indexes
@@ -0,0 +1,347 @@
+// project headers
+#include <indexes/spelling_dictionary.hpp>
+
+// std
+#include <algorithm>
+#include <array>
+#include <cctype>
+
+namespace indexes {
+
+namespace {
+
+std::uint32_t Hash(std::string_view value)
+{
+    // 32-bit FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (const char kChar : value)
+    {
+        hash ^= static_cast<unsigned char>(kChar);
+        hash *= 16777619u;
+    }
+
+    // FNV leaves the upper bits of short strings poorly mixed, and buckets
+    // are picked by them
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+std::uint32_t GetBucket(std::uint32_t hash, std::uint32_t bits)
+{
+    return bits == 0 ? 0 : hash >> (32 - bits);
+}
+
+bool HasDigits(std::string_view word)
+{
+    return std::any_of(word.begin(), word.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
+}
+
+} // namespace
+
+SpellingDictionary::SpellingDictionary(std::size_t max_distance,
+                                       std::size_t prefix_length)
+    : max_distance_(max_distance),
+      prefix_length_(std::max(prefix_length, max_distance + 1))
+{}
+
+void SpellingDictionary::Add(std::string_view word)
+{
+    if (word.size() < kMinWordLength || HasDigits(word))
+        return;
+
+    ++counts_[std::string{ word }];
+}
+
+void SpellingDictionary::Build(std::size_t max_words)
+{
+    std::vector<std::pair<std::string, std::uint32_t>> words(
+        std::make_move_iterator(counts_.begin()),
+        std::make_move_iterator(counts_.end()));
+    counts_ = {};
+
+    // Most frequent first, then alphabetically so builds are reproducible
+    const auto kMoreFrequent = [](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second
+                                        : lhs.first < rhs.first;
+    };
+    if (words.size() > max_words)
+    {
+        std::nth_element(words.begin(), words.begin() + max_words,
+                         words.end(), kMoreFrequent);
+        words.resize(max_words);
+    }
+    std::sort(words.begin(), words.end(), kMoreFrequent);
+
+    words_.clear();
+    offsets_.assign(1, 0);
+    frequencies_.clear();
+    deletes_.clear();
+
+    for (std::uint32_t word = 0; word < words.size(); ++word)
+    {
+        const auto& [kWord, kCount] = words[word];
+
+        words_ += kWord;
+        offsets_.push_back(static_cast<std::uint32_t>(words_.size()));
+        frequencies_.push_back(kCount);
+
+        // Short words are only looked up by short queries, which are
+        // corrected by one edit
+        const auto kPrefix =
+            std::string_view{ kWord }.substr(0, prefix_length_);
+        for (const auto& deleted :
+             MakeDeletes(kPrefix, GetMaxDistance(kWord)))
+            deletes_.emplace_back(Hash(deleted), word);
+    }
+
+    std::sort(deletes_.begin(), deletes_.end());
+
+    // About two deletes per bucket
+    bucket_bits_ = 0;
+    while (bucket_bits_ < 30 && (std::size_t{ 2 } << bucket_bits_) <
+                                    deletes_.size())
+        ++bucket_bits_;
+
+    buckets_.assign((std::size_t{ 1 } << bucket_bits_) + 1, 0);
+    for (const auto& [hash, word] : deletes_)
+        ++buckets_[GetBucket(hash, bucket_bits_) + 1];
+    for (std::size_t i = 1; i < buckets_.size(); ++i)
+        buckets_[i] += buckets_[i - 1];
+
+    words_.shrink_to_fit();
+    offsets_.shrink_to_fit();
+    frequencies_.shrink_to_fit();
+    deletes_.shrink_to_fit();
+}
+
+std::optional<std::string_view>
+SpellingDictionary::Correct(std::string_view word) const
+{
+    if (buckets_.empty())
+        return std::nullopt;
+
+    const auto kMaxDistance = GetMaxDistance(word);
+    const auto kPrefix = word.substr(0, prefix_length_);
+
+    // A word at distance d shares a delete of at most d characters with
+    // the query, so once the closest word so far is d away, rounds
+    // deleting more than d characters can't find one as close
+    std::optional<std::uint32_t> best;
+    auto best_distance = kMaxDistance + 1;
+    std::vector<std::uint32_t> checked;
+    std::vector<std::string> round{ std::string{ kPrefix } };
+
+    for (std::size_t deleted = 0;
+         deleted <= kMaxDistance && deleted <= best_distance; ++deleted)
+    {
+        if (deleted != 0)
+            round = DeleteOne(round);
+
+        std::vector<std::uint32_t> candidates;
+        for (const auto& key : round)
+        {
+            const auto kHash = Hash(key);
+            const auto kBucket = GetBucket(kHash, bucket_bits_);
+
+            for (auto i = buckets_[kBucket]; i < buckets_[kBucket + 1]; ++i)
+            {
+                const auto& [kDeleteHash, kWord] = deletes_[i];
+                if (kDeleteHash != kHash)
+                    continue;
+
+                const auto kLength = offsets_[kWord + 1] - offsets_[kWord];
+                if (std::max<std::size_t>(kLength, word.size()) -
+                        std::min<std::size_t>(kLength, word.size()) <=
+                    kMaxDistance)
+                    candidates.push_back(kWord);
+            }
+        }
+
+        // A word shares many deletes with the query, it is checked once
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+
+        for (const auto kWord : candidates)
+        {
+            if (std::binary_search(checked.begin(), checked.end(), kWord))
+                continue;
+
+            const auto kDistance =
+                GetEditDistance(word, GetWord(kWord), best_distance);
+
+            // Words are stored most frequent first
+            if (kDistance < best_distance ||
+                (kDistance == best_distance && best && kWord < *best))
+            {
+                best = kWord;
+                best_distance = kDistance;
+            }
+        }
+
+        checked.insert(checked.end(), candidates.begin(), candidates.end());
+        std::sort(checked.begin(), checked.end());
+    }
+
+    if (!best)
+        return std::nullopt;
+    return GetWord(*best);
+}
+
+std::optional<std::string>
+SpellingDictionary::CorrectQuery(std::string_view query) const
+{
+    std::string corrected;
+    corrected.reserve(query.size());
+    bool changed = false;
+
+    std::size_t begin = 0;
+    while (begin < query.size())
+    {
+        auto end = query.find(' ', begin);
+        if (end == std::string_view::npos)
+            end = query.size();
+
+        const auto kWord = query.substr(begin, end - begin);
+        std::optional<std::string_view> correction;
+        if (kWord.size() >= kMinWordLength && !HasDigits(kWord))
+            correction = Correct(kWord);
+
+        if (!corrected.empty())
+            corrected.push_back(' ');
+        if (correction && *correction != kWord)
+        {
+            corrected += *correction;
+            changed = true;
+        }
+        else
+            corrected += kWord;
+
+        begin = end + 1;
+    }
+
+    if (!changed)
+        return std::nullopt;
+    return corrected;
+}
+
+std::size_t SpellingDictionary::GetWordCount() const
+{
+    return frequencies_.size();
+}
+
+std::size_t SpellingDictionary::GetMemoryBytes() const
+{
+    return words_.capacity() +
+           offsets_.capacity() * sizeof(std::uint32_t) +
+           frequencies_.capacity() * sizeof(std::uint32_t) +
+           deletes_.capacity() *
+               sizeof(std::pair<std::uint32_t, std::uint32_t>) +
+           buckets_.capacity() * sizeof(std::uint32_t);
+}
+
+std::string_view SpellingDictionary::GetWord(std::uint32_t word) const
+{
+    return std::string_view{ words_ }.substr(
+        offsets_[word], offsets_[word + 1] - offsets_[word]);
+}
+
+std::size_t SpellingDictionary::GetMaxDistance(std::string_view word) const
+{
+    return word.size() <= kShortWordLength ? std::min<std::size_t>(
+                                                 max_distance_, 1)
+                                           : max_distance_;
+}
+
+std::vector<std::string>
+SpellingDictionary::MakeDeletes(std::string_view word, std::size_t distance)
+{
+    std::vector<std::string> round{ std::string{ word } };
+    std::vector<std::string> deletes = round;
+
+    for (std::size_t deleted = 0; deleted < distance; ++deleted)
+    {
+        round = DeleteOne(round);
+        deletes.insert(deletes.end(), round.begin(), round.end());
+    }
+
+    return deletes;
+}
+
+std::vector<std::string>
+SpellingDictionary::DeleteOne(const std::vector<std::string>& words)
+{
+    std::vector<std::string> deletes;
+    for (const auto& word : words)
+    {
+        for (std::size_t position = 0; position < word.size(); ++position)
+        {
+            auto deleted = word;
+            deleted.erase(position, 1);
+            deletes.push_back(std::move(deleted));
+        }
+    }
+
+    std::sort(deletes.begin(), deletes.end());
+    deletes.erase(std::unique(deletes.begin(), deletes.end()), deletes.end());
+    return deletes;
+}
+
+std::size_t GetEditDistance(std::string_view lhs, std::string_view rhs,
+                            std::size_t limit)
+{
+    const auto kRows = lhs.size() + 1;
+    const auto kColumns = rhs.size() + 1;
+
+    // Three rows are enough for transpositions. Words fit on the stack
+    constexpr std::size_t kStackColumns = 64;
+    std::array<std::size_t, 3 * kStackColumns> stack_rows;
+    std::vector<std::size_t> heap_rows;
+    auto* rows = stack_rows.data();
+    if (kColumns > kStackColumns)
+    {
+        heap_rows.resize(3 * kColumns);
+        rows = heap_rows.data();
+    }
+
+    auto* before = rows;
+    auto* previous = rows + kColumns;
+    auto* current = rows + 2 * kColumns;
+    for (std::size_t j = 0; j < kColumns; ++j)
+        previous[j] = j;
+
+    for (std::size_t i = 1; i < kRows; ++i)
+    {
+        current[0] = i;
+        auto row_minimum = current[0];
+
+        for (std::size_t j = 1; j < kColumns; ++j)
+        {
+            const std::size_t kCost = lhs[i - 1] == rhs[j - 1] ? 0 : 1;
+            current[j] = std::min({ previous[j] + 1, current[j - 1] + 1,
+                                    previous[j - 1] + kCost });
+
+            if (i > 1 && j > 1 && lhs[i - 1] == rhs[j - 2] &&
+                lhs[i - 2] == rhs[j - 1])
+                current[j] = std::min(current[j], before[j - 2] + 1);
+
+            row_minimum = std::min(row_minimum, current[j]);
+        }
+
+        // Distances never go down from one row to the next
+        if (row_minimum > limit)
+            return limit + 1;
+
+        // The oldest row is overwritten by the next one
+        std::swap(before, previous);
+        std::swap(previous, current);
+    }
+
+    return std::min(previous[kColumns - 1], limit + 1);
+}
+
+} // namespace indexes
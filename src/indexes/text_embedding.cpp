@@ -0,0 +1,145 @@
+// project headers
+#include <indexes/text_embedding.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace indexes {
+
+namespace {
+
+std::uint32_t Mix(std::uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+std::uint32_t Hash(std::string_view word)
+{
+    // 32-bit FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (const char kChar : word)
+    {
+        hash ^= static_cast<unsigned char>(kChar);
+        hash *= 16777619u;
+    }
+    return Mix(hash);
+}
+
+} // namespace
+
+TextEmbedder::TextEmbedder(std::size_t dimension,
+                           std::size_t frequency_buckets)
+    : dimension_(dimension), frequencies_(std::max<std::size_t>(
+                                 frequency_buckets, 1))
+{}
+
+void TextEmbedder::Tokenize(std::string_view normalized, Tokens& tokens)
+{
+    std::optional<std::uint32_t> previous;
+
+    std::size_t begin = 0;
+    while (begin < normalized.size())
+    {
+        auto end = normalized.find(' ', begin);
+        if (end == std::string_view::npos)
+            end = normalized.size();
+
+        const auto kWord = Hash(normalized.substr(begin, end - begin));
+        tokens.push_back(kWord);
+        if (previous)
+            tokens.push_back(Mix(*previous * 31u + (kWord ^ 0x9e3779b9u)));
+        previous = kWord;
+
+        begin = end + 1;
+    }
+}
+
+void TextEmbedder::AddDocument(const Tokens& tokens)
+{
+    // A token counts once per document
+    auto buckets = tokens;
+    for (auto& token : buckets)
+        token %= frequencies_.size();
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+    for (const auto kBucket : buckets)
+        ++frequencies_[kBucket];
+    ++documents_;
+}
+
+TextEmbedder::Vector TextEmbedder::Embed(const Tokens& tokens) const
+{
+    auto sorted = tokens;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<double> sums(dimension_, 0.0);
+    for (std::size_t begin = 0; begin < sorted.size();)
+    {
+        auto end = begin;
+        while (end < sorted.size() && sorted[end] == sorted[begin])
+            ++end;
+
+        const auto kIdf = GetIdf(sorted[begin]);
+        if (kIdf > 0.0)
+        {
+            const auto kWeight =
+                (1.0 + std::log(static_cast<double>(end - begin))) * kIdf;
+
+            // Another hash than the frequency bucket, so tokens sharing a
+            // bucket there don't share one here
+            const auto kMixed = Mix(sorted[begin] ^ 0x5bd1e995u);
+            const auto kBucket = static_cast<std::size_t>(
+                (std::uint64_t{ kMixed } * dimension_) >> 32);
+            sums[kBucket] += (kMixed & 1u) != 0 ? kWeight : -kWeight;
+        }
+
+        begin = end;
+    }
+
+    double squares = 0.0;
+    for (const auto kSum : sums)
+        squares += kSum * kSum;
+
+    Vector vector(dimension_, 0.0f);
+    if (squares == 0.0)
+        return vector;
+
+    const auto kNorm = std::sqrt(squares);
+    for (std::size_t i = 0; i < dimension_; ++i)
+        vector[i] = static_cast<float>(sums[i] / kNorm);
+    return vector;
+}
+
+std::size_t TextEmbedder::GetDimension() const
+{
+    return dimension_;
+}
+
+std::size_t TextEmbedder::GetDocumentCount() const
+{
+    return documents_;
+}
+
+std::size_t TextEmbedder::GetMemoryBytes() const
+{
+    return frequencies_.capacity() * sizeof(std::uint32_t);
+}
+
+double TextEmbedder::GetIdf(std::uint32_t token) const
+{
+    const auto kFrequency = frequencies_[token % frequencies_.size()];
+    if (kFrequency == 0)
+        return 0.0;
+
+    return std::log((1.0 + documents_) / kFrequency);
+}
+
+} // namespace indexes
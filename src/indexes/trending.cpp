@@ -0,0 +1,346 @@
+// project headers
+#include <indexes/trending.hpp>
+
+// std
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace indexes {
+
+namespace {
+
+// Days since 1970-01-01 of a "YYYY-MM-DD" date, nullopt for "N/A" and
+// anything else
+std::optional<std::int32_t> ParseReleaseDay(std::string_view date)
+{
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-')
+        return std::nullopt;
+
+    const auto kNumber = [&date](std::size_t begin,
+                                 std::size_t size) -> std::optional<int> {
+        int value = 0;
+        for (const char kChar : date.substr(begin, size))
+        {
+            if (!std::isdigit(static_cast<unsigned char>(kChar)))
+                return std::nullopt;
+            value = value * 10 + (kChar - '0');
+        }
+        return value;
+    };
+
+    const auto kYear = kNumber(0, 4);
+    const auto kMonth = kNumber(5, 2);
+    const auto kDay = kNumber(8, 2);
+    if (!kYear || !kMonth || !kDay || *kMonth < 1 || *kMonth > 12 ||
+        *kDay < 1 || *kDay > 31)
+        return std::nullopt;
+
+    // Days from civil by Howard Hinnant, years start in March so that the
+    // leap day is the last one
+    const auto kShiftedYear = *kYear - (*kMonth <= 2 ? 1 : 0);
+    const auto kEra = kShiftedYear / 400;
+    const auto kYearOfEra = kShiftedYear - kEra * 400;
+    const auto kDayOfYear =
+        (153 * (*kMonth + (*kMonth > 2 ? -3 : 9)) + 2) / 5 + *kDay - 1;
+    const auto kDayOfEra = kYearOfEra * 365 + kYearOfEra / 4 -
+                           kYearOfEra / 100 + kDayOfYear;
+    return kEra * 146097 + kDayOfEra - 719468;
+}
+
+} // namespace
+
+TrendingIndex::TrendingIndex(TrendingSettings settings)
+    : settings_(settings), landmark_(Clock::now())
+{}
+
+std::optional<std::vector<boost::uuids::uuid>>
+TrendingIndex::GetTop(std::size_t limit) const
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    std::vector<boost::uuids::uuid> top;
+    {
+        std::shared_lock lock(mutex_);
+        if (!ready_)
+            return std::nullopt;
+
+        const auto kRows = heap_.Top(limit);
+        top.reserve(kRows.size());
+        for (const auto kRow : kRows)
+            top.push_back(games_.rows[kRow].id);
+    }
+
+    stats_.ranking.Account(std::chrono::steady_clock::now() - kStarted);
+    return top;
+}
+
+void TrendingIndex::Upsert(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    // Games saved before the first build are picked up by its catch-up
+    if (!ready_)
+        return;
+
+    const auto kRow = Set(games_, ToFeatures(game), Clock::now());
+    heap_.Set(kRow, GetScore(games_.rows[kRow]));
+    stats_.games = static_cast<std::int64_t>(games_.rows.size());
+}
+
+void TrendingIndex::AccountViews(
+    const std::vector<entities::GameViews>& views)
+{
+    if (!settings_.enabled || views.empty())
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    const auto kWeight =
+        settings_.view_weight * GetForwardWeight(Clock::now());
+    std::int64_t accounted = 0;
+    for (const auto& game : views)
+    {
+        const auto kFound = games_.positions.find(game.id);
+        if (kFound == games_.positions.end())
+            continue;
+
+        AddActivity(kFound->second,
+                    kWeight * static_cast<double>(game.views));
+        accounted += game.views;
+    }
+    stats_.views.Add(userver::utils::statistics::Rate{
+        static_cast<std::uint64_t>(accounted) });
+}
+
+void TrendingIndex::AccountRating(const boost::uuids::uuid& id,
+                                  std::int32_t playhub_rating)
+{
+    if (!settings_.enabled)
+        return;
+
+    std::lock_guard lock(mutex_);
+
+    const auto kFound = games_.positions.find(id);
+    if (kFound == games_.positions.end())
+        return;
+
+    auto& game = games_.rows[kFound->second];
+    if (game.playhub_rating == playhub_rating)
+        return;
+
+    // Catch-up sees the rating unchanged and doesn't count it twice
+    game.base += settings_.playhub_rating_weight *
+                 (playhub_rating - game.playhub_rating);
+    game.playhub_rating = playhub_rating;
+    AddActivity(kFound->second, settings_.rating_change_weight *
+                                    GetForwardWeight(Clock::now()));
+    ++stats_.rating_changes;
+}
+
+bool TrendingIndex::Rebuild(const pg::IGameRepository& repository)
+{
+    Games games;
+    const auto kNow = Clock::now();
+    const auto kScanned = ScanCatalog(
+        [&repository](const std::string& after, std::int32_t batch) {
+            return repository.ScanGameFeatures(after, batch);
+        },
+        settings_.scan_batch,
+        [this, &games, kNow](const std::vector<entities::GameFeatures>& rows) {
+            for (const auto& game : rows)
+                Set(games, game, kNow);
+        });
+    if (!kScanned)
+        return false;
+
+    const auto kGames = games.rows.size();
+    {
+        std::lock_guard lock(mutex_);
+
+        // Activity isn't in Postgres, it's carried over from the previous
+        // rows, which saw every view up to now
+        for (auto& row : games.rows)
+            if (const auto kFound = games_.positions.find(row.id);
+                kFound != games_.positions.end())
+                row.activity = games_.rows[kFound->second].activity;
+
+        games_ = std::move(games);
+        std::vector<double> scores;
+        scores.reserve(games_.rows.size());
+        for (const auto& row : games_.rows)
+            scores.push_back(GetScore(row));
+        heap_.Assign(std::move(scores));
+        ready_ = true;
+    }
+    stats_.games = static_cast<std::int64_t>(kGames);
+
+    LOG_INFO() << "Trending index is rebuilt with " << kGames << " games";
+    return true;
+}
+
+void TrendingIndex::Apply(const std::vector<feed::Change>& changes)
+{
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    const auto kNow = Clock::now();
+    for (const auto& change : changes)
+    {
+        const auto kRow = Set(games_, ToFeatures(change.game), kNow);
+        heap_.Set(kRow, GetScore(games_.rows[kRow]));
+    }
+    stats_.games = static_cast<std::int64_t>(games_.rows.size());
+}
+
+void TrendingIndex::Maintain(const pg::IGameRepository&,
+                             const entities::ChangeCursor&)
+{
+    const auto kNow = std::chrono::steady_clock::now();
+    if (kNow - last_fold_ < settings_.fold_period)
+        return;
+
+    Fold(Clock::now());
+    last_fold_ = kNow;
+}
+
+bool TrendingIndex::IsReady() const
+{
+    std::shared_lock lock(mutex_);
+    return ready_;
+}
+
+const TrendingSettings& TrendingIndex::GetSettings() const
+{
+    return settings_;
+}
+
+const TrendingStatistics& TrendingIndex::GetStatistics() const
+{
+    return stats_;
+}
+
+std::size_t TrendingIndex::GetMemoryBytes() const
+{
+    std::shared_lock lock(mutex_);
+    return games_.rows.capacity() * sizeof(Game) +
+           games_.positions.size() *
+               (sizeof(boost::uuids::uuid) + sizeof(std::uint32_t) +
+                sizeof(void*)) +
+           heap_.GetMemoryBytes();
+}
+
+double TrendingIndex::GetForwardWeight(Clock::time_point now) const
+{
+    const auto kElapsed =
+        std::chrono::duration<double>(now - landmark_).count();
+    return std::exp2(
+        kElapsed /
+        std::chrono::duration<double>(settings_.half_life).count());
+}
+
+double TrendingIndex::GetScore(const Game& game) const
+{
+    auto score = game.base + game.activity;
+    if (game.release_day == kNoRelease)
+        return score;
+
+    const auto kSinceRelease =
+        std::chrono::duration<double>(
+            landmark_.time_since_epoch() -
+            std::chrono::hours{ 24 } * game.release_day)
+            .count();
+    if (kSinceRelease >= 0.0)
+        score += settings_.release_weight *
+                 std::exp2(-kSinceRelease /
+                           std::chrono::duration<double>(settings_.half_life)
+                               .count());
+    return score;
+}
+
+std::uint32_t TrendingIndex::Set(Games& games,
+                                 const entities::GameFeatures& game,
+                                 Clock::time_point now) const
+{
+    const auto [kPosition, kInserted] = games.positions.emplace(
+        game.id, static_cast<std::uint32_t>(games.rows.size()));
+    if (kInserted)
+        games.rows.push_back(Game{ game.id });
+
+    auto& row = games.rows[kPosition->second];
+    if (!kInserted && row.playhub_rating != game.playhub_rating)
+    {
+        row.activity +=
+            settings_.rating_change_weight * GetForwardWeight(now);
+        ++stats_.rating_changes;
+    }
+
+    row.base = settings_.hypes_weight *
+                   std::log2(1.0 + std::max(game.hypes, 0)) +
+               settings_.igdb_rating_weight * game.igdb_rating +
+               settings_.playhub_rating_weight * game.playhub_rating;
+    row.playhub_rating = game.playhub_rating;
+    row.release_day = ParseReleaseDay(game.firstReleaseDate)
+                          .value_or(kNoRelease);
+    return kPosition->second;
+}
+
+void TrendingIndex::AddActivity(std::uint32_t row, double weight)
+{
+    auto& game = games_.rows[row];
+    game.activity += weight;
+    heap_.Set(row, GetScore(game));
+}
+
+// Every score decays by the same factor but the base doesn't, so the
+// order changes and the heap is rebuilt rather than patched
+void TrendingIndex::Fold(Clock::time_point now)
+{
+    const auto kStarted = std::chrono::steady_clock::now();
+
+    std::lock_guard lock(mutex_);
+    if (!ready_)
+        return;
+
+    const auto kDecay = 1.0 / GetForwardWeight(now);
+    landmark_ = now;
+
+    std::vector<double> scores(games_.rows.size());
+    for (std::size_t row = 0; row < games_.rows.size(); ++row)
+    {
+        games_.rows[row].activity *= kDecay;
+        scores[row] = GetScore(games_.rows[row]);
+    }
+    heap_.Assign(std::move(scores));
+
+    stats_.folding.Account(std::chrono::steady_clock::now() - kStarted);
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const TrendingIndex& index)
+{
+    const auto& stats = index.GetStatistics();
+
+    writer["ready"] = index.IsReady() ? 1 : 0;
+    writer["games"] = stats.games.load();
+    writer["memory-bytes"] = index.GetMemoryBytes();
+
+    writer["ranking"] = stats.ranking;
+    writer["folding"] = stats.folding;
+    writer["views"] = stats.views;
+    writer["rating-changes"] = stats.rating_changes;
+}
+
+} // namespace indexes
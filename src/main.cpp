@@ -5,6 +5,7 @@
 #include <userver/components/minimal_server_component_list.hpp>
 #include <userver/congestion_control/component.hpp>
 #include <userver/server/handlers/ping.hpp>
+#include <userver/server/handlers/server_monitor.hpp>
 #include <userver/server/handlers/tests_control.hpp>
 #include <userver/testsuite/testsuite_support.hpp>
 
@@ -16,11 +17,14 @@
 #include <userver/utils/daemon_run.hpp>
 
 #include <handlers/game_grpc.hpp>
+#include <managers/igdb_component.hpp>
+#include <refresh/refresh_scheduler.hpp>
 
 int main(int argc, char* argv[]) 
 {
     auto component_list = userver::components::MinimalServerComponentList()
         .Append<userver::server::handlers::Ping>()
+        .Append<userver::server::handlers::ServerMonitor>()
         .Append<userver::components::TestsuiteSupport>()
         .Append<userver::components::HttpClient>()
         .Append<userver::components::HttpClientCore>()
@@ -29,7 +33,9 @@ int main(int argc, char* argv[])
         .Append<userver::server::handlers::TestsControl>()
         .AppendComponentList(userver::ugrpc::server::MinimalComponentList())
         .Append<userver::components::Postgres>("playhub-games-db")
+        .Append<igdb::IgdbComponent>()
         .Append<game_service::GameServiceComponent>()
+        .Append<refresh::RefreshSchedulerComponent>()
 
     ;
 
@@ -0,0 +1,279 @@
+// project headers
+#include <managers/circuit_breaker.hpp>
+
+// std
+#include <algorithm>
+#include <fmt/format.h>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace igdb {
+
+std::string_view ToString(BreakerState state)
+{
+    switch (state)
+    {
+    case BreakerState::kClosed:
+        return "closed";
+    case BreakerState::kHalfOpen:
+        return "half-open";
+    case BreakerState::kOpen:
+        return "open";
+    case BreakerState::kCount:
+        break;
+    }
+    return "unknown";
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BreakerStatistics& stats)
+{
+    const auto kCurrent = stats.state.load();
+
+    for (std::size_t i = 0; i < kBreakerStateCount; ++i)
+    {
+        const auto kState = static_cast<BreakerState>(i);
+        writer["state"].ValueWithLabels(kState == kCurrent ? 1 : 0,
+                                        { { "state", ToString(kState) } });
+        writer["transitions"].ValueWithLabels(
+            stats.transitions[i], { { "state", ToString(kState) } });
+    }
+
+    writer["successes"] = stats.successes;
+    writer["failures"] = stats.failures;
+    writer["slow-calls"] = stats.slow_calls;
+    writer["rejected"] = stats.rejected;
+}
+
+CircuitBreaker::CircuitBreaker(IIGDBManager& manager,
+                               BreakerSettings settings)
+    : manager_(manager), settings_(settings),
+      bucket_width_(std::max<Clock::duration>(
+          settings_.window / kBucketCount, std::chrono::milliseconds{ 1 }))
+{}
+
+IIGDBManager::GamesInfo CircuitBreaker::SearchGames(std::string_view query,
+                                                    std::int32_t limit)
+{
+    return Execute("SearchGames",
+                   [&] { return manager_.SearchGames(query, limit); });
+}
+
+IIGDBManager::GamesInfo CircuitBreaker::GetGameBySlug(std::string_view slug)
+{
+    return Execute("GetGameBySlug",
+                   [&] { return manager_.GetGameBySlug(slug); });
+}
+
+IIGDBManager::GamesInfo
+CircuitBreaker::GetGamesByGenre(std::string_view genre, std::int32_t limit)
+{
+    return Execute("GetGamesByGenre",
+                   [&] { return manager_.GetGamesByGenre(genre, limit); });
+}
+
+IIGDBManager::GamesInfo CircuitBreaker::GetUpcomingGames(std::int32_t limit)
+{
+    return Execute("GetUpcomingGames",
+                   [&] { return manager_.GetUpcomingGames(limit); });
+}
+
+IIGDBManager::GamesInfo
+CircuitBreaker::GetGamesByIds(const std::vector<std::string>& ids)
+{
+    return Execute("GetGamesByIds",
+                   [&] { return manager_.GetGamesByIds(ids); });
+}
+
+bool CircuitBreaker::IsAvailable() const
+{
+    if (!settings_.enabled)
+        return true;
+
+    const auto state = state_.Lock();
+    switch (state->state)
+    {
+    case BreakerState::kClosed:
+        return true;
+    case BreakerState::kHalfOpen:
+        return state->probes_in_flight < settings_.half_open_probes;
+    case BreakerState::kOpen:
+    case BreakerState::kCount:
+        break;
+    }
+    return IsOpenExpired(*state);
+}
+
+BreakerState CircuitBreaker::GetState() const
+{
+    return stats_.state.load();
+}
+
+const BreakerStatistics& CircuitBreaker::GetStatistics() const
+{
+    return stats_;
+}
+
+template <typename Call>
+IIGDBManager::GamesInfo CircuitBreaker::Execute(std::string_view operation,
+                                                Call&& call)
+{
+    const auto kPass = settings_.enabled ? TryPass() : Pass::kCall;
+    if (kPass == Pass::kRejected)
+    {
+        ++stats_.rejected;
+        throw IgdbError(
+            fmt::format("{} skipped, IGDB circuit is open", operation));
+    }
+
+    const auto kStart = Clock::now();
+
+    try
+    {
+        auto games = call();
+        Record(kPass, Outcome::kSuccess, Clock::now() - kStart);
+        return games;
+    }
+    catch (const IgdbAbandoned&)
+    {
+        Record(kPass, Outcome::kAbandoned, Clock::now() - kStart);
+        throw;
+    }
+    // IGDB did answer, only the request was bad
+    catch (const IgdbRejected&)
+    {
+        Record(kPass, Outcome::kSuccess, Clock::now() - kStart);
+        throw;
+    }
+    catch (const std::exception&)
+    {
+        Record(kPass, Outcome::kFailure, Clock::now() - kStart);
+        throw;
+    }
+}
+
+CircuitBreaker::Pass CircuitBreaker::TryPass()
+{
+    auto state = state_.Lock();
+
+    if (state->state == BreakerState::kOpen)
+    {
+        if (!IsOpenExpired(*state))
+            return Pass::kRejected;
+
+        TransitionTo(*state, BreakerState::kHalfOpen);
+    }
+
+    if (state->state == BreakerState::kClosed)
+        return Pass::kCall;
+
+    if (state->probes_in_flight >= settings_.half_open_probes)
+        return Pass::kRejected;
+
+    ++state->probes_in_flight;
+    return Pass::kProbe;
+}
+
+void CircuitBreaker::Record(Pass pass, Outcome outcome,
+                            Clock::duration latency)
+{
+    const bool kSlow = latency > settings_.slow_call;
+
+    if (outcome == Outcome::kFailure)
+        ++stats_.failures;
+    else if (outcome == Outcome::kSuccess)
+        ++stats_.successes;
+
+    if (outcome == Outcome::kSuccess && kSlow)
+        ++stats_.slow_calls;
+
+    if (!settings_.enabled)
+        return;
+
+    const bool kFailed =
+        outcome == Outcome::kFailure || (outcome == Outcome::kSuccess && kSlow);
+
+    auto state = state_.Lock();
+
+    if (pass == Pass::kProbe)
+    {
+        if (state->probes_in_flight > 0)
+            --state->probes_in_flight;
+
+        // Another probe may have decided already
+        if (state->state != BreakerState::kHalfOpen ||
+            outcome == Outcome::kAbandoned)
+            return;
+
+        if (kFailed)
+        {
+            TransitionTo(*state, BreakerState::kOpen);
+            return;
+        }
+
+        if (++state->probe_successes >= settings_.half_open_probes)
+            TransitionTo(*state, BreakerState::kClosed);
+        return;
+    }
+
+    if (state->state != BreakerState::kClosed ||
+        outcome == Outcome::kAbandoned)
+        return;
+
+    RecordCall(*state, kFailed);
+}
+
+void CircuitBreaker::RecordCall(State& state, bool failed)
+{
+    const auto kEpoch = Clock::now().time_since_epoch() / bucket_width_;
+
+    auto& bucket = state.buckets[kEpoch % kBucketCount];
+    if (bucket.epoch != kEpoch)
+        bucket = Bucket{ kEpoch, 0, 0 };
+
+    ++bucket.calls;
+    if (failed)
+        ++bucket.failures;
+
+    std::size_t calls = 0;
+    std::size_t failures = 0;
+    for (const auto& item : state.buckets)
+    {
+        if (kEpoch - item.epoch >= static_cast<std::int64_t>(kBucketCount))
+            continue;
+
+        calls += item.calls;
+        failures += item.failures;
+    }
+
+    if (calls >= settings_.min_calls &&
+        static_cast<double>(failures) >=
+            settings_.failure_ratio * static_cast<double>(calls))
+        TransitionTo(state, BreakerState::kOpen);
+}
+
+void CircuitBreaker::TransitionTo(State& state, BreakerState next)
+{
+    LOG_WARNING() << "IGDB circuit " << ToString(state.state) << " -> "
+                  << ToString(next);
+
+    state.state = next;
+    state.probes_in_flight = 0;
+    state.probe_successes = 0;
+
+    if (next == BreakerState::kOpen)
+        state.opened_at = Clock::now();
+    if (next == BreakerState::kClosed)
+        state.buckets = {};
+
+    stats_.state = next;
+    ++stats_.transitions[static_cast<std::size_t>(next)];
+}
+
+bool CircuitBreaker::IsOpenExpired(const State& state) const
+{
+    return Clock::now() - state.opened_at >= settings_.open_duration;
+}
+
+} // namespace igdb
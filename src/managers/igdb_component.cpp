@@ -0,0 +1,101 @@
+// project headers
+#include <managers/igdb_component.hpp>
+
+// userver
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace igdb {
+
+IgdbComponent::IgdbComponent(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : userver::components::ComponentBase(config, context),
+      breaker_(manager_, ParseSettings(config))
+{
+    auto& storage =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage();
+    statistics_entry_ = storage.RegisterWriter(
+        "game-service.igdb",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = manager_.GetStatistics();
+            writer["circuit-breaker"] = breaker_.GetStatistics();
+        });
+}
+
+IgdbComponent::~IgdbComponent()
+{
+    statistics_entry_.Unregister();
+}
+
+IIGDBManager& IgdbComponent::GetManager()
+{
+    return breaker_;
+}
+
+BreakerSettings IgdbComponent::ParseSettings(
+    const userver::components::ComponentConfig& config)
+{
+    BreakerSettings settings;
+
+    const auto kBreaker = config["circuit-breaker"];
+    settings.enabled = kBreaker["enabled"].As<bool>(settings.enabled);
+    settings.window =
+        kBreaker["window"].As<std::chrono::milliseconds>(settings.window);
+    settings.min_calls =
+        kBreaker["min-calls"].As<std::size_t>(settings.min_calls);
+    settings.failure_ratio =
+        kBreaker["failure-ratio"].As<double>(settings.failure_ratio);
+    settings.slow_call =
+        kBreaker["slow-call"].As<std::chrono::milliseconds>(settings.slow_call);
+    settings.open_duration =
+        kBreaker["open-duration"].As<std::chrono::milliseconds>(
+            settings.open_duration);
+    settings.half_open_probes =
+        kBreaker["half-open-probes"].As<std::size_t>(settings.half_open_probes);
+
+    return settings;
+}
+
+userver::yaml_config::Schema IgdbComponent::GetStaticConfigSchema()
+{
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(
+        R"(
+            type: object
+            description: IGDB API client
+            additionalProperties: false
+            properties:
+                circuit-breaker:
+                    type: object
+                    description: stops calling IGDB while it keeps failing
+                    additionalProperties: false
+                    properties:
+                        enabled:
+                            type: boolean
+                            description: whether the breaker may open
+                        window:
+                            type: string
+                            description: period the error rate is computed over
+                        min-calls:
+                            type: integer
+                            description: calls in the window needed to open
+                        failure-ratio:
+                            type: number
+                            description: share of failed calls that opens
+                        slow-call:
+                            type: string
+                            description: latency that counts as a failure
+                        open-duration:
+                            type: string
+                            description: time to stay open before probing
+                        half-open-probes:
+                            type: integer
+                            description: probes that must succeed to close
+        )");
+}
+
+} // namespace igdb
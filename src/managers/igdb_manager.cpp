@@ -1,14 +1,137 @@
 // project headers
 #include <managers/igdb_manager.hpp>
 #include <parser/json_parser.hpp>
+#include <tools/deadline.hpp>
 #include <tools/utils.hpp>
 
 // std
+#include <algorithm>
 #include <cstdlib>
+#include <stdexcept>
 #include <fmt/format.h>
+#include <fmt/ranges.h>
+
+// userver
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/tracing/span.hpp>
 
 namespace igdb {
 
+namespace {
+
+constexpr std::string_view kIgdbHost = "api.igdb.com";
+constexpr std::string_view kTwitchHost = "id.twitch.tv";
+constexpr std::string_view kHttpsPort = "443";
+
+// Measures consecutive stages of a single request
+class StageClock final
+{
+public:
+    explicit StageClock(userver::tracing::Span& span)
+        : span_(span), last_(std::chrono::steady_clock::now())
+    {}
+
+    void Lap(metrics::LatencyHistogram& histogram, std::string tag)
+    {
+        const auto kNow = std::chrono::steady_clock::now();
+        const auto kElapsed = kNow - last_;
+        last_ = kNow;
+
+        histogram.Account(kElapsed);
+        span_.AddTag(std::move(tag),
+                     std::chrono::duration<double, std::milli>(kElapsed)
+                         .count());
+    }
+
+private:
+    userver::tracing::Span& span_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+class RequestAbandoned final : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Upper bound for requests made outside of a call, e.g. by background
+// refreshes
+constexpr std::chrono::seconds kRequestTimeout{ 10 };
+
+// How often a running request checks for cancellation
+constexpr std::chrono::milliseconds kPollInterval{ 20 };
+
+userver::engine::Deadline GetRequestDeadline()
+{
+    const auto kCallDeadline = utils::GetCallDeadline();
+    const auto kTimeout =
+        userver::engine::Deadline::FromDuration(kRequestTimeout);
+
+    if (kCallDeadline.IsReachable() &&
+        kCallDeadline.TimeLeft() < kTimeout.TimeLeft())
+        return kCallDeadline;
+
+    return kTimeout;
+}
+
+// Drives one asynchronous stage of a request to completion. Gives up with
+// RequestAbandoned once the deadline passes or the calling task is
+// cancelled; destroying the io_context then drops the pending operation
+class StageRunner final
+{
+public:
+    StageRunner(net::io_context& ioc, userver::engine::Deadline deadline)
+        : ioc_(ioc), deadline_(deadline)
+    {}
+
+    template <typename Operation>
+    beast::error_code Run(Operation&& operation)
+    {
+        beast::error_code result;
+        bool done = false;
+
+        operation([&result, &done](beast::error_code ec, auto&&...) {
+            result = ec;
+            done = true;
+        });
+
+        ioc_.restart();
+        while (!done)
+        {
+            if (userver::engine::current_task::ShouldCancel())
+                throw RequestAbandoned("calling task is cancelled");
+            if (deadline_.IsReached())
+                throw RequestAbandoned("deadline exceeded");
+
+            ioc_.run_for(std::min<std::chrono::nanoseconds>(
+                kPollInterval, deadline_.TimeLeft()));
+        }
+
+        return result;
+    }
+
+private:
+    net::io_context& ioc_;
+    const userver::engine::Deadline deadline_;
+};
+
+// User input goes into the quoted strings of Apicalypse queries
+std::string EscapeQuoted(std::string_view value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const auto kChar : value)
+    {
+        if (kChar == '"' || kChar == '\\')
+            escaped.push_back('\\');
+        escaped.push_back(kChar);
+    }
+    return escaped;
+}
+
+} // namespace
+
 constexpr std::string_view kSearchGameQuery =
     "fields name,summary,rating,genres.name,"
     "first_release_date,artworks.url,cover.url,"
@@ -29,6 +152,8 @@ constexpr std::string_view kSearchUpcomingGames =
     "sort hypes desc; "
     "limit {};";
 
+constexpr std::string_view kSearchGamesByIds = "where id = ({}); limit {};";
+
 IGDBManager::IGDBManager()
     : clientId_(std::getenv("CLIENT_ID")),
       clientSecret_(std::getenv("CLIENT_SECRET"))
@@ -39,37 +164,50 @@ std::optional<std::string> IGDBManager::GetTwitchToken() const
     try
     {
         const auto response = PerformHttpRequest(
-            "id.twitch.tv", "443",
+            Endpoint::kTwitch, kTwitchHost, kHttpsPort,
             "/oauth2/token?client_id=" + clientId_ + "&client_secret=" +
                 clientSecret_ + "&grant_type=client_credentials",
             http::verb::post, "",
             { { "Content-Type", "application/x-www-form-urlencoded" } });
 
-        if (response.empty())
-            return std::nullopt;
-
         return response;
     }
+    catch (const IgdbAbandoned&)
+    {
+        throw;
+    }
     catch (const std::exception& e)
     {
-        std::cerr << "Error getting Twitch token: " << e.what() << std::endl;
+        LOG_ERROR() << "Error getting Twitch token: " << e.what();
         return std::nullopt;
     }
 }
 
 bool IGDBManager::Authenticate()
 {
-    if (cachedToken_ && std::chrono::system_clock::now() < tokenExpiry_)
+    try
+    {
+        return AcquireToken().has_value();
+    }
+    catch (const IgdbError& e)
     {
-        accessToken_ = *cachedToken_;
-        return true;
+        LOG_WARNING() << "Authentication failed: " << e.what();
+        return false;
     }
+}
+
+std::optional<std::string> IGDBManager::AcquireToken()
+{
+    std::lock_guard<userver::engine::Mutex> lock(token_mutex_);
+
+    if (cachedToken_ && std::chrono::system_clock::now() < tokenExpiry_)
+        return cachedToken_;
 
     auto tokenResponse = GetTwitchToken();
     if (!tokenResponse || tokenResponse->empty())
     {
-        std::cerr << "Failed to get Twitch token" << std::endl;
-        return false;
+        LOG_ERROR() << "Failed to get Twitch token";
+        return std::nullopt;
     }
 
     try
@@ -78,12 +216,11 @@ bool IGDBManager::Authenticate()
 
         if (!json.contains("access_token"))
         {
-            std::cerr << "No access_token in response" << std::endl;
-            return false;
+            LOG_ERROR() << "No access_token in response";
+            return std::nullopt;
         }
 
-        accessToken_ = json["access_token"].get<std::string>();
-        cachedToken_ = accessToken_;
+        cachedToken_ = json["access_token"].get<std::string>();
 
         if (json.contains("expires_in"))
         {
@@ -93,105 +230,153 @@ bool IGDBManager::Authenticate()
                 std::chrono::seconds(expiresIn - kTokenExpiryBufferSeconds);
         }
 
-        return true;
+        return cachedToken_;
     }
     catch (const nlohmann::json::exception& e)
     {
-        std::cerr << "Failed to parse token response: " << e.what()
-                  << std::endl;
-        return false;
+        LOG_ERROR() << "Failed to parse token response: " << e.what();
+        return std::nullopt;
     }
 }
 
+void IGDBManager::DropToken(const std::string& token)
+{
+    std::lock_guard<userver::engine::Mutex> lock(token_mutex_);
+
+    if (cachedToken_ != token)
+        return;
+
+    cachedToken_.reset();
+    tokenExpiry_ = {};
+}
+
 IGDBManager::GamesInfo IGDBManager::SearchGames(std::string_view query,
                                                 std::int32_t limit)
 {
-    if (!Authenticate())
-    {
-        std::cerr << "Authentication failed in SearchGames" << std::endl;
-        return {};
-    }
-
     const auto body =
         fmt::format("{}search \"{}\"; where game_type = (0,8,9,10) & "
                     "(game_status = null | game_status != (6, 7)); limit {};",
-                    kSearchGameQuery, query, limit);
-
-    const auto response = PerformHttpRequest(
-        "api.igdb.com", "443", "/v4/games", http::verb::post, body,
-        { { "Client-ID", clientId_ },
-          { "Authorization", "Bearer " + accessToken_ } });
+                    kSearchGameQuery, EscapeQuoted(query), limit);
 
-    return ParseGamesResponse(response);
+    return QueryGames("SearchGames", body);
 }
 
 IGDBManager::GamesInfo IGDBManager::GetGameBySlug(std::string_view slug)
 {
-    if (!Authenticate())
-    {
-        std::cerr << "Authentication failed in GetGameBySlug" << std::endl;
-        return {};
-    }
-
     const auto body = fmt::format("{}{}", kSearchGameQuery,
-                                  fmt::format(kSearchGameBySlug, slug));
-
-    const auto response = PerformHttpRequest(
-        "api.igdb.com", "443", "/v4/games", http::verb::post, body,
-        { { "Client-ID", clientId_ },
-          { "Authorization", "Bearer " + accessToken_ } });
+                                  fmt::format(kSearchGameBySlug, EscapeQuoted(slug)));
 
-    return ParseGamesResponse(response);
+    return QueryGames("GetGameBySlug", body);
 }
 
 IGDBManager::GamesInfo IGDBManager::GetGamesByGenre(std::string_view genre,
                                                     std::int32_t limit)
 {
-    if (!Authenticate())
-    {
-        std::cerr << "Authentication failed in GetGamesByGenre" << std::endl;
+    const auto queryPart =
+        fmt::format(kSearchGameByGenre, EscapeQuoted(genre), limit);
+    const auto body = fmt::format("{}{}", kSearchGameQuery, queryPart);
+
+    return QueryGames("GetGamesByGenre", body);
+}
+
+IGDBManager::GamesInfo IGDBManager::GetUpcomingGames(std::int32_t limit)
+{
+    std::time_t now = std::time(nullptr);
+
+    const auto queryPart = fmt::format(kSearchUpcomingGames, now, limit);
+    const auto body = fmt::format("{}{}", kSearchGameQuery, queryPart);
+
+    return QueryGames("GetUpcomingGames", body);
+}
+
+IGDBManager::GamesInfo
+IGDBManager::GetGamesByIds(const std::vector<std::string>& ids)
+{
+    if (ids.empty())
         return {};
-    }
 
-    const auto queryPart = fmt::format(kSearchGameByGenre, genre, limit);
+    const auto queryPart =
+        fmt::format(kSearchGamesByIds, fmt::join(ids, ","), ids.size());
     const auto body = fmt::format("{}{}", kSearchGameQuery, queryPart);
 
-    const auto response = PerformHttpRequest(
-        "api.igdb.com", "443", "/v4/games", http::verb::post, body,
-        { { "Client-ID", clientId_ },
-          { "Authorization", "Bearer " + accessToken_ } });
+    return QueryGames("GetGamesByIds", body);
+}
 
-    return ParseGamesResponse(response);
+const IgdbStatistics& IGDBManager::GetStatistics() const
+{
+    return stats_;
 }
 
-IGDBManager::GamesInfo IGDBManager::GetUpcomingGames(std::int32_t limit)
+IGDBManager::GamesInfo IGDBManager::QueryGames(std::string_view operation,
+                                               const std::string& body)
 {
-    if (!Authenticate())
+    userver::tracing::Span span{ fmt::format("igdb_{}", operation) };
+
+    if (utils::IsCallAbandoned())
+        throw IgdbAbandoned(fmt::format("{} skipped, the call is abandoned",
+                                        operation));
+
+    const auto kRequest = [&] {
+        const auto kToken = AcquireToken();
+        if (!kToken)
+            throw IgdbError(
+                fmt::format("Authentication failed in {}", operation));
+
+        const auto kAuthorization = "Bearer " + *kToken;
+        try
+        {
+            return PerformHttpRequest(Endpoint::kIgdb, kIgdbHost, kHttpsPort,
+                                      "/v4/games", http::verb::post, body,
+                                      { { "Client-ID", clientId_ },
+                                        { "Authorization", kAuthorization } });
+        }
+        catch (const IgdbUnauthorized&)
+        {
+            DropToken(*kToken);
+            throw;
+        }
+    };
+
+    std::string response;
+    try
     {
-        std::cerr << "Authentication failed in GetUpcomingGames" << std::endl;
-        return {};
+        response = kRequest();
+    }
+    // The token may be revoked long before it expires
+    catch (const IgdbUnauthorized& e)
+    {
+        LOG_WARNING() << operation << " is retried with a new token: "
+                      << e.what();
+        response = kRequest();
     }
 
-    std::time_t now = std::time(nullptr);
-
-    const auto queryPart = fmt::format(kSearchUpcomingGames, now, limit);
-    const auto body = fmt::format("{}{}", kSearchGameQuery, queryPart);
+    StageClock clock(span);
+    auto games = ParseGamesResponse(response);
+    clock.Lap(stats_.parse, "parse_ms");
 
-    const auto response = PerformHttpRequest(
-        "api.igdb.com", "443", "/v4/games", http::verb::post, body,
-        { { "Client-ID", clientId_ },
-          { "Authorization", "Bearer " + accessToken_ } });
+    stats_.games.Account(games.size());
+    span.AddTag("games", games.size());
 
-    return ParseGamesResponse(response);
+    return games;
 }
 
 const std::string IGDBManager::PerformHttpRequest(
-    std::string_view host, std::string_view port, std::string_view target,
-    http::verb method, std::string_view body,
-    const std::vector<std::pair<std::string_view, std::string_view>>& headers) const
+    Endpoint endpoint, std::string_view host, std::string_view port,
+    std::string_view target, http::verb method, std::string_view body,
+    const std::vector<std::pair<std::string_view, std::string_view>>& headers)
+    const
 {
     namespace ssl = net::ssl;
 
+    auto& stats = stats_.ForEndpoint(endpoint);
+    ++stats.requests;
+
+    userver::tracing::Span span{ "igdb_http_request" };
+    span.AddTag("endpoint", std::string{ ToString(endpoint) });
+
+    const auto kStart = std::chrono::steady_clock::now();
+    StageClock clock(span);
+
     try
     {
         net::io_context ioc;
@@ -201,29 +386,54 @@ const std::string IGDBManager::PerformHttpRequest(
         ssl::stream<tcp::socket> stream(ioc, ctx);
         tcp::resolver resolver(ioc);
 
-        const auto results = resolver.resolve(host, port);
+        StageRunner runner(ioc, GetRequestDeadline());
+
+        tcp::resolver::results_type results;
+        auto ec = runner.Run([&](auto handler) {
+            resolver.async_resolve(
+                host, port,
+                [&results, handler](beast::error_code error,
+                                    tcp::resolver::results_type resolved) {
+                    results = std::move(resolved);
+                    handler(error);
+                });
+        });
+        if (ec)
+            throw beast::system_error{ ec };
+        clock.Lap(stats.dns, "dns_ms");
 
         if (!SSL_set_tlsext_host_name(stream.native_handle(), host.data()))
         {
-            beast::error_code ec{ static_cast<int>(::ERR_get_error()),
-                                  net::error::get_ssl_category() };
-            throw beast::system_error{ ec };
+            throw beast::system_error{ beast::error_code{
+                static_cast<int>(::ERR_get_error()),
+                net::error::get_ssl_category() } };
         }
 
         auto& lowest_layer = beast::get_lowest_layer(stream);
-        net::connect(lowest_layer, results.begin(), results.end());
-        stream.handshake(ssl::stream_base::client);
+        ec = runner.Run([&](auto handler) {
+            net::async_connect(lowest_layer, results, handler);
+        });
+        if (ec)
+            throw beast::system_error{ ec };
+        clock.Lap(stats.connect, "connect_ms");
+
+        ec = runner.Run([&](auto handler) {
+            stream.async_handshake(ssl::stream_base::client, handler);
+        });
+        if (ec)
+            throw beast::system_error{ ec };
+        clock.Lap(stats.tls_handshake, "tls_handshake_ms");
 
-        http::request<http::string_body> req{ method,
-                                              boost::string_view(target.data()),
-                                              11 };
+        http::request<http::string_body> req{
+            method, boost::string_view(target.data(), target.size()), 11
+        };
         req.set(http::field::host, boost::string_view(host.data()));
         req.set(http::field::user_agent, "IGDB-CPP-Client/1.0");
 
         for (const auto& [key, value] : headers)
         {
-            req.set(boost::string_view(key.data()),
-                    boost::string_view(value.data()));
+            req.set(boost::string_view(key.data(), key.size()),
+                    boost::string_view(value.data(), value.size()));
         }
 
         if (!body.empty())
@@ -233,26 +443,84 @@ const std::string IGDBManager::PerformHttpRequest(
             req.prepare_payload();
         }
 
-        http::write(stream, req);
-
         beast::flat_buffer buffer;
-        http::response<http::dynamic_body> res;
-        http::read(stream, buffer, res);
-
-        beast::error_code ec;
-        stream.shutdown(ec);
+        http::response_parser<http::dynamic_body> parser;
+
+        ec = runner.Run(
+            [&](auto handler) { http::async_write(stream, req, handler); });
+        if (!ec)
+            ec = runner.Run([&](auto handler) {
+                http::async_read_header(stream, buffer, parser, handler);
+            });
+        if (ec)
+            throw beast::system_error{ ec };
+        clock.Lap(stats.ttfb, "ttfb_ms");
 
-        if (ec == net::error::eof || ec == ssl::error::stream_truncated)
-            ec = {};
+        ec = runner.Run([&](auto handler) {
+            http::async_read(stream, buffer, parser, handler);
+        });
         if (ec)
             throw beast::system_error{ ec };
+        clock.Lap(stats.transfer, "transfer_ms");
+
+        auto& res = parser.get();
+        const auto kStatus = res.result_int();
+        const auto kBytes = res.body().size();
+
+        span.AddTag("http_status", kStatus);
+        span.AddTag("response_bytes", kBytes);
+        stats.response_kib.Account(kBytes / 1024);
+        stats.total.Account(std::chrono::steady_clock::now() - kStart);
+
+        // The response is complete at this point, a peer that doesn't finish
+        // the TLS shutdown in time is not worth failing the request for
+        ec = runner.Run(
+            [&](auto handler) { stream.async_shutdown(handler); });
+        if (ec && ec != net::error::eof && ec != ssl::error::stream_truncated)
+            LOG_DEBUG() << "TLS shutdown failed: " << ec.message();
+
+        if (kStatus == 429)
+            ++stats.too_many_requests;
+
+        if (kStatus >= 500)
+            ++stats.status_5xx;
+        else if (kStatus >= 400)
+            ++stats.status_4xx;
+        else
+            ++stats.status_2xx;
+
+        if (kStatus == 401 || kStatus == 403)
+            throw IgdbUnauthorized(fmt::format("{} responded with HTTP {}",
+                                               ToString(endpoint), kStatus));
+        // IGDB refusing this request, other than for its rate or the
+        // credentials, is no sign of its health
+        if (kStatus >= 400 && kStatus < 500 && kStatus != 429)
+            throw IgdbRejected(fmt::format("{} responded with HTTP {}",
+                                           ToString(endpoint), kStatus));
+        if (kStatus >= 400)
+            throw IgdbError(fmt::format("{} responded with HTTP {}",
+                                        ToString(endpoint), kStatus));
 
         return beast::buffers_to_string(res.body().data());
     }
+    catch (const RequestAbandoned& e)
+    {
+        ++stats.abandoned;
+        span.AddTag("abandoned", true);
+        throw IgdbAbandoned(fmt::format("HTTP request to {} abandoned: {}",
+                                        ToString(endpoint), e.what()));
+    }
+    catch (const IgdbError&)
+    {
+        span.AddTag("error", true);
+        throw;
+    }
     catch (const std::exception& e)
     {
-        std::cerr << "HTTP Request Error: " << e.what() << std::endl;
-        return "";
+        ++stats.transport_errors;
+        span.AddTag("error", true);
+        throw IgdbError(fmt::format("HTTP request to {} failed: {}",
+                                    ToString(endpoint), e.what()));
     }
 }
 
@@ -262,21 +530,15 @@ IGDBManager::ParseGamesResponse(std::string_view response) const
     std::vector<entities::GameInfo> games;
 
     if (response.empty())
-    {
-        std::cerr << "Empty response received" << std::endl;
-        return games;
-    }
+        throw IgdbError("Empty response received");
 
     try
     {
         auto json = nlohmann::json::parse(response);
 
         if (!json.is_array())
-        {
-            std::cerr << "Expected array in response, got: " << json.type_name()
-                      << std::endl;
-            return games;
-        }
+            throw IgdbError(fmt::format("Expected array in response, got: {}",
+                                        json.type_name()));
 
         for (const auto& gameJson : json)
         {
@@ -384,16 +646,16 @@ IGDBManager::ParseGamesResponse(std::string_view response) const
             }
             catch (const nlohmann::json::exception& e)
             {
-                std::cerr << "Error parsing game entry: " << e.what()
-                          << std::endl;
+                LOG_WARNING() << "Error parsing game entry: " << e.what();
             }
         }
     }
     catch (const nlohmann::json::exception& e)
     {
-        std::cerr << "Failed to parse games response: " << e.what()
-                  << std::endl;
-        std::cerr << "Response was: " << response << std::endl;
+        LOG_ERROR() << "Failed to parse games response: " << e.what()
+                    << ", response was: " << response;
+        throw IgdbError(
+            fmt::format("Failed to parse games response: {}", e.what()));
     }
 
     return games;
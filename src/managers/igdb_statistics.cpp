@@ -0,0 +1,68 @@
+// project headers
+#include <managers/igdb_statistics.hpp>
+
+namespace igdb {
+
+std::string_view ToString(Endpoint endpoint)
+{
+    switch (endpoint)
+    {
+    case Endpoint::kIgdb:
+        return "igdb";
+    case Endpoint::kTwitch:
+        return "twitch";
+    case Endpoint::kCount:
+        break;
+    }
+    return "unknown";
+}
+
+EndpointStatistics& IgdbStatistics::ForEndpoint(Endpoint endpoint)
+{
+    return endpoints[static_cast<std::size_t>(endpoint)];
+}
+
+const EndpointStatistics& IgdbStatistics::ForEndpoint(Endpoint endpoint) const
+{
+    return endpoints[static_cast<std::size_t>(endpoint)];
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const EndpointStatistics& stats)
+{
+    writer["timings"].ValueWithLabels(stats.dns, { { "stage", "dns" } });
+    writer["timings"].ValueWithLabels(stats.connect,
+                                      { { "stage", "connect" } });
+    writer["timings"].ValueWithLabels(stats.tls_handshake,
+                                      { { "stage", "tls-handshake" } });
+    writer["timings"].ValueWithLabels(stats.ttfb, { { "stage", "ttfb" } });
+    writer["timings"].ValueWithLabels(stats.transfer,
+                                      { { "stage", "transfer" } });
+    writer["timings"].ValueWithLabels(stats.total, { { "stage", "total" } });
+
+    writer["response-kib"] = stats.response_kib;
+
+    writer["requests"] = stats.requests;
+    writer["transport-errors"] = stats.transport_errors;
+    writer["abandoned"] = stats.abandoned;
+    writer["status"].ValueWithLabels(stats.status_2xx, { { "code", "2xx" } });
+    writer["status"].ValueWithLabels(stats.status_4xx, { { "code", "4xx" } });
+    writer["status"].ValueWithLabels(stats.status_5xx, { { "code", "5xx" } });
+    writer["too-many-requests"] = stats.too_many_requests;
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const IgdbStatistics& stats)
+{
+    for (std::size_t i = 0; i < kEndpointCount; ++i)
+    {
+        const auto kEndpoint = static_cast<Endpoint>(i);
+        writer.ValueWithLabels(stats.ForEndpoint(kEndpoint),
+                               { { "endpoint", ToString(kEndpoint) } });
+    }
+
+    writer["parse"] = stats.parse;
+    writer["games-per-response"] = stats.games;
+}
+
+} // namespace igdb
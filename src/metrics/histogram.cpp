@@ -0,0 +1,57 @@
+// project headers
+#include <metrics/histogram.hpp>
+
+// std
+#include <array>
+
+namespace metrics {
+
+namespace {
+
+constexpr std::array<double, 13> kLatencyBoundsMs{
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000
+};
+
+constexpr std::array<double, 10> kSizeBounds{ 0,  1,   5,   10,  20,
+                                              50, 100, 200, 500, 1000 };
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : histogram_(kLatencyBoundsMs) {}
+
+void LatencyHistogram::Account(std::chrono::nanoseconds duration)
+{
+    histogram_.Account(
+        std::chrono::duration<double, std::milli>(duration).count());
+}
+
+userver::utils::statistics::HistogramView LatencyHistogram::GetView() const
+{
+    return histogram_.GetView();
+}
+
+SizeHistogram::SizeHistogram() : histogram_(kSizeBounds) {}
+
+void SizeHistogram::Account(std::size_t size)
+{
+    histogram_.Account(static_cast<double>(size));
+}
+
+userver::utils::statistics::HistogramView SizeHistogram::GetView() const
+{
+    return histogram_.GetView();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const LatencyHistogram& histogram)
+{
+    writer = histogram.GetView();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SizeHistogram& histogram)
+{
+    writer = histogram.GetView();
+}
+
+} // namespace metrics
@@ -0,0 +1,228 @@
+// project headers
+#include <managers/igdb_component.hpp>
+#include <refresh/refresh_scheduler.hpp>
+
+// std
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+// userver
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace refresh {
+
+namespace {
+
+userver::utils::TokenBucket MakeBudget(const SchedulerSettings& settings)
+{
+    const double kRate =
+        std::max(settings.igdb_rps * settings.budget_share, 0.001);
+    const auto kInterval =
+        std::chrono::duration_cast<userver::utils::TokenBucket::Duration>(
+            std::chrono::duration<double>(1.0 / kRate));
+
+    return userver::utils::TokenBucket(
+        std::max<std::size_t>(settings.max_batches, 1),
+        userver::utils::TokenBucket::RefillPolicy{ 1, kInterval });
+}
+
+SchedulerSettings
+ParseSettings(const userver::components::ComponentConfig& config)
+{
+    SchedulerSettings settings;
+
+    settings.period =
+        config["period"].As<std::chrono::milliseconds>(settings.period);
+    settings.stale_after =
+        config["stale-after"].As<std::chrono::seconds>(settings.stale_after);
+    settings.batch_size =
+        config["batch-size"].As<std::size_t>(settings.batch_size);
+    settings.max_batches =
+        config["max-batches"].As<std::size_t>(settings.max_batches);
+    settings.igdb_rps = config["igdb-rps"].As<double>(settings.igdb_rps);
+    settings.budget_share =
+        config["budget-share"].As<double>(settings.budget_share);
+
+    return settings;
+}
+
+} // namespace
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const SchedulerStatistics& stats)
+{
+    writer["runs"] = stats.runs;
+    writer["batches"] = stats.batches;
+    writer["refreshed"] = stats.refreshed;
+    writer["missing"] = stats.missing;
+    writer["failed-batches"] = stats.failed_batches;
+    writer["budget-exhausted"] = stats.budget_exhausted;
+    writer["last-candidates"] = stats.last_candidates.load();
+    writer["lag-seconds"] = stats.lag_seconds.load();
+}
+
+RefreshScheduler::RefreshScheduler(const pg::IGameRepository& repository,
+                                   igdb::IIGDBManager& igdb_manager,
+                                   SchedulerSettings settings)
+    : repository_(repository), igdb_manager_(igdb_manager),
+      settings_(settings), budget_(MakeBudget(settings_))
+{}
+
+void RefreshScheduler::RunOnce()
+{
+    ++stats_.runs;
+
+    const auto kLimit = static_cast<std::int32_t>(settings_.batch_size *
+                                                  settings_.max_batches);
+    const auto kCandidates =
+        repository_.GetRefreshCandidates(kLimit, settings_.stale_after);
+
+    stats_.last_candidates = static_cast<std::int64_t>(kCandidates.size());
+
+    for (std::size_t begin = 0; begin < kCandidates.size();
+         begin += settings_.batch_size)
+    {
+        if (!igdb_manager_.IsAvailable())
+        {
+            LOG_INFO() << "IGDB is unavailable, "
+                       << kCandidates.size() - begin << " games postponed";
+            break;
+        }
+
+        if (!budget_.Obtain())
+        {
+            ++stats_.budget_exhausted;
+            LOG_INFO() << "IGDB refresh budget exhausted, "
+                       << kCandidates.size() - begin << " games postponed";
+            break;
+        }
+
+        const auto kEnd =
+            std::min(begin + settings_.batch_size, kCandidates.size());
+        RefreshBatch(std::vector<std::string>(kCandidates.begin() + begin,
+                                              kCandidates.begin() + kEnd));
+    }
+
+    stats_.lag_seconds = repository_.GetMaxSyncLag().count();
+}
+
+const SchedulerStatistics& RefreshScheduler::GetStatistics() const
+{
+    return stats_;
+}
+
+const SchedulerSettings& RefreshScheduler::GetSettings() const
+{
+    return settings_;
+}
+
+void RefreshScheduler::RefreshBatch(const std::vector<std::string>& igdb_ids)
+{
+    ++stats_.batches;
+
+    try
+    {
+        const auto kIgdbGames = igdb_manager_.GetGamesByIds(igdb_ids);
+
+        std::unordered_set<std::string_view> returned;
+        returned.reserve(kIgdbGames.size());
+        for (const auto& igdb_game : kIgdbGames)
+        {
+            repository_.CreateGame(igdb_game);
+            returned.insert(igdb_game.id);
+        }
+
+        // Deleted or merged on the IGDB side, a transport failure throws
+        std::vector<std::string> missing;
+        for (const auto& igdb_id : igdb_ids)
+            if (!returned.count(igdb_id))
+                missing.push_back(igdb_id);
+
+        if (!missing.empty())
+        {
+            repository_.MarkRefreshAttempted(missing);
+            stats_.missing.Add(
+                userver::utils::statistics::Rate{ missing.size() });
+        }
+
+        stats_.refreshed.Add(
+            userver::utils::statistics::Rate{ kIgdbGames.size() });
+    }
+    catch (const std::exception& ex)
+    {
+        ++stats_.failed_batches;
+        LOG_ERROR() << "IGDB refresh batch failed: " << ex.what();
+    }
+}
+
+RefreshSchedulerComponent::RefreshSchedulerComponent(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : userver::components::ComponentBase(config, context),
+      pg_manager_(
+          context
+              .FindComponent<userver::components::Postgres>("playhub-games-db")
+              .GetCluster()),
+      scheduler_(pg_manager_,
+                 context.FindComponent<igdb::IgdbComponent>().GetManager(),
+                 ParseSettings(config))
+{
+    auto& storage =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage();
+    statistics_entry_ = storage.RegisterWriter(
+        "game-service.igdb-refresh",
+        [this](userver::utils::statistics::Writer& writer) {
+            writer = scheduler_.GetStatistics();
+        });
+
+    task_.Start(std::string{ kName },
+                userver::utils::PeriodicTask::Settings{
+                    scheduler_.GetSettings().period },
+                [this] { scheduler_.RunOnce(); });
+}
+
+RefreshSchedulerComponent::~RefreshSchedulerComponent()
+{
+    task_.Stop();
+    statistics_entry_.Unregister();
+}
+
+userver::yaml_config::Schema
+RefreshSchedulerComponent::GetStaticConfigSchema()
+{
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(
+        R"(
+            type: object
+            description: Periodic popularity-prioritized IGDB catalog refresh
+            additionalProperties: false
+            properties:
+                period:
+                    type: string
+                    description: interval between refresh runs
+                stale-after:
+                    type: string
+                    description: minimal age of IGDB data to consider a refresh
+                batch-size:
+                    type: integer
+                    description: games per IGDB `where id = (...)` request
+                max-batches:
+                    type: integer
+                    description: IGDB requests per run at most
+                igdb-rps:
+                    type: number
+                    description: IGDB request rate limit
+                budget-share:
+                    type: number
+                    description: share of the IGDB rate the scheduler may use
+        )");
+}
+
+} // namespace refresh
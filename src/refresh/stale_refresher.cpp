@@ -0,0 +1,90 @@
+// project headers
+#include <refresh/stale_refresher.hpp>
+#include <tools/deadline.hpp>
+
+// userver
+#include <userver/logging/log.hpp>
+
+namespace refresh {
+
+StaleRefresher::StaleRefresher(const pg::IGameRepository& repository,
+                               igdb::IIGDBManager& igdb_manager,
+                               RefreshSettings settings)
+    : repository_(repository), igdb_manager_(igdb_manager),
+      settings_(settings),
+      rate_limit_(settings_.burst,
+                  userver::utils::TokenBucket::RefillPolicy{
+                      1, settings_.token_interval })
+{}
+
+bool StaleRefresher::IsStale(const entities::GamePostgres& game) const
+{
+    const auto kSyncedAt = game.igdb_synced_at.GetUnderlying();
+    return std::chrono::system_clock::now() - kSyncedAt > settings_.ttl;
+}
+
+void StaleRefresher::RefreshIfStale(const entities::GamePostgres& game)
+{
+    if (!settings_.enabled || game.slug.empty() || !IsStale(game))
+        return;
+
+    if (!igdb_manager_.IsAvailable() || !TryAcquire(game.slug))
+        return;
+
+    tasks_.AsyncDetach("igdb-stale-refresh", [this, slug = game.slug] {
+        try
+        {
+            Refresh(slug);
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_WARNING() << "Stale refresh of '" << slug
+                          << "' failed: " << ex.what();
+        }
+        Release(slug);
+    });
+}
+
+std::size_t StaleRefresher::InFlight() const
+{
+    return in_flight_.Lock()->size();
+}
+
+bool StaleRefresher::TryAcquire(const std::string& slug)
+{
+    auto in_flight = in_flight_.Lock();
+
+    if (in_flight->size() >= settings_.max_in_flight ||
+        in_flight->count(slug) != 0)
+        return false;
+
+    if (!rate_limit_.Obtain())
+        return false;
+
+    in_flight->insert(slug);
+    return true;
+}
+
+void StaleRefresher::Release(const std::string& slug)
+{
+    in_flight_.Lock()->erase(slug);
+}
+
+void StaleRefresher::Refresh(const std::string& slug)
+{
+    // The refresh outlives the call that triggered it
+    utils::CallDeadlineScope deadline_scope(userver::engine::Deadline{});
+
+    const auto kIgdbGames = igdb_manager_.GetGameBySlug(slug);
+
+    if (kIgdbGames.empty())
+    {
+        LOG_DEBUG() << "IGDB returned nothing for stale game " << slug;
+        return;
+    }
+
+    repository_.CreateGame(kIgdbGames.front());
+    LOG_DEBUG() << "Refreshed stale game " << slug;
+}
+
+} // namespace refresh
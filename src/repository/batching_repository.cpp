@@ -0,0 +1,204 @@
+// project headers
+#include <repository/batching_repository.hpp>
+#include <tools/utils.hpp>
+
+// boost
+#include <boost/uuid/uuid_io.hpp>
+
+namespace pg {
+
+BatchingRepository::BatchingRepository(const IGameRepository& repository,
+                                       BatchSettings settings)
+    : repository_(repository), enabled_(settings.enabled),
+      by_id_(
+          settings,
+          [&repository](const std::vector<std::string>& ids) {
+              return repository.GetGamesByIds(ids);
+          },
+          [](const GamePostgres& game) {
+              return boost::uuids::to_string(game.id);
+          }),
+      by_slug_(
+          settings,
+          [&repository](const std::vector<std::string>& slugs) {
+              return repository.GetGamesBySlugs(slugs);
+          },
+          [](const GamePostgres& game) { return game.slug; })
+{}
+
+GamePostgres BatchingRepository::CreateGame(const GameInfo& kGameIgdbInfo) const
+{
+    return repository_.CreateGame(kGameIgdbInfo);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::FindGame(std::string_view query, std::int32_t limit) const
+{
+    return repository_.FindGame(query, limit);
+}
+
+std::optional<GamePostgres>
+BatchingRepository::GetGameBySlug(std::string_view slug) const
+{
+    if (!enabled_)
+        return repository_.GetGameBySlug(slug);
+
+    return by_slug_.Load(std::string{ slug });
+}
+
+std::optional<GamePostgres>
+BatchingRepository::GetGameById(std::string_view postgresId) const
+{
+    if (!enabled_)
+        return repository_.GetGameById(postgresId);
+
+    // A malformed id would fail the `::uuid[]` cast of the whole batch, and
+    // rows come back keyed by the canonical spelling
+    const auto kId = utils::ToCanonicalUuid(postgresId);
+    if (!kId)
+        return std::nullopt;
+
+    return by_id_.Load(*kId);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetGamesByIds(const std::vector<std::string>& ids) const
+{
+    return repository_.GetGamesByIds(ids);
+}
+
+BatchingRepository::GamesPostgres BatchingRepository::GetGamesBySlugs(
+    const std::vector<std::string>& slugs) const
+{
+    return repository_.GetGamesBySlugs(slugs);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetGamesByKeys(const std::vector<std::string>& ids,
+                                   const std::vector<std::string>& slugs) const
+{
+    return repository_.GetGamesByKeys(ids, slugs);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetGamesByGenre(std::string_view genre,
+                                    std::int32_t limit) const
+{
+    return repository_.GetGamesByGenre(genre, limit);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetTopRatedGames(std::int32_t limit) const
+{
+    return repository_.GetTopRatedGames(limit);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetUpcomingGames(std::int32_t limit) const
+{
+    return repository_.GetUpcomingGames(limit);
+}
+
+BatchingRepository::GamesPostgres
+BatchingRepository::GetAllGames(std::int32_t limit, std::int32_t offset,
+                                ::games::SortingType filter) const
+{
+    return repository_.GetAllGames(limit, offset, filter);
+}
+
+std::optional<bool>
+BatchingRepository::UpdateGameRating(std::string_view game_id,
+                                     std::int32_t rating) const
+{
+    return repository_.UpdateGameRating(game_id, rating);
+}
+
+bool BatchingRepository::AddGameViews(const std::vector<GameViews>& views) const
+{
+    return repository_.AddGameViews(views);
+}
+
+std::vector<std::string>
+BatchingRepository::GetRefreshCandidates(std::int32_t limit,
+                                         std::chrono::seconds stale_after) const
+{
+    return repository_.GetRefreshCandidates(limit, stale_after);
+}
+
+bool BatchingRepository::MarkRefreshAttempted(
+    const std::vector<std::string>& igdb_ids) const
+{
+    return repository_.MarkRefreshAttempted(igdb_ids);
+}
+
+std::chrono::seconds BatchingRepository::GetMaxSyncLag() const
+{
+    return repository_.GetMaxSyncLag();
+}
+
+std::optional<std::int64_t> BatchingRepository::CountGames() const
+{
+    return repository_.CountGames();
+}
+
+std::optional<std::int64_t> BatchingRepository::EstimateGameCount() const
+{
+    return repository_.EstimateGameCount();
+}
+
+std::optional<BatchingRepository::GameKeys>
+BatchingRepository::ScanGameKeys(std::string_view after_id,
+                                 std::int32_t limit) const
+{
+    return repository_.ScanGameKeys(after_id, limit);
+}
+
+std::optional<BatchingRepository::GamesFeatures>
+BatchingRepository::ScanGameFeatures(std::string_view after_id,
+                                     std::int32_t limit) const
+{
+    return repository_.ScanGameFeatures(after_id, limit);
+}
+
+std::optional<BatchingRepository::GamesPostgres>
+BatchingRepository::ScanGames(
+    std::string_view after_id,
+    userver::storages::postgres::TimePointWithoutTz updated_since,
+    std::int32_t limit) const
+{
+    return repository_.ScanGames(after_id, updated_since, limit);
+}
+
+std::optional<BatchingRepository::GamesPostgres>
+BatchingRepository::ScanChanges(const ChangeCursor& after,
+                                std::chrono::milliseconds settle,
+                                std::int32_t limit) const
+{
+    return repository_.ScanChanges(after, settle, limit);
+}
+
+std::optional<ChangeCursor> BatchingRepository::GetLatestChangeCursor(
+    std::chrono::milliseconds settle) const
+{
+    return repository_.GetLatestChangeCursor(settle);
+}
+
+const BatchStatistics& BatchingRepository::GetIdStatistics() const
+{
+    return by_id_.GetStatistics();
+}
+
+const BatchStatistics& BatchingRepository::GetSlugStatistics() const
+{
+    return by_slug_.GetStatistics();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BatchingRepository& repository)
+{
+    writer.ValueWithLabels(repository.GetIdStatistics(), { { "key", "id" } });
+    writer.ValueWithLabels(repository.GetSlugStatistics(),
+                           { { "key", "slug" } });
+}
+
+} // namespace pg
@@ -0,0 +1,168 @@
+// project headers
+#include <repository/lookup_batcher.hpp>
+#include <tools/deadline.hpp>
+
+// std
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// userver
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/logging/log.hpp>
+
+namespace pg {
+
+namespace {
+
+userver::engine::Deadline GetLater(userver::engine::Deadline lhs,
+                                   userver::engine::Deadline rhs)
+{
+    if (!lhs.IsReachable() || !rhs.IsReachable())
+        return {};
+
+    return lhs < rhs ? rhs : lhs;
+}
+
+std::vector<std::string> GetUnique(const std::vector<std::string>& keys)
+{
+    std::vector<std::string> unique;
+    unique.reserve(keys.size());
+
+    std::unordered_set<std::string_view> seen;
+    for (const auto& key : keys)
+        if (seen.insert(key).second)
+            unique.push_back(key);
+
+    return unique;
+}
+
+} // namespace
+
+struct LookupBatcher::Batch
+{
+    // Written under the batcher mutex until the batch is closed
+    std::vector<std::string> keys;
+    userver::engine::Deadline deadline;
+
+    userver::engine::SingleConsumerEvent full;
+
+    userver::engine::Mutex mutex;
+    userver::engine::ConditionVariable loaded;
+    bool done{ false };
+    std::unordered_map<std::string, GamePostgres> rows;
+};
+
+LookupBatcher::LookupBatcher(BatchSettings settings, Loader loader,
+                             KeyOf key_of)
+    : settings_(settings), loader_(std::move(loader)),
+      key_of_(std::move(key_of))
+{}
+
+std::optional<GamePostgres> LookupBatcher::Load(const std::string& key)
+{
+    ++stats_.lookups;
+
+    const auto kDeadline = utils::GetCallDeadline();
+
+    std::shared_ptr<Batch> batch;
+    bool is_first = false;
+    bool is_full = false;
+    {
+        std::lock_guard lock(mutex_);
+
+        is_first = !open_;
+        if (is_first)
+        {
+            open_ = std::make_shared<Batch>();
+            open_->deadline = kDeadline;
+        }
+        else
+            open_->deadline = GetLater(open_->deadline, kDeadline);
+
+        batch = open_;
+        batch->keys.push_back(key);
+
+        is_full = batch->keys.size() >= settings_.max_batch;
+        if (is_full)
+            open_.reset();
+    }
+
+    if (is_first)
+        tasks_.AsyncDetach("pg-lookup-batch",
+                           [this, batch] { Run(batch); });
+    if (is_full)
+        batch->full.Send();
+
+    std::unique_lock lock(batch->mutex);
+    if (!batch->loaded.WaitUntil(lock, kDeadline,
+                                 [&batch] { return batch->done; }))
+    {
+        ++stats_.timeouts;
+        return std::nullopt;
+    }
+
+    const auto kRow = batch->rows.find(key);
+    if (kRow == batch->rows.end())
+        return std::nullopt;
+
+    return kRow->second;
+}
+
+const BatchStatistics& LookupBatcher::GetStatistics() const
+{
+    return stats_;
+}
+
+void LookupBatcher::Run(const std::shared_ptr<Batch>& batch)
+{
+    // Either the window passes or the batch fills up
+    static_cast<void>(batch->full.WaitForEventFor(settings_.window));
+
+    std::vector<std::string> keys;
+    userver::engine::Deadline deadline;
+    {
+        std::lock_guard lock(mutex_);
+        if (open_ == batch)
+            open_.reset();
+
+        keys = GetUnique(batch->keys);
+        deadline = batch->deadline;
+        stats_.batch_size.Account(batch->keys.size());
+    }
+    ++stats_.batches;
+
+    IGameRepository::GamesPostgres rows;
+    try
+    {
+        utils::CallDeadlineScope deadline_scope(deadline);
+        rows = loader_(keys);
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR() << "Batched lookup of " << keys.size()
+                    << " keys failed: " << ex.what();
+    }
+
+    std::lock_guard lock(batch->mutex);
+    for (auto& row : rows)
+    {
+        auto key = key_of_(row);
+        batch->rows.emplace(std::move(key), std::move(row));
+    }
+
+    batch->done = true;
+    batch->loaded.NotifyAll();
+}
+
+void DumpMetric(userver::utils::statistics::Writer& writer,
+                const BatchStatistics& stats)
+{
+    writer["batch-size"] = stats.batch_size;
+    writer["lookups"] = stats.lookups;
+    writer["batches"] = stats.batches;
+    writer["timeouts"] = stats.timeouts;
+}
+
+} // namespace pg
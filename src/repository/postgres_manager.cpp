@@ -1,6 +1,13 @@
 #include <repository/postgres_manager.hpp>
+#include <tools/deadline.hpp>
+#include <userver/logging/log.hpp>
 #include <userver/storages/postgres/cluster_types.hpp>
 
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/uuid/uuid_io.hpp>
+
 template <>
 struct userver::storages::postgres::io::CppToUserPg<boost::uuids::uuid>
 {
@@ -15,6 +22,26 @@ struct userver::storages::postgres::io::CppToUserPg<std::int32_t>
 
 namespace pg {
 
+namespace {
+
+// Thrown instead of sending a query for a call that is cancelled or out of
+// time
+class CallAbandoned final : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Queries skipped for abandoned calls are expected under load, not errors
+userver::logging::Level GetLogLevel(const std::exception& e)
+{
+    return dynamic_cast<const CallAbandoned*>(&e)
+               ? userver::logging::Level::kWarning
+               : userver::logging::Level::kError;
+}
+
+} // namespace
+
 const userver::storages::postgres::Query kInsertGame{
     "INSERT INTO playhub.games ("
     "  igdb_id, name, slug, summary, igdb_rating, hypes, "
@@ -29,8 +56,7 @@ const userver::storages::postgres::Query kInsertGame{
     "  $13, $14, "
     "  0.0"
     ") "
-    "ON CONFLICT (id) DO UPDATE SET "
-    "  igdb_id = EXCLUDED.igdb_id, "
+    "ON CONFLICT (igdb_id) DO UPDATE SET "
     "  name = EXCLUDED.name, "
     "  slug = EXCLUDED.slug, "
     "  summary = EXCLUDED.summary, "
@@ -44,12 +70,24 @@ const userver::storages::postgres::Query kInsertGame{
     "  genres = EXCLUDED.genres, "
     "  themes = EXCLUDED.themes, "
     "  platforms = EXCLUDED.platforms, "
-    "  updated_at = NOW() "
+    "  updated_at = CASE WHEN ("
+    "    games.name, games.slug, games.summary, games.igdb_rating, "
+    "    games.hypes, games.first_release_date, games.release_dates, "
+    "    games.cover_url, games.artwork_urls, games.screenshots, "
+    "    games.genres, games.themes, games.platforms"
+    "  ) IS DISTINCT FROM ("
+    "    EXCLUDED.name, EXCLUDED.slug, EXCLUDED.summary, EXCLUDED.igdb_rating, "
+    "    EXCLUDED.hypes, EXCLUDED.first_release_date, EXCLUDED.release_dates, "
+    "    EXCLUDED.cover_url, EXCLUDED.artwork_urls, EXCLUDED.screenshots, "
+    "    EXCLUDED.genres, EXCLUDED.themes, EXCLUDED.platforms"
+    "  ) THEN NOW() ELSE games.updated_at END, "
+    "  igdb_synced_at = NOW() "
     "RETURNING "
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "  screenshots, "
-    "  genres, themes, platforms, created_at, updated_at"
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at",
+    userver::storages::postgres::Query::Name{ "insert_game" }
 };
 
 const userver::storages::postgres::Query kFindGame{
@@ -57,10 +95,11 @@ const userver::storages::postgres::Query kFindGame{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
     "WHERE name ILIKE '%' || $1 || '%' "
-    "LIMIT $2"
+    "LIMIT $2",
+    userver::storages::postgres::Query::Name{ "find_game" }
 };
 
 const userver::storages::postgres::Query kGetGameBySlug{
@@ -68,9 +107,10 @@ const userver::storages::postgres::Query kGetGameBySlug{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
-    "WHERE slug = $1"
+    "WHERE slug = $1",
+    userver::storages::postgres::Query::Name{ "get_game_by_slug" }
 };
 
 const userver::storages::postgres::Query kGetGameByPostgresId{
@@ -78,9 +118,46 @@ const userver::storages::postgres::Query kGetGameByPostgresId{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
-    "WHERE id = $1::uuid"
+    "WHERE id = $1::uuid",
+    userver::storages::postgres::Query::Name{ "get_game_by_postgres_id" }
+};
+
+// Rows come back in the order of the requested ids
+const userver::storages::postgres::Query kGetGamesByIds{
+    "SELECT "
+    "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
+    "  first_release_date, release_dates, cover_url, artwork_urls, "
+    "screenshots, "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
+    "FROM playhub.games "
+    "WHERE id = ANY($1::uuid[]) "
+    "ORDER BY array_position($1::uuid[], id)",
+    userver::storages::postgres::Query::Name{ "get_games_by_ids" }
+};
+
+const userver::storages::postgres::Query kGetGamesBySlugs{
+    "SELECT "
+    "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
+    "  first_release_date, release_dates, cover_url, artwork_urls, "
+    "screenshots, "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
+    "FROM playhub.games "
+    "WHERE slug = ANY($1::text[]) "
+    "ORDER BY array_position($1::text[], slug)",
+    userver::storages::postgres::Query::Name{ "get_games_by_slugs" }
+};
+
+const userver::storages::postgres::Query kGetGamesByKeys{
+    "SELECT "
+    "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
+    "  first_release_date, release_dates, cover_url, artwork_urls, "
+    "screenshots, "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
+    "FROM playhub.games "
+    "WHERE id = ANY($1::uuid[]) OR slug = ANY($2::text[])",
+    userver::storages::postgres::Query::Name{ "get_games_by_keys" }
 };
 
 const userver::storages::postgres::Query kGetGamesByGenre{
@@ -88,11 +165,12 @@ const userver::storages::postgres::Query kGetGamesByGenre{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
     "WHERE $1 = ANY(genres) "
     "ORDER BY igdb_rating DESC NULLS LAST "
-    "LIMIT $2"
+    "LIMIT $2",
+    userver::storages::postgres::Query::Name{ "get_games_by_genre" }
 };
 
 const userver::storages::postgres::Query kGetTopRatedGames{
@@ -100,11 +178,12 @@ const userver::storages::postgres::Query kGetTopRatedGames{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
     "WHERE playhub_rating IS NOT NULL "
     "ORDER BY playhub_rating DESC NULLS LAST "
-    "LIMIT $1"
+    "LIMIT $1",
+    userver::storages::postgres::Query::Name{ "get_top_rated_games" }
 };
 
 const userver::storages::postgres::Query kGetUpcomingGames{
@@ -112,12 +191,13 @@ const userver::storages::postgres::Query kGetUpcomingGames{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
     "WHERE first_release_date IS NOT NULL "
     "  AND CAST(NULLIF(first_release_date, 'N/A') AS TIMESTAMP) > NOW() "
     "ORDER BY CAST(NULLIF(first_release_date, 'N/A') AS TIMESTAMP) ASC "
-    "LIMIT $1"
+    "LIMIT $1",
+    userver::storages::postgres::Query::Name{ "get_upcoming_games" }
 };
 
 const userver::storages::postgres::Query kGetAllGames{
@@ -125,16 +205,138 @@ const userver::storages::postgres::Query kGetAllGames{
     "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
     "  first_release_date, release_dates, cover_url, artwork_urls, "
     "screenshots, "
-    "  genres, themes, platforms, created_at, updated_at "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
     "FROM playhub.games "
     "ORDER BY $3 DESC "
-    "LIMIT $1 OFFSET $2"
+    "LIMIT $1 OFFSET $2",
+    userver::storages::postgres::Query::Name{ "get_all_games" }
 };
 
 const userver::storages::postgres::Query kUpdateGameRating{
     "UPDATE playhub.games "
     "SET playhub_rating = $2, updated_at = NOW() "
-    "WHERE id = $1::uuid"
+    "WHERE id = $1::uuid",
+    userver::storages::postgres::Query::Name{ "update_game_rating" }
+};
+
+// updated_at is left alone, views are no change of the game for the
+// change feed and the version tokens
+const userver::storages::postgres::Query kAddGameViews{
+    "UPDATE playhub.games AS games "
+    "SET view_count = games.view_count + views.count "
+    "FROM UNNEST($1::uuid[], $2::bigint[]) AS views(id, count) "
+    "WHERE games.id = views.id",
+    userver::storages::postgres::Query::Name{ "add_game_views" }
+};
+
+// Only the longest unsynced stale rows, ten times as many as are asked
+// for, are ranked, so the igdb_synced_at index bounds the work however
+// large the backlog. Among them traffic goes first: the views counted so
+// far, hypes and the PlayHub rating, then a recent or upcoming release
+// and the time since the last sync. view_count itself isn't indexed, that
+// would make every view flush a non-HOT update
+const userver::storages::postgres::Query kGetRefreshCandidates{
+    "SELECT igdb_id FROM ("
+    "  SELECT igdb_id, view_count, hypes, playhub_rating, "
+    "    first_release_date, igdb_synced_at "
+    "  FROM playhub.games "
+    "  WHERE igdb_synced_at < NOW() - $2 * INTERVAL '1 second' "
+    "  ORDER BY igdb_synced_at "
+    "  LIMIT $1 * 10"
+    ") AS stale "
+    "ORDER BY "
+    "  LN(2 + view_count) "
+    "  + LN(2 + GREATEST(COALESCE(hypes, 0), 0)) "
+    "  + LN(2 + GREATEST(COALESCE(playhub_rating, 0), 0)) "
+    "  + CASE WHEN CAST(NULLIF(first_release_date, 'N/A') AS DATE) "
+    "      BETWEEN CURRENT_DATE - 90 AND CURRENT_DATE + 365 "
+    "    THEN 2 ELSE 0 END "
+    "  + EXTRACT(EPOCH FROM NOW() - igdb_synced_at) / 604800.0 DESC "
+    "LIMIT $1",
+    userver::storages::postgres::Query::Name{ "get_refresh_candidates" }
+};
+
+// updated_at stays, nothing about the game itself has changed
+const userver::storages::postgres::Query kMarkRefreshAttempted{
+    "UPDATE playhub.games "
+    "SET igdb_synced_at = NOW() "
+    "WHERE igdb_id = ANY($1::text[])",
+    userver::storages::postgres::Query::Name{ "mark_refresh_attempted" }
+};
+
+const userver::storages::postgres::Query kGetMaxSyncLag{
+    "SELECT COALESCE("
+    "  EXTRACT(EPOCH FROM NOW() - MIN(igdb_synced_at)), 0)::BIGINT "
+    "FROM playhub.games",
+    userver::storages::postgres::Query::Name{ "get_max_sync_lag" }
+};
+
+const userver::storages::postgres::Query kCountGames{
+    "SELECT COUNT(*) FROM playhub.games",
+    userver::storages::postgres::Query::Name{ "count_games" }
+};
+
+// reltuples is -1 until the table is analyzed for the first time
+const userver::storages::postgres::Query kEstimateGameCount{
+    "SELECT reltuples::BIGINT "
+    "FROM pg_class "
+    "WHERE oid = 'playhub.games'::regclass",
+    userver::storages::postgres::Query::Name{ "estimate_game_count" }
+};
+
+const userver::storages::postgres::Query kScanGameKeys{
+    "SELECT id::text, slug "
+    "FROM playhub.games "
+    "WHERE id > $1::uuid "
+    "ORDER BY id "
+    "LIMIT $2",
+    userver::storages::postgres::Query::Name{ "scan_game_keys" }
+};
+
+const userver::storages::postgres::Query kScanGameFeatures{
+    "SELECT id, genres, themes, platforms, first_release_date, "
+    "  playhub_rating, name, slug, hypes, igdb_rating "
+    "FROM playhub.games "
+    "WHERE id > $1::uuid "
+    "ORDER BY id "
+    "LIMIT $2",
+    userver::storages::postgres::Query::Name{ "scan_game_features" }
+};
+
+const userver::storages::postgres::Query kScanGames{
+    "SELECT "
+    "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
+    "  first_release_date, release_dates, cover_url, artwork_urls, "
+    "screenshots, "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
+    "FROM playhub.games "
+    "WHERE id > $1::uuid AND updated_at >= $2 "
+    "ORDER BY id "
+    "LIMIT $3",
+    userver::storages::postgres::Query::Name{ "scan_games" }
+};
+
+const userver::storages::postgres::Query kScanChanges{
+    "SELECT "
+    "  id, igdb_id, name, slug, summary, igdb_rating, playhub_rating, hypes, "
+    "  first_release_date, release_dates, cover_url, artwork_urls, "
+    "screenshots, "
+    "  genres, themes, platforms, created_at, updated_at, igdb_synced_at "
+    "FROM playhub.games "
+    "WHERE (updated_at, id) > ($1, $2::uuid) "
+    "  AND updated_at < NOW() - $3 * INTERVAL '1 millisecond' "
+    "ORDER BY updated_at, id "
+    "LIMIT $4",
+    userver::storages::postgres::Query::Name{ "scan_changes" }
+};
+
+const userver::storages::postgres::Query kGetLatestChangeCursor{
+    "SELECT updated_at, id::text "
+    "FROM playhub.games "
+    "WHERE updated_at < NOW() - $1 * INTERVAL '1 millisecond' "
+    "ORDER BY updated_at DESC, id DESC "
+    "LIMIT 1",
+    userver::storages::postgres::Query::Name{ "get_latest_change_cursor" }
 };
 
 PostgresManager::PostgresManager(
@@ -142,6 +344,30 @@ PostgresManager::PostgresManager(
     : pg_cluster_(std::move(pg_cluster))
 {}
 
+userver::storages::postgres::CommandControl
+PostgresManager::GetCommandControl() const
+{
+    auto command_control = pg_cluster_->GetDefaultCommandControl();
+
+    const auto kDeadline = utils::GetCallDeadline();
+    if (!kDeadline.IsReachable())
+        return command_control;
+
+    const auto kLeft = std::chrono::duration_cast<std::chrono::milliseconds>(
+        kDeadline.TimeLeft());
+
+    // A zero timeout would be no timeout at all
+    if (utils::IsCallAbandoned() || kLeft.count() <= 0)
+        throw CallAbandoned("Call is abandoned, query is not sent");
+
+    command_control.network_timeout_ms =
+        std::min(command_control.network_timeout_ms, kLeft);
+    command_control.statement_timeout_ms =
+        std::min(command_control.statement_timeout_ms, kLeft);
+
+    return command_control;
+}
+
 entities::GamePostgres
 PostgresManager::CreateGame(const entities::GameInfo& kGameIgdbInfo) const
 {
@@ -150,21 +376,21 @@ PostgresManager::CreateGame(const entities::GameInfo& kGameIgdbInfo) const
     try
     {
         const auto kResult = pg_cluster_->Execute(
-            userver::storages::postgres::ClusterHostType::kMaster, kInsertGame,
-            kGameIgdbInfo.id, kGameIgdbInfo.name, kGameIgdbInfo.slug,
-            kGameIgdbInfo.summary, kGameIgdbInfo.igdb_rating,
-            kGameIgdbInfo.hypes, kGameIgdbInfo.firstReleaseDate,
-            kGameIgdbInfo.releaseDates, kGameIgdbInfo.coverUrl,
-            kGameIgdbInfo.artworkUrls, kGameIgdbInfo.screenshots,
-            kGameIgdbInfo.genres, kGameIgdbInfo.themes,
-            kGameIgdbInfo.platforms);
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kInsertGame, kGameIgdbInfo.id,
+            kGameIgdbInfo.name, kGameIgdbInfo.slug, kGameIgdbInfo.summary,
+            kGameIgdbInfo.igdb_rating, kGameIgdbInfo.hypes,
+            kGameIgdbInfo.firstReleaseDate, kGameIgdbInfo.releaseDates,
+            kGameIgdbInfo.coverUrl, kGameIgdbInfo.artworkUrls,
+            kGameIgdbInfo.screenshots, kGameIgdbInfo.genres,
+            kGameIgdbInfo.themes, kGameIgdbInfo.platforms);
 
         return kResult.AsSingleRow<entities::GamePostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << e.what() << '\n';
+        LOG(GetLogLevel(e)) << e.what() << '\n';
     }
 
     return {};
@@ -176,15 +402,15 @@ PostgresManager::FindGame(std::string_view query, std::int32_t limit) const
     try
     {
         const auto kResult = pg_cluster_->Execute(
-            userver::storages::postgres::ClusterHostType::kMaster, kFindGame,
-            query, limit);
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kFindGame, query, limit);
 
         return kResult.AsContainer<GamesPostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << e.what() << '\n';
+        LOG(GetLogLevel(e)) << e.what() << '\n';
     }
 
     return {};
@@ -197,14 +423,15 @@ PostgresManager::GetGameBySlug(std::string_view slug) const
     {
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            pg::kGetGameBySlug, slug);
+            GetCommandControl(), pg::kGetGameBySlug, slug);
 
         return kResult.AsOptionalSingleRow<entities::GamePostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting game by slug: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting game by slug: " << e.what()
+                            << '\n';
     }
 
     return {};
@@ -217,14 +444,88 @@ PostgresManager::GetGameById(std::string_view postgresId) const
     {
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            pg::kGetGameByPostgresId, postgresId);
+            GetCommandControl(), pg::kGetGameByPostgresId, postgresId);
 
         return kResult.AsOptionalSingleRow<entities::GamePostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting game by uuid: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting game by uuid: " << e.what()
+                            << '\n';
+    }
+
+    return {};
+}
+
+PostgresManager::GamesPostgres
+PostgresManager::GetGamesByIds(const std::vector<std::string>& ids) const
+{
+    if (ids.empty())
+        return {};
+
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), pg::kGetGamesByIds, ids);
+
+        return kResult.AsContainer<GamesPostgres>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error getting games by ids: " << e.what()
+                            << '\n';
+    }
+
+    return {};
+}
+
+PostgresManager::GamesPostgres
+PostgresManager::GetGamesBySlugs(const std::vector<std::string>& slugs) const
+{
+    if (slugs.empty())
+        return {};
+
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), pg::kGetGamesBySlugs, slugs);
+
+        return kResult.AsContainer<GamesPostgres>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error getting games by slugs: " << e.what()
+                            << '\n';
+    }
+
+    return {};
+}
+
+PostgresManager::GamesPostgres
+PostgresManager::GetGamesByKeys(const std::vector<std::string>& ids,
+                                const std::vector<std::string>& slugs) const
+{
+    if (ids.empty() && slugs.empty())
+        return {};
+
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), pg::kGetGamesByKeys, ids, slugs);
+
+        return kResult.AsContainer<GamesPostgres>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error getting games by keys: " << e.what()
+                            << '\n';
     }
 
     return {};
@@ -238,14 +539,15 @@ PostgresManager::GetGamesByGenre(std::string_view genre,
     {
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            pg::kGetGamesByGenre, genre, limit);
+            GetCommandControl(), pg::kGetGamesByGenre, genre, limit);
 
         return kResult.AsContainer<GamesPostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting games by genre: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting games by genre: " << e.what()
+                            << '\n';
     }
     return {};
 }
@@ -257,14 +559,15 @@ PostgresManager::GetTopRatedGames(std::int32_t limit) const
     {
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            pg::kGetTopRatedGames, limit);
+            GetCommandControl(), pg::kGetTopRatedGames, limit);
 
         return kResult.AsContainer<GamesPostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting top rated games: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting top rated games: " << e.what()
+                            << '\n';
     }
     return {};
 }
@@ -276,14 +579,15 @@ PostgresManager::GetUpcomingGames(std::int32_t limit) const
     {
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            pg::kGetUpcomingGames, limit);
+            GetCommandControl(), pg::kGetUpcomingGames, limit);
 
         return kResult.AsContainer<GamesPostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting upcoming games: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting upcoming games: " << e.what()
+                            << '\n';
     }
     return {};
 }
@@ -314,39 +618,283 @@ PostgresManager::GetAllGames(std::int32_t limit, std::int32_t offset,
             "hypes, "
             "  first_release_date, release_dates, cover_url, artwork_urls, "
             "  screenshots, "
-            "  genres, themes, platforms, created_at, updated_at "
+            "  genres, themes, platforms, created_at, updated_at, "
+            "  igdb_synced_at "
             "FROM playhub.games "
             "ORDER BY {} DESC "
             "LIMIT $1 OFFSET $2",
             order_clause);
 
+        const userver::storages::postgres::Query kQuery{
+            query_str,
+            userver::storages::postgres::Query::Name{
+                fmt::format("get_all_games_by_{}", order_clause) }
+        };
+
         const auto kResult = pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            userver::storages::postgres::Query(query_str), limit, offset);
+            GetCommandControl(), kQuery, limit, offset);
 
         return kResult.AsContainer<GamesPostgres>(
             userver::storages::postgres::kRowTag);
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting upcoming games: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting upcoming games: " << e.what()
+                            << '\n';
     }
     return {};
 }
 
-void PostgresManager::UpdateGameRating(std::string_view game_id,
-                                       std::int32_t rating) const
+std::optional<bool>
+PostgresManager::UpdateGameRating(std::string_view game_id,
+                                  std::int32_t rating) const
 {
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kUpdateGameRating, game_id, rating);
+        return kResult.RowsAffected() > 0;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error updating game rating: " << e.what()
+                            << '\n';
+    }
+    return std::nullopt;
+}
+
+bool PostgresManager::AddGameViews(const std::vector<GameViews>& views) const
+{
+    if (views.empty())
+        return true;
+
+    std::vector<std::string> ids;
+    std::vector<std::int64_t> counts;
+    ids.reserve(views.size());
+    counts.reserve(views.size());
+    for (const auto& game : views)
+    {
+        ids.push_back(boost::uuids::to_string(game.id));
+        counts.push_back(game.views);
+    }
+
+    try
+    {
+        pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kAddGameViews, ids, counts);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error adding game views: " << e.what() << '\n';
+    }
+    return false;
+}
+
+std::vector<std::string>
+PostgresManager::GetRefreshCandidates(std::int32_t limit,
+                                      std::chrono::seconds stale_after) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kGetRefreshCandidates, limit,
+            static_cast<double>(stale_after.count()));
+
+        return kResult.AsContainer<std::vector<std::string>>();
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error getting refresh candidates: " << e.what()
+                            << '\n';
+    }
+    return {};
+}
+
+bool PostgresManager::MarkRefreshAttempted(
+    const std::vector<std::string>& igdb_ids) const
+{
+    if (igdb_ids.empty())
+        return true;
+
     try
     {
         pg_cluster_->Execute(
             userver::storages::postgres::ClusterHostType::kMaster,
-            kUpdateGameRating, game_id, rating);
+            GetCommandControl(), kMarkRefreshAttempted, igdb_ids);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error marking refresh attempts: " << e.what()
+                            << '\n';
+    }
+    return false;
+}
+
+std::chrono::seconds PostgresManager::GetMaxSyncLag() const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kGetMaxSyncLag);
+
+        return std::chrono::seconds{ kResult.AsSingleRow<std::int64_t>() };
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error getting sync lag: " << e.what() << '\n';
+    }
+    return std::chrono::seconds{ 0 };
+}
+
+std::optional<std::int64_t> PostgresManager::CountGames() const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kCountGames);
+
+        return kResult.AsSingleRow<std::int64_t>();
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error counting games: " << e.what() << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<std::int64_t> PostgresManager::EstimateGameCount() const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kEstimateGameCount);
+
+        const auto kEstimate = kResult.AsSingleRow<std::int64_t>();
+        if (kEstimate >= 0)
+            return kEstimate;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error estimating game count: " << e.what()
+                            << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<PostgresManager::GameKeys>
+PostgresManager::ScanGameKeys(std::string_view after_id,
+                              std::int32_t limit) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kScanGameKeys, after_id, limit);
+
+        return kResult.AsContainer<GameKeys>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error scanning game keys: " << e.what() << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<PostgresManager::GamesFeatures>
+PostgresManager::ScanGameFeatures(std::string_view after_id,
+                                  std::int32_t limit) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kScanGameFeatures, after_id, limit);
+
+        return kResult.AsContainer<GamesFeatures>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error scanning game features: " << e.what()
+                            << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<PostgresManager::GamesPostgres> PostgresManager::ScanGames(
+    std::string_view after_id,
+    userver::storages::postgres::TimePointWithoutTz updated_since,
+    std::int32_t limit) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kScanGames, after_id, updated_since, limit);
+
+        return kResult.AsContainer<GamesPostgres>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error scanning games: " << e.what() << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<PostgresManager::GamesPostgres>
+PostgresManager::ScanChanges(const ChangeCursor& after,
+                             std::chrono::milliseconds settle,
+                             std::int32_t limit) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kScanChanges, after.updated_at, after.id,
+            static_cast<double>(settle.count()), limit);
+
+        return kResult.AsContainer<GamesPostgres>(
+            userver::storages::postgres::kRowTag);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(GetLogLevel(e)) << "Error scanning changes: " << e.what() << '\n';
+    }
+    return std::nullopt;
+}
+
+std::optional<ChangeCursor>
+PostgresManager::GetLatestChangeCursor(std::chrono::milliseconds settle) const
+{
+    try
+    {
+        const auto kResult = pg_cluster_->Execute(
+            userver::storages::postgres::ClusterHostType::kMaster,
+            GetCommandControl(), kGetLatestChangeCursor,
+            static_cast<double>(settle.count()));
+
+        return kResult
+            .AsOptionalSingleRow<ChangeCursor>(
+                userver::storages::postgres::kRowTag)
+            .value_or(ChangeCursor{});
     }
     catch (const std::exception& e)
     {
-        LOG_ERROR() << "Error getting upcoming games: " << e.what() << '\n';
+        LOG(GetLogLevel(e)) << "Error getting latest change: " << e.what()
+                            << '\n';
     }
+    return std::nullopt;
 }
 
-} // namespace pg
\ No newline at end of file
+} // namespace pg
@@ -0,0 +1,45 @@
+// project headers
+#include <tools/deadline.hpp>
+
+// userver
+#include <userver/engine/task/cancel.hpp>
+#include <userver/engine/task/inherited_variable.hpp>
+
+namespace utils {
+
+namespace {
+
+userver::engine::TaskInheritedVariable<userver::engine::Deadline>
+    kCallDeadline;
+
+} // namespace
+
+userver::engine::Deadline GetCallDeadline()
+{
+    const auto* deadline = kCallDeadline.GetOptional();
+    return deadline ? *deadline : userver::engine::Deadline{};
+}
+
+bool IsCallAbandoned()
+{
+    return userver::engine::current_task::ShouldCancel() ||
+           GetCallDeadline().IsReached();
+}
+
+CallDeadlineScope::CallDeadlineScope(userver::engine::Deadline deadline)
+{
+    if (const auto* previous = kCallDeadline.GetOptional())
+        previous_ = *previous;
+
+    kCallDeadline.Set(deadline);
+}
+
+CallDeadlineScope::~CallDeadlineScope()
+{
+    if (previous_)
+        kCallDeadline.Set(*previous_);
+    else
+        kCallDeadline.Erase();
+}
+
+} // namespace utils
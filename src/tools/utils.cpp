@@ -2,12 +2,19 @@
 #include <tools/utils.hpp>
 
 // std
+#include <array>
+#include <cctype>
+#include <cstdio>
 #include <iostream>
 #include <regex>
 
 //userver
 #include <userver/utils/datetime.hpp>
 
+// boost
+#include <boost/uuid/string_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
 
 const std::string utils::TimestampToString(time_t timestamp)
 {
@@ -26,6 +33,48 @@ std::string utils::ForceOriginalQuality(const std::string& url)
     return "https:" + std::regex_replace(url, size_pattern, "/t_original/");
 }
 
+std::string utils::NormalizeQuery(std::string_view query)
+{
+    std::string normalized;
+    normalized.reserve(query.size());
+
+    bool pending_space = false;
+    for (const char kChar : query)
+    {
+        const auto kByte = static_cast<unsigned char>(kChar);
+
+        if (kByte < 0x80 && (std::isspace(kByte) || std::ispunct(kByte)))
+        {
+            pending_space = !normalized.empty();
+            continue;
+        }
+
+        if (pending_space)
+        {
+            normalized.push_back(' ');
+            pending_space = false;
+        }
+
+        normalized.push_back(
+            kByte < 0x80 ? static_cast<char>(std::tolower(kByte)) : kChar);
+    }
+
+    return normalized;
+}
+
+std::optional<std::string> utils::ToCanonicalUuid(std::string_view uuid)
+{
+    try
+    {
+        return boost::uuids::to_string(
+            boost::uuids::string_generator{}(uuid.begin(), uuid.end()));
+    }
+    catch (const std::exception&)
+    {
+        return std::nullopt;
+    }
+}
+
 ::google::protobuf::Timestamp utils::TimePointToProtobuf(
     const userver::storages::postgres::TimePointWithoutTz& time_point)
 {
@@ -42,3 +91,49 @@ std::string utils::ForceOriginalQuality(const std::string& url)
 
     return timestamp;
 }
+
+userver::storages::postgres::TimePointWithoutTz
+utils::ProtobufToTimePoint(const ::google::protobuf::Timestamp& timestamp)
+{
+    const auto kSinceEpoch = std::chrono::seconds{ timestamp.seconds() } +
+                             std::chrono::nanoseconds{ timestamp.nanos() };
+
+    return userver::storages::postgres::TimePointWithoutTz{
+        std::chrono::system_clock::time_point{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                kSinceEpoch) }
+    };
+}
+
+void utils::VersionToken::Add(
+    std::string_view id,
+    const userver::storages::postgres::TimePointWithoutTz& updated_at)
+{
+    const std::int64_t kMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            updated_at.GetUnderlying().time_since_epoch())
+            .count();
+
+    Mix(id.data(), id.size());
+    Mix(&kMicroseconds, sizeof(kMicroseconds));
+}
+
+std::string utils::VersionToken::Get() const
+{
+    std::array<char, 17> buffer{};
+    std::snprintf(buffer.data(), buffer.size(), "%016llx",
+                  static_cast<unsigned long long>(hash_));
+    return std::string(buffer.data());
+}
+
+void utils::VersionToken::Mix(const void* data, std::size_t size)
+{
+    constexpr std::uint64_t kPrime = 1099511628211ULL;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash_ ^= bytes[i];
+        hash_ *= kPrime;
+    }
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <handlers/admission_control.hpp>
+
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace game_service::test {
+
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_RejectsOverLimit)
+{
+    const MethodLimits kLimits{ Priority::kNormal, 2, 1, 4,
+                                milliseconds{ 100 } };
+    ConcurrencyLimiter limiter(kLimits);
+
+    EXPECT_TRUE(limiter.TryAcquire());
+    EXPECT_TRUE(limiter.TryAcquire());
+    EXPECT_FALSE(limiter.TryAcquire());
+
+    limiter.Release(milliseconds{ 1 });
+    EXPECT_TRUE(limiter.TryAcquire());
+}
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_ShrinksOnSlowCalls)
+{
+    const MethodLimits kLimits{ Priority::kNormal, 10, 2, 20,
+                                milliseconds{ 1 } };
+    ConcurrencyLimiter limiter(kLimits);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        ASSERT_TRUE(limiter.TryAcquire());
+        limiter.Release(milliseconds{ 2 });
+        std::this_thread::sleep_for(milliseconds{ 3 });
+    }
+
+    EXPECT_EQ(limiter.GetLimit(), 2u);
+    EXPECT_GE(limiter.GetExpectedLatency(), milliseconds{ 1 });
+}
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_SlowBurstShrinksOnce)
+{
+    const MethodLimits kLimits{ Priority::kNormal, 10, 2, 20,
+                                milliseconds{ 10 } };
+    ConcurrencyLimiter limiter(kLimits);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_TRUE(limiter.TryAcquire());
+        limiter.Release(std::chrono::seconds{ 5 });
+    }
+
+    EXPECT_EQ(limiter.GetLimit(), 9u);
+}
+
+TEST(AdmissionControlTest, AdmissionController_ExcludedLatencyIsNotSlow)
+{
+    AdmissionController controller;
+    const auto& limiter = controller.GetLimiter(RpcMethod::kSearchGames);
+    const auto kLimit = limiter.GetLimit();
+
+    {
+        auto permit =
+            controller.Admit(RpcMethod::kSearchGames, nanoseconds::max());
+        ASSERT_TRUE(permit);
+
+        std::this_thread::sleep_for(milliseconds{ 400 });
+        permit.ExcludeLatency(milliseconds{ 400 });
+    }
+
+    EXPECT_EQ(limiter.GetLimit(), kLimit);
+}
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_GrowsWhenSaturatedAndFast)
+{
+    const MethodLimits kLimits{ Priority::kNormal, 2, 1, 8,
+                                milliseconds{ 100 } };
+    ConcurrencyLimiter limiter(kLimits);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_TRUE(limiter.TryAcquire());
+        ASSERT_TRUE(limiter.TryAcquire());
+        limiter.Release(milliseconds{ 1 });
+        limiter.Release(milliseconds{ 1 });
+    }
+
+    EXPECT_GT(limiter.GetLimit(), 2u);
+    EXPECT_LE(limiter.GetLimit(), 8u);
+}
+
+TEST(AdmissionControlTest, AdmissionController_FailsFastOnShortDeadline)
+{
+    AdmissionController controller;
+
+    {
+        auto permit =
+            controller.Admit(RpcMethod::kGetGame, nanoseconds::max());
+        ASSERT_TRUE(permit);
+    }
+
+    auto permit = controller.Admit(RpcMethod::kGetGame, nanoseconds{ -1 });
+    EXPECT_FALSE(permit);
+    EXPECT_FALSE(permit.GetRejectReason().empty());
+}
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_SlowCallDoesNotRefuseDeadlines)
+{
+    ConcurrencyLimiter limiter(GetDefaultLimits(RpcMethod::kSearchGames));
+
+    ASSERT_TRUE(limiter.TryAcquire());
+    limiter.Release(std::chrono::seconds{ 5 });
+
+    // Deadlines longer than the target latency are still admitted
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(limiter.FitsDeadline(milliseconds{ 400 }));
+
+    // Shorter ones are refused, but some are let through to probe
+    int admitted = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (!limiter.FitsDeadline(milliseconds{ 100 }))
+            continue;
+        ++admitted;
+        ASSERT_TRUE(limiter.TryAcquire());
+        limiter.Release(milliseconds{ 10 });
+    }
+    EXPECT_GT(admitted, 0);
+    EXPECT_LT(admitted, 100);
+}
+
+TEST(AdmissionControlTest, ConcurrencyLimiter_StreamsSkipDeadlineCheck)
+{
+    ConcurrencyLimiter limiter(GetDefaultLimits(RpcMethod::kExportGames));
+
+    ASSERT_TRUE(limiter.TryAcquire());
+    limiter.Release(std::chrono::minutes{ 10 });
+
+    EXPECT_TRUE(limiter.FitsDeadline(std::chrono::seconds{ 30 }));
+}
+
+TEST(AdmissionControlTest, AdmissionController_ShedsBackgroundFirst)
+{
+    AdmissionController controller({ true, 10 });
+
+    std::vector<AdmissionController::Permit> permits;
+    for (int i = 0; i < 5; ++i)
+    {
+        permits.push_back(
+            controller.Admit(RpcMethod::kGetGame, nanoseconds::max()));
+        ASSERT_TRUE(permits.back());
+    }
+
+    EXPECT_FALSE(controller.Admit(RpcMethod::kSetRating, nanoseconds::max()));
+    EXPECT_TRUE(controller.Admit(RpcMethod::kSearchGames, nanoseconds::max()));
+    EXPECT_TRUE(controller.Admit(RpcMethod::kGetGame, nanoseconds::max()));
+
+    permits.clear();
+    EXPECT_EQ(controller.GetTotalInFlight(), 0u);
+    EXPECT_TRUE(controller.Admit(RpcMethod::kSetRating, nanoseconds::max()));
+}
+
+TEST(AdmissionControlTest, AdmissionController_Disabled)
+{
+    AdmissionController controller({ false, 0 });
+
+    EXPECT_TRUE(controller.Admit(RpcMethod::kSetRating, nanoseconds{ 0 }));
+    EXPECT_EQ(controller.GetTotalInFlight(), 0u);
+}
+
+} // namespace game_service::test
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <indexes/bloom_filter.hpp>
+
+#include <string>
+
+namespace indexes::test {
+
+TEST(BloomFilterTest, NoFalseNegatives)
+{
+    BloomFilter filter(1000, 0.01);
+
+    for (int i = 0; i < 1000; ++i)
+        filter.Add("game-" + std::to_string(i));
+
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(filter.MayContain("game-" + std::to_string(i)));
+}
+
+TEST(BloomFilterTest, FalsePositiveRateNearTarget)
+{
+    BloomFilter filter(10000, 0.01);
+
+    for (int i = 0; i < 10000; ++i)
+        filter.Add("game-" + std::to_string(i));
+
+    int false_positives = 0;
+    for (int i = 0; i < 10000; ++i)
+        if (filter.MayContain("missing-" + std::to_string(i)))
+            ++false_positives;
+
+    EXPECT_LT(false_positives, 300);
+    EXPECT_NEAR(filter.EstimateFalsePositiveRate(), 0.01, 0.01);
+}
+
+TEST(BloomFilterTest, SizedForTarget)
+{
+    BloomFilter filter(1000000, 0.01);
+
+    // ~9.6 bits and 7 hashes per key for 1%
+    EXPECT_EQ(filter.GetHashCount(), 7u);
+    EXPECT_GT(filter.GetMemoryBytes(), 1150000u);
+    EXPECT_LT(filter.GetMemoryBytes(), 1250000u);
+
+    EXPECT_FALSE(filter.MayContain("anything"));
+    EXPECT_EQ(filter.EstimateFalsePositiveRate(), 0.0);
+}
+
+} // namespace indexes::test
@@ -0,0 +1,181 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <managers/circuit_breaker.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+
+namespace igdb::test {
+
+using namespace std::chrono_literals;
+using testing::_;
+using testing::Return;
+using testing::Throw;
+
+class MockIGDBManager : public IIGDBManager
+{
+public:
+    MOCK_METHOD(GamesInfo, SearchGames, (std::string_view, std::int32_t),
+                (override));
+    MOCK_METHOD(GamesInfo, GetGameBySlug, (std::string_view), (override));
+    MOCK_METHOD(GamesInfo, GetGamesByGenre, (std::string_view, std::int32_t),
+                (override));
+    MOCK_METHOD(GamesInfo, GetUpcomingGames, (std::int32_t), (override));
+    MOCK_METHOD(GamesInfo, GetGamesByIds, (const std::vector<std::string>&),
+                (override));
+};
+
+BreakerSettings MakeSettings()
+{
+    BreakerSettings settings;
+    settings.window = 10s;
+    settings.min_calls = 4;
+    settings.failure_ratio = 0.5;
+    settings.slow_call = 1s;
+    settings.open_duration = 50ms;
+    settings.half_open_probes = 2;
+    return settings;
+}
+
+IIGDBManager::GamesInfo MakeGames()
+{
+    entities::GameInfo game;
+    game.name = "Hades";
+    return { game };
+}
+
+UTEST(CircuitBreakerTest, OpensOnFailuresAndSkipsIgdb)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, GetUpcomingGames(_))
+        .Times(4)
+        .WillRepeatedly(Throw(IgdbError("HTTP 503")));
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_THROW(breaker.GetUpcomingGames(5), IgdbError);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kOpen);
+    EXPECT_FALSE(breaker.IsAvailable());
+
+    EXPECT_THROW(breaker.GetUpcomingGames(5), IgdbError);
+    EXPECT_EQ(breaker.GetStatistics().rejected.Load().value, 1u);
+}
+
+UTEST(CircuitBreakerTest, ProbesCloseAfterOpenDuration)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, SearchGames(_, _))
+        .WillOnce(Throw(IgdbError("timeout")))
+        .WillOnce(Throw(IgdbError("timeout")))
+        .WillOnce(Throw(IgdbError("timeout")))
+        .WillOnce(Throw(IgdbError("timeout")))
+        .WillRepeatedly(Return(MakeGames()));
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_THROW(breaker.SearchGames("hades", 5), IgdbError);
+    ASSERT_EQ(breaker.GetState(), BreakerState::kOpen);
+
+    userver::engine::SleepFor(60ms);
+    EXPECT_TRUE(breaker.IsAvailable());
+
+    EXPECT_EQ(breaker.SearchGames("hades", 5).size(), 1u);
+    EXPECT_EQ(breaker.GetState(), BreakerState::kHalfOpen);
+
+    EXPECT_EQ(breaker.SearchGames("hades", 5).size(), 1u);
+    EXPECT_EQ(breaker.GetState(), BreakerState::kClosed);
+}
+
+UTEST(CircuitBreakerTest, FailedProbeReopens)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, GetGameBySlug(_))
+        .Times(5)
+        .WillRepeatedly(Throw(IgdbError("HTTP 500")));
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_THROW(breaker.GetGameBySlug("hades"), IgdbError);
+
+    userver::engine::SleepFor(60ms);
+    EXPECT_THROW(breaker.GetGameBySlug("hades"), IgdbError);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kOpen);
+    EXPECT_EQ(breaker.GetStatistics()
+                  .transitions[static_cast<std::size_t>(BreakerState::kOpen)]
+                  .Load()
+                  .value,
+              2u);
+}
+
+UTEST(CircuitBreakerTest, AbandonedCallsAreNotFailures)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, GetGamesByGenre(_, _))
+        .Times(6)
+        .WillRepeatedly(Throw(IgdbAbandoned("deadline exceeded")));
+
+    for (int i = 0; i < 6; ++i)
+        EXPECT_THROW(breaker.GetGamesByGenre("RPG", 5), IgdbAbandoned);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kClosed);
+    EXPECT_EQ(breaker.GetStatistics().failures.Load().value, 0u);
+}
+
+UTEST(CircuitBreakerTest, RejectedRequestsAreNotFailures)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, SearchGames(_, _))
+        .Times(10)
+        .WillRepeatedly(Throw(IgdbRejected("HTTP 400")));
+
+    for (int i = 0; i < 10; ++i)
+        EXPECT_THROW(breaker.SearchGames("\"hades", 5), IgdbRejected);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kClosed);
+    EXPECT_EQ(breaker.GetStatistics().failures.Load().value, 0u);
+}
+
+UTEST(CircuitBreakerTest, RefusedCredentialsAreFailures)
+{
+    MockIGDBManager igdb;
+    CircuitBreaker breaker(igdb, MakeSettings());
+
+    EXPECT_CALL(igdb, SearchGames(_, _))
+        .Times(4)
+        .WillRepeatedly(Throw(IgdbUnauthorized("HTTP 401")));
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_THROW(breaker.SearchGames("hades", 5), IgdbUnauthorized);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kOpen);
+}
+
+UTEST(CircuitBreakerTest, DisabledNeverOpens)
+{
+    MockIGDBManager igdb;
+    auto settings = MakeSettings();
+    settings.enabled = false;
+    CircuitBreaker breaker(igdb, settings);
+
+    EXPECT_CALL(igdb, GetGamesByIds(_))
+        .Times(8)
+        .WillRepeatedly(Throw(IgdbError("HTTP 503")));
+
+    for (int i = 0; i < 8; ++i)
+        EXPECT_THROW(breaker.GetGamesByIds({ "1" }), IgdbError);
+
+    EXPECT_EQ(breaker.GetState(), BreakerState::kClosed);
+    EXPECT_TRUE(breaker.IsAvailable());
+}
+
+} // namespace igdb::test
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <tools/deadline.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+#include <userver/utils/async.hpp>
+
+namespace utils::test {
+
+using namespace std::chrono_literals;
+
+UTEST(CallDeadline, UnreachableOutsideOfCall)
+{
+    EXPECT_FALSE(GetCallDeadline().IsReachable());
+    EXPECT_FALSE(IsCallAbandoned());
+}
+
+UTEST(CallDeadline, ScopeSetsAndRestores)
+{
+    {
+        CallDeadlineScope outer(userver::engine::Deadline::FromDuration(1h));
+        EXPECT_TRUE(GetCallDeadline().IsReachable());
+
+        {
+            CallDeadlineScope inner(userver::engine::Deadline{});
+            EXPECT_FALSE(GetCallDeadline().IsReachable());
+        }
+
+        EXPECT_TRUE(GetCallDeadline().IsReachable());
+    }
+
+    EXPECT_FALSE(GetCallDeadline().IsReachable());
+}
+
+UTEST(CallDeadline, AbandonedAfterDeadline)
+{
+    CallDeadlineScope scope(userver::engine::Deadline::FromDuration(10ms));
+    EXPECT_FALSE(IsCallAbandoned());
+
+    userver::engine::SleepFor(20ms);
+    EXPECT_TRUE(IsCallAbandoned());
+}
+
+UTEST(CallDeadline, InheritedBySubtasks)
+{
+    CallDeadlineScope scope(userver::engine::Deadline::FromDuration(1h));
+
+    auto task = userver::utils::Async("subtask", [] {
+        const bool kInherited = GetCallDeadline().IsReachable();
+
+        CallDeadlineScope detached(userver::engine::Deadline{});
+        return kInherited && !GetCallDeadline().IsReachable();
+    });
+
+    EXPECT_TRUE(task.Get());
+    EXPECT_TRUE(GetCallDeadline().IsReachable());
+}
+
+} // namespace utils::test
@@ -10,8 +10,12 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include <userver/engine/sleep.hpp>
+
 #include <handlers/game_grpc.hpp>
 #include <managers/manager.hpp>
+#include <refresh/refresh_scheduler.hpp>
+#include <refresh/stale_refresher.hpp>
 #include <repository/repository.hpp>
 #include <structs/game_info.hpp>
 #include <structs/game_postgres.hpp>
@@ -31,6 +35,14 @@ public:
                 (std::string_view), (const, override));
     MOCK_METHOD(std::optional<entities::GamePostgres>, GetGameById,
                 (std::string_view), (const, override));
+    MOCK_METHOD(std::vector<entities::GamePostgres>, GetGamesByIds,
+                (const std::vector<std::string>&), (const, override));
+    MOCK_METHOD(std::vector<entities::GamePostgres>, GetGamesBySlugs,
+                (const std::vector<std::string>&), (const, override));
+    MOCK_METHOD(std::vector<entities::GamePostgres>, GetGamesByKeys,
+                (const std::vector<std::string>&,
+                 const std::vector<std::string>&),
+                (const, override));
     MOCK_METHOD(std::vector<entities::GamePostgres>, GetGamesByGenre,
                 (std::string_view, std::int32_t), (const, override));
     MOCK_METHOD(std::vector<entities::GamePostgres>, GetTopRatedGames,
@@ -40,8 +52,36 @@ public:
     MOCK_METHOD(std::vector<entities::GamePostgres>, GetAllGames,
                 (std::int32_t, std::int32_t, ::games::SortingType),
                 (const, override));
-    MOCK_METHOD(void, UpdateGameRating, (std::string_view, std::int32_t),
+    MOCK_METHOD(std::optional<bool>, UpdateGameRating,
+                (std::string_view, std::int32_t), (const, override));
+    MOCK_METHOD(bool, AddGameViews, (const std::vector<entities::GameViews>&),
+                (const, override));
+    MOCK_METHOD(std::vector<std::string>, GetRefreshCandidates,
+                (std::int32_t, std::chrono::seconds), (const, override));
+    MOCK_METHOD(bool, MarkRefreshAttempted, (const std::vector<std::string>&),
+                (const, override));
+    MOCK_METHOD(std::chrono::seconds, GetMaxSyncLag, (), (const, override));
+    MOCK_METHOD(std::optional<std::int64_t>, CountGames, (),
+                (const, override));
+    MOCK_METHOD(std::optional<std::int64_t>, EstimateGameCount, (),
+                (const, override));
+    MOCK_METHOD(std::optional<std::vector<entities::GameKey>>, ScanGameKeys,
+                (std::string_view, std::int32_t), (const, override));
+    MOCK_METHOD(std::optional<std::vector<entities::GameFeatures>>,
+                ScanGameFeatures, (std::string_view, std::int32_t),
+                (const, override));
+    MOCK_METHOD(std::optional<std::vector<entities::GamePostgres>>, ScanGames,
+                (std::string_view,
+                 userver::storages::postgres::TimePointWithoutTz,
+                 std::int32_t),
+                (const, override));
+    MOCK_METHOD(std::optional<std::vector<entities::GamePostgres>>,
+                ScanChanges,
+                (const entities::ChangeCursor&, std::chrono::milliseconds,
+                 std::int32_t),
                 (const, override));
+    MOCK_METHOD(std::optional<entities::ChangeCursor>, GetLatestChangeCursor,
+                (std::chrono::milliseconds), (const, override));
 };
 
 class MockIGDBManager : public igdb::IIGDBManager
@@ -55,6 +95,8 @@ public:
                 (std::string_view, std::int32_t), (override));
     MOCK_METHOD(std::vector<entities::GameInfo>, GetUpcomingGames,
                 (std::int32_t), (override));
+    MOCK_METHOD(std::vector<entities::GameInfo>, GetGamesByIds,
+                (const std::vector<std::string>&), (override));
 };
 
 entities::GamePostgres CreateFakePostgresGame(std::string_view name)
@@ -66,6 +108,9 @@ entities::GamePostgres CreateFakePostgresGame(std::string_view name)
     game.igdb_id = "123";
     game.hypes = 100;
     game.playhub_rating = 42;
+    game.igdb_synced_at = userver::storages::postgres::TimePointTz{
+        std::chrono::system_clock::now()
+    };
     return game;
 }
 
@@ -86,6 +131,19 @@ protected:
         RegisterService(service_);
         StartServer();
     }
+
+    // One run of a sync of its own, which catches the index up by itself
+    // without a change feed
+    void Build(indexes::ICatalogIndex& index)
+    {
+        feed::FeedSettings settings;
+        settings.enabled = false;
+        feed::ChangeFeed feed(settings);
+
+        indexes::CatalogSync sync({}, feed);
+        sync.Add("test", index, std::chrono::hours{ 1 });
+        sync.Run(mock_repo_);
+    }
 };
 
 // --- 1. SEARCH GAMES ---
@@ -348,10 +406,12 @@ UTEST_F(GameServiceTest, ListGames_WithFilter)
 UTEST_F(GameServiceTest, SetRating_Success)
 {
     ::games::RatingRequest request;
-    request.set_game_id("valid-uuid");
+    request.set_game_id("00000000-0000-0000-0000-00000000000A");
     request.set_rating(10.0);
 
-    EXPECT_CALL(mock_repo_, UpdateGameRating("valid-uuid", 10.0)).Times(1);
+    EXPECT_CALL(mock_repo_, UpdateGameRating(
+                                "00000000-0000-0000-0000-00000000000a", 10.0))
+        .WillOnce(Return(true));
 
     auto client = MakeClient<::games::GameServiceClient>();
     EXPECT_NO_THROW(client.SetRating(request));
@@ -363,8 +423,7 @@ UTEST_F(GameServiceTest, SetRating_InvalidUuid)
     request.set_game_id("bad-uuid");
     request.set_rating(5.0);
 
-    EXPECT_CALL(mock_repo_, UpdateGameRating(_, _))
-        .WillOnce(Throw(std::runtime_error("Invalid UUID")));
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, _)).Times(0);
 
     auto client = MakeClient<::games::GameServiceClient>();
 
@@ -485,4 +544,922 @@ UTEST_F(GameServiceTest, SetRating_DbError)
     {
         EXPECT_NE(e.GetStatus().error_code(), grpc::StatusCode::OK);
     }
-}
\ No newline at end of file
+}
+
+UTEST_F(GameServiceTest, SetRating_UnknownGame)
+{
+    ::games::RatingRequest request;
+    request.set_game_id("00000000-0000-0000-0000-000000000001");
+    request.set_rating(5.0);
+
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, _))
+        .WillOnce(testing::Return(false));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    try
+    {
+        client.SetRating(request);
+        FAIL() << "Expected NOT_FOUND";
+    }
+    catch (const userver::ugrpc::client::ErrorWithStatus& e)
+    {
+        EXPECT_EQ(e.GetStatus().error_code(), grpc::StatusCode::NOT_FOUND);
+    }
+}
+
+// --- 8. STALE REFRESH ---
+UTEST_F(GameServiceTest, StaleRefresher_RefreshesInBackground)
+{
+    refresh::StaleRefresher refresher(mock_repo_, mock_igdb_, {});
+
+    auto stale_game = game_service::test::CreateFakePostgresGame("Quake");
+    stale_game.igdb_synced_at = userver::storages::postgres::TimePointTz{
+        std::chrono::system_clock::now() - std::chrono::hours{ 48 }
+    };
+
+    entities::GameInfo info;
+    info.slug = "Quake";
+
+    EXPECT_CALL(mock_igdb_, GetGameBySlug(testing::Eq("Quake")))
+        .WillOnce(testing::Return(std::vector<entities::GameInfo>{ info }));
+    EXPECT_CALL(mock_repo_, CreateGame(_))
+        .WillOnce(testing::Return(stale_game));
+
+    EXPECT_TRUE(refresher.IsStale(stale_game));
+    refresher.RefreshIfStale(stale_game);
+    refresher.RefreshIfStale(stale_game);
+
+    while (refresher.InFlight() != 0)
+        userver::engine::SleepFor(std::chrono::milliseconds{ 1 });
+}
+
+UTEST_F(GameServiceTest, StaleRefresher_SkipsFreshGames)
+{
+    refresh::StaleRefresher refresher(mock_repo_, mock_igdb_, {});
+
+    EXPECT_CALL(mock_igdb_, GetGameBySlug(_)).Times(0);
+
+    auto fresh_game = game_service::test::CreateFakePostgresGame("Hades");
+
+    EXPECT_FALSE(refresher.IsStale(fresh_game));
+    refresher.RefreshIfStale(fresh_game);
+    EXPECT_EQ(refresher.InFlight(), 0);
+}
+
+// --- 9. REFRESH SCHEDULER ---
+UTEST_F(GameServiceTest, RefreshScheduler_BatchesWithinBudget)
+{
+    refresh::SchedulerSettings settings;
+    settings.batch_size = 2;
+    settings.max_batches = 2;
+
+    refresh::RefreshScheduler scheduler(mock_repo_, mock_igdb_, settings);
+
+    EXPECT_CALL(mock_repo_, GetRefreshCandidates(testing::Eq(4), _))
+        .WillOnce(testing::Return(
+            std::vector<std::string>{ "1", "2", "3", "4" }));
+    EXPECT_CALL(mock_igdb_, GetGamesByIds(_))
+        .Times(2)
+        .WillRepeatedly(
+            testing::Return(std::vector<entities::GameInfo>(2)));
+    EXPECT_CALL(mock_repo_, CreateGame(_))
+        .Times(4)
+        .WillRepeatedly(testing::Return(entities::GamePostgres{}));
+    EXPECT_CALL(mock_repo_, GetMaxSyncLag())
+        .WillOnce(testing::Return(std::chrono::seconds{ 3600 }));
+
+    scheduler.RunOnce();
+
+    const auto& stats = scheduler.GetStatistics();
+    EXPECT_EQ(stats.batches.Load().value, 2);
+    EXPECT_EQ(stats.refreshed.Load().value, 4);
+    EXPECT_EQ(stats.lag_seconds.load(), 3600);
+}
+
+// --- 10. RPC STATISTICS ---
+UTEST_F(GameServiceTest, Statistics_CountStatusCodes)
+{
+    EXPECT_CALL(mock_repo_, GetGameById(_))
+        .WillOnce(testing::Return(std::nullopt));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::GetGameRequest request;
+    request.set_game_id("unknown-id");
+    EXPECT_THROW(client.GetGame(request),
+                 userver::ugrpc::client::ErrorWithStatus);
+
+    const auto& stats =
+        service_.GetStatistics().ForMethod(game_service::RpcMethod::kGetGame);
+    const auto kNotFound =
+        static_cast<std::size_t>(grpc::StatusCode::NOT_FOUND);
+
+    EXPECT_EQ(stats.status[kNotFound].Load().value, 1);
+    EXPECT_EQ(stats.status[0].Load().value, 0);
+}
+
+// --- 11. SEARCH CACHE ---
+UTEST_F(GameServiceTest, SearchGames_RepeatedQueryServedFromCache)
+{
+    auto game = game_service::test::CreateFakePostgresGame("The Witcher 3");
+    const auto kId = boost::uuids::to_string(game.id);
+
+    EXPECT_CALL(mock_repo_, FindGame(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+    EXPECT_CALL(mock_repo_,
+                GetGamesByIds(testing::ElementsAre(testing::Eq(kId))))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::SearchGamesRequest request;
+    request.set_query("Witcher");
+    request.set_limit(5);
+    EXPECT_EQ(client.SearchGames(request).games_size(), 1);
+
+    request.set_query("WITCHER");
+    auto response = client.SearchGames(request);
+
+    EXPECT_EQ(response.games_size(), 1);
+    EXPECT_EQ(response.games(0).id(), kId);
+}
+
+UTEST_F(GameServiceTest, SearchGames_PunctuatedQueryNotServedFromCache)
+{
+    auto game = game_service::test::CreateFakePostgresGame("The Witcher 3");
+
+    // ILIKE gives a different answer once the punctuation is part of it
+    EXPECT_CALL(mock_repo_, FindGame(testing::Eq("Witcher"), _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+    EXPECT_CALL(mock_repo_, FindGame(testing::Eq("  witcher!"), _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    EXPECT_CALL(mock_repo_, GetGamesByIds(_)).Times(0);
+    EXPECT_CALL(mock_igdb_, SearchGames(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameInfo>{}));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::SearchGamesRequest request;
+    request.set_query("Witcher");
+    request.set_limit(5);
+    EXPECT_EQ(client.SearchGames(request).games_size(), 1);
+
+    request.set_query("  witcher!");
+    EXPECT_EQ(client.SearchGames(request).games_size(), 0);
+}
+
+// --- 12. NEGATIVE CACHE ---
+UTEST_F(GameServiceTest, GetGamesByGenre_IgdbMissIsRemembered)
+{
+    EXPECT_CALL(mock_repo_, GetGamesByGenre(_, _))
+        .Times(2)
+        .WillRepeatedly(
+            testing::Return(std::vector<entities::GamePostgres>{}));
+    EXPECT_CALL(mock_igdb_, GetGamesByGenre(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameInfo>{}));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::GetGamesByGenreRequest request;
+    request.set_genre_name("Unknown Genre");
+    EXPECT_EQ(client.GetGamesByGenre(request).games_size(), 0);
+
+    request.set_genre_name("unknown  genre");
+    EXPECT_EQ(client.GetGamesByGenre(request).games_size(), 0);
+
+    EXPECT_EQ(service_.GetNegativeCache().GetStatistics().hits.Load().value,
+              1);
+}
+
+// --- 13. KNOWN GAMES FILTER ---
+UTEST_F(GameServiceTest, GetGame_UnknownGameAnsweredByFilter)
+{
+    auto game = game_service::test::CreateFakePostgresGame("Doom");
+    game.slug = "doom";
+    const auto kId = boost::uuids::to_string(game.id);
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameKeys(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameKey>{
+            { kId, game.slug } }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetKnownGames());
+
+    EXPECT_CALL(mock_repo_, GetGameBySlug(_)).Times(0);
+    EXPECT_CALL(mock_repo_, GetGameById(testing::Eq(kId)))
+        .WillOnce(testing::Return(
+            std::optional<entities::GamePostgres>{ game }));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::GetGameRequest request;
+    request.set_game_id(kId);
+    EXPECT_EQ(client.GetGame(request).game().name(), "Doom");
+
+    request.set_slug("no-such-game");
+    try
+    {
+        client.GetGame(request);
+        FAIL() << "Expected NOT_FOUND";
+    }
+    catch (const userver::ugrpc::client::ErrorWithStatus& e)
+    {
+        EXPECT_EQ(e.GetStatus().error_code(), grpc::StatusCode::NOT_FOUND);
+    }
+
+    EXPECT_EQ(
+        service_.GetKnownGames().GetStatistics().rejected.Load().value, 1u);
+}
+
+UTEST_F(GameServiceTest, GetGame_FindsGameInsertedElsewhereAfterFeedPoll)
+{
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameKeys(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameKey>{}));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetKnownGames());
+
+    // Inserted by another replica after the filter was built
+    auto game = game_service::test::CreateFakePostgresGame("Doom");
+    const auto kId = boost::uuids::to_string(game.id);
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+    auto& feed = service_.GetChangeFeed();
+    feed.Poll(mock_repo_);
+    feed.Poll(mock_repo_);
+
+    EXPECT_CALL(mock_repo_, GetGameById(testing::Eq(kId)))
+        .WillOnce(testing::Return(
+            std::optional<entities::GamePostgres>{ game }));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::GetGameRequest request;
+    request.set_game_id(kId);
+    EXPECT_EQ(client.GetGame(request).game().name(), "Doom");
+    EXPECT_EQ(
+        service_.GetKnownGames().GetStatistics().rejected.Load().value, 0u);
+}
+
+// --- 14. BATCH GET GAMES ---
+UTEST_F(GameServiceTest, BatchGetGames_KeepsRequestOrder)
+{
+    auto doom = game_service::test::CreateFakePostgresGame("Doom");
+    auto zelda = game_service::test::CreateFakePostgresGame("Zelda");
+    zelda.slug = "zelda";
+    const auto kDoomId = boost::uuids::to_string(doom.id);
+    const auto kMissingId =
+        boost::uuids::to_string(boost::uuids::random_generator()());
+
+    EXPECT_CALL(mock_repo_,
+                GetGamesByKeys(testing::ElementsAre(kDoomId, kMissingId),
+                               testing::ElementsAre("zelda")))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ zelda, doom }));
+
+    ::games::BatchGetGamesRequest request;
+    request.add_game_ids(kDoomId);
+    request.add_game_ids("not-a-uuid");
+    request.add_game_ids(kMissingId);
+    request.add_slugs("zelda");
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    auto response = client.BatchGetGames(request);
+
+    ASSERT_EQ(response.items_size(), 4);
+    EXPECT_TRUE(response.items(0).found());
+    EXPECT_EQ(response.items(0).game().name(), "Doom");
+    EXPECT_FALSE(response.items(1).found());
+    EXPECT_EQ(response.items(1).game_id(), "not-a-uuid");
+    EXPECT_FALSE(response.items(2).found());
+    EXPECT_TRUE(response.items(3).found());
+    EXPECT_EQ(response.items(3).game().name(), "Zelda");
+}
+
+// --- 15. EXPORT GAMES ---
+UTEST_F(GameServiceTest, ExportGames_StreamsChunksByKeyset)
+{
+    std::vector<entities::GamePostgres> first{
+        game_service::test::CreateFakePostgresGame("Doom"),
+        game_service::test::CreateFakePostgresGame("Quake")
+    };
+    std::vector<entities::GamePostgres> second{
+        game_service::test::CreateFakePostgresGame("Zelda")
+    };
+    const auto kLastOfFirst = boost::uuids::to_string(first.back().id);
+
+    EXPECT_CALL(mock_repo_, ScanGames(_, _, testing::Eq(2)))
+        .WillOnce(testing::Return(first));
+    EXPECT_CALL(mock_repo_, ScanGames(testing::Eq(kLastOfFirst), _, _))
+        .WillOnce(testing::Return(second));
+
+    ::games::ExportGamesRequest request;
+    request.set_chunk_size(2);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    auto stream = client.ExportGames(request);
+
+    std::vector<std::size_t> chunk_sizes;
+    ::games::ExportGamesChunk chunk;
+    while (stream.Read(chunk))
+        chunk_sizes.push_back(chunk.games_size());
+
+    EXPECT_THAT(chunk_sizes, testing::ElementsAre(2u, 1u));
+    EXPECT_EQ(chunk.last_id(), boost::uuids::to_string(second.back().id));
+}
+
+// --- 16. CHANGE FEED ---
+UTEST_F(GameServiceTest, ChangeFeed_SharesPolledChangesWithWatchers)
+{
+    const auto kNow = std::chrono::system_clock::now();
+    const entities::ChangeCursor kStart{
+        userver::storages::postgres::TimePointWithoutTz{ kNow },
+        boost::uuids::to_string(boost::uuids::random_generator()())
+    };
+
+    auto game = game_service::test::CreateFakePostgresGame("Doom");
+    game.updated_at = userver::storages::postgres::TimePointWithoutTz{
+        kNow + std::chrono::seconds{ 1 }
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(kStart));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+
+    auto& feed = service_.GetChangeFeed();
+    feed.Poll(mock_repo_);
+    ASSERT_TRUE(feed.GetHead());
+    EXPECT_EQ(feed.GetHead()->id, kStart.id);
+
+    feed.Poll(mock_repo_);
+    auto read = feed.ReadAfter(kStart, 10, {});
+    EXPECT_FALSE(read.behind);
+    ASSERT_EQ(read.changes.size(), 1u);
+    EXPECT_EQ(read.changes[0].game.name, "Doom");
+
+    const auto kToken = feed::EncodeResumeToken(read.changes[0].cursor);
+    const auto kDecoded = feed::DecodeResumeToken(kToken);
+    ASSERT_TRUE(kDecoded);
+    EXPECT_EQ(kDecoded->id, boost::uuids::to_string(game.id));
+    EXPECT_FALSE(feed::DecodeResumeToken("not-a-token"));
+
+    // Older than anything in memory, so Postgres has to be read
+    const entities::ChangeCursor kBefore{};
+    EXPECT_TRUE(feed.ReadAfter(kBefore, 10, {}).behind);
+}
+
+// --- 17. CONDITIONAL AND DELTA SYNC ---
+UTEST_F(GameServiceTest, GetGame_NotModifiedForKnownVersion)
+{
+    auto game = game_service::test::CreateFakePostgresGame("Doom");
+    const auto kId = boost::uuids::to_string(game.id);
+
+    EXPECT_CALL(mock_repo_, GetGameById(testing::Eq(kId)))
+        .Times(2)
+        .WillRepeatedly(testing::Return(
+            std::optional<entities::GamePostgres>{ game }));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    ::games::GetGameRequest request;
+    request.set_game_id(kId);
+    const auto kFirst = client.GetGame(request);
+    EXPECT_FALSE(kFirst.not_modified());
+    EXPECT_EQ(kFirst.game().name(), "Doom");
+
+    request.set_if_none_match(kFirst.version());
+    const auto kSecond = client.GetGame(request);
+    EXPECT_TRUE(kSecond.not_modified());
+    EXPECT_FALSE(kSecond.has_game());
+    EXPECT_EQ(kSecond.version(), kFirst.version());
+}
+
+UTEST_F(GameServiceTest, GetGamesUpdatedSince_PagesByWatermark)
+{
+    auto doom = game_service::test::CreateFakePostgresGame("Doom");
+    auto quake = game_service::test::CreateFakePostgresGame("Quake");
+
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, testing::Eq(2)))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ doom, quake }));
+
+    ::games::GetGamesUpdatedSinceRequest request;
+    request.set_limit(1);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.GetGamesUpdatedSince(request);
+
+    ASSERT_EQ(kResponse.games_size(), 1);
+    EXPECT_EQ(kResponse.games(0).name(), "Doom");
+    EXPECT_TRUE(kResponse.has_more());
+
+    const auto kWatermark = feed::DecodeResumeToken(kResponse.watermark());
+    ASSERT_TRUE(kWatermark);
+    EXPECT_EQ(kWatermark->id, boost::uuids::to_string(doom.id));
+
+    request.set_watermark("garbage");
+    try
+    {
+        client.GetGamesUpdatedSince(request);
+        FAIL() << "Expected INVALID_ARGUMENT";
+    }
+    catch (const userver::ugrpc::client::ErrorWithStatus& e)
+    {
+        EXPECT_EQ(e.GetStatus().error_code(),
+                  grpc::StatusCode::INVALID_ARGUMENT);
+    }
+}
+
+// --- 18. SIMILAR GAMES ---
+UTEST_F(GameServiceTest, GetSimilarGames_RanksBySharedFeatures)
+{
+    auto doom = game_service::test::CreateFakePostgresGame("Doom");
+    auto quake = game_service::test::CreateFakePostgresGame("Quake");
+    auto zelda = game_service::test::CreateFakePostgresGame("Zelda");
+
+    const auto kFeatures = [](const entities::GamePostgres& game,
+                              std::vector<std::string> genres,
+                              std::vector<std::string> platforms) {
+        return entities::GameFeatures{ game.id, std::move(genres),
+                                       {}, std::move(platforms) };
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            kFeatures(doom, { "shooter" }, { "pc", "ps5" }),
+            kFeatures(quake, { "shooter" }, { "pc" }),
+            kFeatures(zelda, { "adventure" }, { "switch" }) }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetSimilarGames());
+
+    const auto kQuakeId = boost::uuids::to_string(quake.id);
+    EXPECT_CALL(mock_repo_, GetGamesByIds(testing::ElementsAre(kQuakeId)))
+        .WillOnce(
+            testing::Return(std::vector<entities::GamePostgres>{ quake }));
+
+    ::games::GetSimilarGamesRequest request;
+    request.set_game_id(boost::uuids::to_string(doom.id));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.GetSimilarGames(request);
+
+    ASSERT_EQ(kResponse.games_size(), 1);
+    EXPECT_EQ(kResponse.games(0).game().name(), "Quake");
+    EXPECT_GT(kResponse.games(0).score(), 0.0);
+}
+
+// --- 19. FACETED BROWSING ---
+UTEST_F(GameServiceTest, ListFilteredGames_IntersectsFacets)
+{
+    auto doom = game_service::test::CreateFakePostgresGame("Doom");
+    auto quake = game_service::test::CreateFakePostgresGame("Quake");
+    auto zelda = game_service::test::CreateFakePostgresGame("Zelda");
+
+    const auto kFeatures = [](const entities::GamePostgres& game,
+                              std::vector<std::string> genres,
+                              std::vector<std::string> platforms,
+                              std::int32_t rating) {
+        return entities::GameFeatures{
+            game.id, std::move(genres), {}, std::move(platforms), "2020-01-01",
+            rating
+        };
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            kFeatures(doom, { "shooter" }, { "pc", "ps5" }, 80),
+            kFeatures(quake, { "shooter" }, { "pc" }, 90),
+            kFeatures(zelda, { "adventure" }, { "pc" }, 95) }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetFacets());
+
+    EXPECT_CALL(mock_repo_,
+                GetGamesByIds(testing::ElementsAre(
+                    boost::uuids::to_string(quake.id),
+                    boost::uuids::to_string(doom.id))))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ quake, doom }));
+
+    ::games::ListFilteredGamesRequest request;
+    request.add_genres("shooter");
+    request.add_platforms("pc");
+    request.add_platforms("switch");
+    request.set_filter(::games::SortingType::PLAYHUB_RATING);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.ListFilteredGames(request);
+
+    EXPECT_EQ(kResponse.total(), 2);
+    ASSERT_EQ(kResponse.games_size(), 2);
+    EXPECT_EQ(kResponse.games(0).name(), "Quake");
+    EXPECT_EQ(kResponse.games(1).name(), "Doom");
+}
+
+UTEST_F(GameServiceTest, GetFacetCounts_CountsUnderOtherFacets)
+{
+    auto doom = game_service::test::CreateFakePostgresGame("Doom");
+    auto quake = game_service::test::CreateFakePostgresGame("Quake");
+    auto zelda = game_service::test::CreateFakePostgresGame("Zelda");
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            { doom.id, { "shooter" }, {}, { "pc", "ps5" }, "1993-12-10", 80 },
+            { quake.id, { "shooter" }, {}, { "pc" }, "1996-06-22", 90 },
+            { zelda.id, { "adventure" }, {}, { "switch" }, "N/A", 95 } }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetFacets());
+
+    ::games::GetFacetCountsRequest request;
+    request.add_genres("shooter");
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.GetFacetCounts(request);
+
+    EXPECT_EQ(kResponse.total(), 2);
+
+    // Genres are counted as if no genre was picked
+    ASSERT_EQ(kResponse.genres_size(), 2);
+    EXPECT_EQ(kResponse.genres(0).value(), "shooter");
+    EXPECT_EQ(kResponse.genres(0).count(), 2);
+    EXPECT_EQ(kResponse.genres(1).value(), "adventure");
+    EXPECT_EQ(kResponse.genres(1).count(), 1);
+
+    ASSERT_EQ(kResponse.platforms_size(), 2);
+    EXPECT_EQ(kResponse.platforms(0).value(), "pc");
+    EXPECT_EQ(kResponse.platforms(0).count(), 2);
+    EXPECT_EQ(kResponse.platforms(1).value(), "ps5");
+    EXPECT_EQ(kResponse.platforms(1).count(), 1);
+
+    EXPECT_EQ(kResponse.release_years_size(), 2);
+}
+
+// --- 20. AUTOCOMPLETE ---
+UTEST_F(GameServiceTest, Autocomplete_RanksPrefixMatches)
+{
+    auto witcher = game_service::test::CreateFakePostgresGame("Witcher 3");
+    auto witness = game_service::test::CreateFakePostgresGame("The Witness");
+    auto wipeout = game_service::test::CreateFakePostgresGame("Wipeout");
+
+    const auto kFeatures = [](const entities::GamePostgres& game,
+                              std::string slug, std::int32_t rating) {
+        entities::GameFeatures features{};
+        features.id = game.id;
+        features.name = game.name;
+        features.slug = std::move(slug);
+        features.playhub_rating = rating;
+        return features;
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            kFeatures(witcher, "witcher-3", 90),
+            kFeatures(witness, "witness", 95),
+            kFeatures(wipeout, "wipeout", 70) }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetAutocomplete());
+
+    // Postgres is not asked for the suggestions
+    EXPECT_CALL(mock_repo_, FindGame(_, _)).Times(0);
+
+    ::games::AutocompleteRequest request;
+    request.set_prefix("Wit");
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.Autocomplete(request);
+
+    // "The Witness" matches by its slug
+    ASSERT_EQ(kResponse.suggestions_size(), 2);
+    EXPECT_EQ(kResponse.suggestions(0).name(), "The Witness");
+    EXPECT_EQ(kResponse.suggestions(1).name(), "Witcher 3");
+}
+
+// --- 21. SPELLING CORRECTION ---
+UTEST_F(GameServiceTest, SearchGames_CorrectsMisspelledQuery)
+{
+    auto game =
+        game_service::test::CreateFakePostgresGame("Witcher 3 Wild Hunt");
+
+    entities::GameFeatures features{};
+    features.id = game.id;
+    features.name = game.name;
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(
+            std::vector<entities::GameFeatures>{ features }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetSpelling());
+
+    EXPECT_CALL(mock_repo_, FindGame(testing::Eq("witchr 3"), _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    EXPECT_CALL(mock_repo_, FindGame(testing::Eq("witcher 3"), _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{ game }));
+    // The corrected query is answered without IGDB
+    EXPECT_CALL(mock_igdb_, SearchGames(_, _)).Times(0);
+
+    ::games::SearchGamesRequest request;
+    request.set_query("witchr 3");
+    request.set_limit(5);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.SearchGames(request);
+
+    ASSERT_EQ(kResponse.games_size(), 1);
+    EXPECT_EQ(kResponse.games(0).id(), boost::uuids::to_string(game.id));
+}
+
+// --- 22. SEMANTIC SEARCH ---
+UTEST_F(GameServiceTest, SemanticSearch_RanksBySummary)
+{
+    auto station = game_service::test::CreateFakePostgresGame("Derelict");
+    station.summary = "Survive on a derelict space station with friends";
+    station.genres = { "Survival" };
+    auto farm = game_service::test::CreateFakePostgresGame("Harvest");
+    farm.summary = "Grow crops and raise animals in a quiet village";
+    farm.genres = { "Simulator" };
+
+    const std::vector<entities::GamePostgres> kCatalog{ station, farm };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    // Once to count words, once to embed
+    EXPECT_CALL(mock_repo_, ScanGames(_, _, _))
+        .Times(2)
+        .WillRepeatedly(testing::Return(kCatalog));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetSemanticSearch());
+
+    EXPECT_CALL(mock_repo_, GetGamesByIds(testing::ElementsAre(
+                                testing::Eq(boost::uuids::to_string(
+                                    station.id)))))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ station }));
+
+    ::games::SemanticSearchRequest request;
+    request.set_query("co-op space survival");
+    request.set_limit(1);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.SemanticSearch(request);
+
+    ASSERT_EQ(kResponse.games_size(), 1);
+    EXPECT_EQ(kResponse.games(0).game().name(), "Derelict");
+    EXPECT_GT(kResponse.games(0).score(), 0.0);
+}
+
+// --- 23. TRENDING ---
+UTEST_F(GameServiceTest, GetTrendingGames_RanksRatingActivity)
+{
+    auto quiet = game_service::test::CreateFakePostgresGame("Quiet");
+    auto rated = game_service::test::CreateFakePostgresGame("Rated");
+
+    const auto kFeatures = [](const entities::GamePostgres& game) {
+        entities::GameFeatures features{};
+        features.id = game.id;
+        features.playhub_rating = game.playhub_rating;
+        features.hypes = game.hypes;
+        return features;
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            kFeatures(quiet), kFeatures(rated) }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetTrending());
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, 50))
+        .WillOnce(testing::Return(true));
+    ::games::RatingRequest rating;
+    rating.set_game_id(boost::uuids::to_string(rated.id));
+    rating.set_rating(50);
+    client.SetRating(rating);
+
+    // The rating change moves the game up without a query
+    EXPECT_CALL(mock_repo_,
+                GetGamesByIds(testing::ElementsAre(
+                    boost::uuids::to_string(rated.id),
+                    boost::uuids::to_string(quiet.id))))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ rated, quiet }));
+
+    ::games::GetDiscoveryRequest request;
+    request.set_limit(2);
+    const auto kResponse = client.GetTrendingGames(request);
+
+    ASSERT_EQ(kResponse.games_size(), 2);
+    EXPECT_EQ(kResponse.games(0).name(), "Rated");
+}
+
+UTEST_F(GameServiceTest, GetTrendingGames_IgnoresFailedRatingUpdate)
+{
+    auto rated = game_service::test::CreateFakePostgresGame("Rated");
+
+    entities::GameFeatures features{};
+    features.id = rated.id;
+    features.playhub_rating = rated.playhub_rating;
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(
+            std::vector<entities::GameFeatures>{ features }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    Build(service_.GetTrending());
+
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, 50))
+        .WillOnce(testing::Return(std::nullopt));
+    ::games::RatingRequest rating;
+    rating.set_game_id(boost::uuids::to_string(rated.id));
+    rating.set_rating(50);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    EXPECT_THROW(client.SetRating(rating),
+                 userver::ugrpc::client::ErrorWithStatus);
+
+    EXPECT_EQ(
+        service_.GetTrending().GetStatistics().rating_changes.Load().value,
+        0u);
+}
+
+// --- 24. VIEW COUNTERS ---
+UTEST_F(GameServiceTest, GetGame_ViewsAreFlushedInBatches)
+{
+    auto fake_game = game_service::test::CreateFakePostgresGame("Hades");
+    std::string str_id = boost::uuids::to_string(fake_game.id);
+
+    ::games::GetGameRequest request;
+    request.set_game_id(str_id);
+
+    EXPECT_CALL(mock_repo_, GetGameById(testing::Eq(str_id)))
+        .Times(3)
+        .WillRepeatedly(testing::Return(
+            std::optional<entities::GamePostgres>{ fake_game }));
+
+    // Nothing is written per call
+    EXPECT_CALL(mock_repo_, AddGameViews(_)).Times(0);
+    auto client = MakeClient<::games::GameServiceClient>();
+    for (int i = 0; i < 3; ++i)
+        client.GetGame(request);
+    testing::Mock::VerifyAndClearExpectations(&mock_repo_);
+
+    // A failed write is retried by the next flush
+    const auto kViews = [&fake_game](std::int64_t count) {
+        return testing::ElementsAre(testing::AllOf(
+            testing::Field(&entities::GameViews::id, fake_game.id),
+            testing::Field(&entities::GameViews::views, count)));
+    };
+    EXPECT_CALL(mock_repo_, AddGameViews(kViews(3)))
+        .WillOnce(testing::Return(false))
+        .WillOnce(testing::Return(true));
+
+    auto& views = service_.GetViewCounters();
+    EXPECT_EQ(views.Flush(mock_repo_).size(), 1u);
+    EXPECT_TRUE(views.Flush(mock_repo_).empty());
+    EXPECT_EQ(views.GetStatistics().pending_games.load(), 0);
+}
+
+// --- 25. GENRE LEADERBOARDS ---
+UTEST_F(GameServiceTest, GetGamesByGenre_ServedFromLeaderboard)
+{
+    auto low = game_service::test::CreateFakePostgresGame("Low");
+    low.genres = { "RPG" };
+    low.igdb_rating = 60;
+    low.playhub_rating = 90;
+    auto high = game_service::test::CreateFakePostgresGame("High");
+    high.genres = { "RPG" };
+    high.igdb_rating = 80;
+    high.playhub_rating = 10;
+
+    const auto kFeatures = [](const entities::GamePostgres& game) {
+        entities::GameFeatures features{};
+        features.id = game.id;
+        features.genres = game.genres;
+        features.playhub_rating = game.playhub_rating;
+        features.igdb_rating = game.igdb_rating;
+        return features;
+    };
+
+    EXPECT_CALL(mock_repo_, GetLatestChangeCursor(_))
+        .WillOnce(testing::Return(entities::ChangeCursor{}));
+    EXPECT_CALL(mock_repo_, ScanGameFeatures(_, _))
+        .WillOnce(testing::Return(std::vector<entities::GameFeatures>{
+            kFeatures(low), kFeatures(high) }));
+    EXPECT_CALL(mock_repo_, ScanChanges(_, _, _))
+        .WillOnce(testing::Return(std::vector<entities::GamePostgres>{}));
+    // The first consistency check, the only query of the genre
+    EXPECT_CALL(mock_repo_, GetGamesByGenre(testing::Eq("RPG"), _))
+        .WillOnce(
+            testing::Return(std::vector<entities::GamePostgres>{ high, low }));
+    Build(service_.GetLeaderboards());
+
+    EXPECT_CALL(mock_repo_,
+                GetGamesByIds(testing::ElementsAre(
+                    boost::uuids::to_string(high.id),
+                    boost::uuids::to_string(low.id))))
+        .WillOnce(testing::Return(
+            std::vector<entities::GamePostgres>{ high, low }));
+
+    ::games::GetGamesByGenreRequest request;
+    request.set_genre_name("RPG");
+    request.set_limit(2);
+
+    auto client = MakeClient<::games::GameServiceClient>();
+    const auto kResponse = client.GetGamesByGenre(request);
+
+    ASSERT_EQ(kResponse.games_size(), 2);
+    EXPECT_EQ(kResponse.games(0).name(), "High");
+
+    // The rating moves the game up the PlayHub leaderboard without a query
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, 95))
+        .WillOnce(testing::Return(true));
+    ::games::RatingRequest rating;
+    rating.set_game_id(boost::uuids::to_string(high.id));
+    rating.set_rating(95);
+    client.SetRating(rating);
+
+    ::games::GetGenreRankRequest rank;
+    rank.set_game_id(boost::uuids::to_string(high.id));
+    rank.set_genre_name("RPG");
+    const auto kRank = client.GetGenreRank(rank);
+
+    EXPECT_EQ(kRank.igdb_rank(), 1);
+    EXPECT_EQ(kRank.playhub_rank(), 1);
+    EXPECT_EQ(kRank.games(), 2);
+
+    // A rating Postgres didn't store leaves the leaderboard as it is
+    EXPECT_CALL(mock_repo_, UpdateGameRating(_, 0))
+        .WillOnce(testing::Return(std::nullopt));
+    rating.set_rating(0);
+    EXPECT_THROW(client.SetRating(rating),
+                 userver::ugrpc::client::ErrorWithStatus);
+
+    EXPECT_EQ(client.GetGenreRank(rank).playhub_rank(), 1);
+}
+
+// --- 26. TOTAL COUNTS ---
+UTEST_F(GameServiceTest, ListGames_TotalCountOnRequest)
+{
+    ::games::ListGamesRequest request;
+    request.set_limit(10);
+    request.set_offset(1000);
+
+    EXPECT_CALL(mock_repo_, GetAllGames(10, 1000, _))
+        .Times(3)
+        .WillRepeatedly(Return(std::vector<entities::GamePostgres>{}));
+
+    auto client = MakeClient<::games::GameServiceClient>();
+
+    // The facet index isn't built, the planner statistics answer
+    EXPECT_CALL(mock_repo_, EstimateGameCount())
+        .Times(2)
+        .WillRepeatedly(Return(std::optional<std::int64_t>{ 980 }));
+    request.set_total_count(::games::TotalCount::TOTAL_COUNT_ESTIMATED);
+    auto response = client.ListGames(request);
+    EXPECT_EQ(response.total(), 980);
+    EXPECT_EQ(response.total_count(),
+              ::games::TotalCount::TOTAL_COUNT_ESTIMATED);
+
+    EXPECT_CALL(mock_repo_, CountGames())
+        .WillOnce(Return(std::optional<std::int64_t>{ 1004 }))
+        .WillOnce(Return(std::nullopt));
+    request.set_total_count(::games::TotalCount::TOTAL_COUNT_EXACT);
+    response = client.ListGames(request);
+    EXPECT_EQ(response.total(), 1004);
+    EXPECT_EQ(response.total_count(), ::games::TotalCount::TOTAL_COUNT_EXACT);
+
+    // A failed count falls back to the estimate and says so
+    response = client.ListGames(request);
+    EXPECT_EQ(response.total(), 980);
+    EXPECT_EQ(response.total_count(),
+              ::games::TotalCount::TOTAL_COUNT_ESTIMATED);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <indexes/hnsw_index.hpp>
+#include <indexes/text_embedding.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace indexes::test {
+
+namespace {
+
+constexpr std::size_t kDimension = 16;
+
+std::vector<float> MakeUnitVectors(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::normal_distribution<float> normal;
+
+    std::vector<float> vectors(count * kDimension);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto* vector = vectors.data() + i * kDimension;
+        float squares = 0.0f;
+        for (std::size_t j = 0; j < kDimension; ++j)
+        {
+            vector[j] = normal(random);
+            squares += vector[j] * vector[j];
+        }
+        for (std::size_t j = 0; j < kDimension; ++j)
+            vector[j] /= std::sqrt(squares);
+    }
+    return vectors;
+}
+
+TextEmbedder::Vector Embed(const TextEmbedder& embedder,
+                           std::string_view normalized)
+{
+    TextEmbedder::Tokens tokens;
+    TextEmbedder::Tokenize(normalized, tokens);
+    return embedder.Embed(tokens);
+}
+
+float GetCosine(const TextEmbedder::Vector& lhs,
+                const TextEmbedder::Vector& rhs)
+{
+    return GetDotProduct(lhs.data(), rhs.data(), lhs.size());
+}
+
+} // namespace
+
+TEST(HnswIndexTest, FindsNodeByItsVector)
+{
+    const auto kVectors = MakeUnitVectors(500, 1);
+
+    HnswIndex index(kDimension, 8, 50);
+    for (std::size_t i = 0; i < 500; ++i)
+        EXPECT_EQ(index.Add(kVectors.data() + i * kDimension), i);
+
+    for (std::uint32_t node = 0; node < 500; node += 37)
+    {
+        const auto kFound = index.Search(index.GetVector(node), 1, 32);
+        ASSERT_EQ(kFound.size(), 1u);
+        EXPECT_EQ(kFound[0].node, node);
+        EXPECT_NEAR(kFound[0].similarity, 1.0f, 1e-5f);
+    }
+}
+
+TEST(HnswIndexTest, RecallAgainstScan)
+{
+    constexpr std::size_t kNodes = 2000;
+    constexpr std::size_t kQueries = 100;
+    constexpr std::size_t kK = 10;
+
+    const auto kVectors = MakeUnitVectors(kNodes, 2);
+    const auto kQueryVectors = MakeUnitVectors(kQueries, 3);
+
+    HnswIndex index(kDimension, 16, 100);
+    index.Reserve(kNodes);
+    for (std::size_t i = 0; i < kNodes; ++i)
+        index.Add(kVectors.data() + i * kDimension);
+
+    std::size_t found = 0;
+    for (std::size_t query = 0; query < kQueries; ++query)
+    {
+        const auto* vector = kQueryVectors.data() + query * kDimension;
+
+        std::vector<std::pair<float, std::uint32_t>> scanned;
+        for (std::uint32_t node = 0; node < kNodes; ++node)
+            scanned.emplace_back(
+                GetDotProduct(vector, index.GetVector(node), kDimension),
+                node);
+        std::partial_sort(scanned.begin(), scanned.begin() + kK,
+                          scanned.end(), [](const auto& lhs, const auto& rhs) {
+                              return lhs.first > rhs.first;
+                          });
+
+        const auto kNeighbors = index.Search(vector, kK, 64);
+        ASSERT_EQ(kNeighbors.size(), kK);
+        EXPECT_TRUE(std::is_sorted(kNeighbors.begin(), kNeighbors.end(),
+                                   [](const auto& lhs, const auto& rhs) {
+                                       return lhs.similarity > rhs.similarity;
+                                   }));
+
+        for (std::size_t i = 0; i < kK; ++i)
+            found += std::count_if(
+                kNeighbors.begin(), kNeighbors.end(),
+                [&](const auto& neighbor) {
+                    return neighbor.node == scanned[i].second;
+                });
+    }
+
+    EXPECT_GE(static_cast<double>(found) / (kQueries * kK), 0.95);
+}
+
+TEST(HnswIndexTest, EmptyIndexAndZeroQuery)
+{
+    HnswIndex index(kDimension, 8, 50);
+    const std::vector<float> kZero(kDimension, 0.0f);
+    EXPECT_TRUE(index.Search(kZero.data(), 5, 16).empty());
+
+    const auto kVectors = MakeUnitVectors(10, 4);
+    for (std::size_t i = 0; i < 10; ++i)
+        index.Add(kVectors.data() + i * kDimension);
+
+    EXPECT_TRUE(index.Search(kZero.data(), 5, 16).empty());
+    EXPECT_EQ(index.Search(kVectors.data(), 20, 16).size(), 10u);
+}
+
+TEST(TextEmbedderTest, SimilarTextsAreCloser)
+{
+    TextEmbedder embedder(128, 1 << 12);
+    for (const auto kText :
+         { "survive on a derelict space station with friends in co op",
+           "a cozy farming game about growing crops in a quiet village",
+           "race sports cars through city streets at night",
+           "survival crafting on an alien planet in space" })
+    {
+        TextEmbedder::Tokens tokens;
+        TextEmbedder::Tokenize(kText, tokens);
+        embedder.AddDocument(tokens);
+    }
+
+    const auto kQuery = Embed(embedder, "co op space survival");
+    const auto kStation = Embed(
+        embedder, "survive on a derelict space station with friends in co op");
+    const auto kFarming = Embed(
+        embedder, "a cozy farming game about growing crops in a quiet village");
+
+    EXPECT_NEAR(GetCosine(kStation, kStation), 1.0f, 1e-5f);
+    EXPECT_GT(GetCosine(kQuery, kStation), GetCosine(kQuery, kFarming));
+}
+
+TEST(TextEmbedderTest, UnknownWordsAreLeftOut)
+{
+    TextEmbedder embedder(64, 1 << 12);
+    TextEmbedder::Tokens tokens;
+    TextEmbedder::Tokenize("space survival", tokens);
+    embedder.AddDocument(tokens);
+
+    const auto kVector = Embed(embedder, "medieval kingdom");
+    EXPECT_TRUE(std::all_of(kVector.begin(), kVector.end(),
+                            [](float value) { return value == 0.0f; }));
+    EXPECT_EQ(embedder.GetDocumentCount(), 1u);
+}
+
+} // namespace indexes::test
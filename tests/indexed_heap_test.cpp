@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <indexes/indexed_heap.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace indexes::test {
+
+namespace {
+
+// Items by decreasing key, the order `Top` has to return
+std::vector<IndexedHeap::Item> SortByKey(const std::vector<double>& keys)
+{
+    std::vector<IndexedHeap::Item> items(keys.size());
+    for (std::size_t i = 0; i < items.size(); ++i)
+        items[i] = static_cast<IndexedHeap::Item>(i);
+    std::stable_sort(items.begin(), items.end(),
+                     [&keys](auto lhs, auto rhs) {
+                         return keys[lhs] > keys[rhs];
+                     });
+    return items;
+}
+
+} // namespace
+
+TEST(IndexedHeapTest, TopAfterAssign)
+{
+    IndexedHeap heap;
+    heap.Assign({ 3.0, 9.0, 1.0, 7.0, 5.0 });
+
+    EXPECT_EQ(heap.Size(), 5u);
+    EXPECT_EQ(heap.Top(3), (std::vector<IndexedHeap::Item>{ 1, 3, 4 }));
+    EXPECT_EQ(heap.Top(10),
+              (std::vector<IndexedHeap::Item>{ 1, 3, 4, 0, 2 }));
+    EXPECT_TRUE(heap.Top(0).empty());
+}
+
+TEST(IndexedHeapTest, KeysMoveBothWays)
+{
+    IndexedHeap heap;
+    heap.Assign({ 3.0, 9.0, 1.0, 7.0, 5.0 });
+
+    heap.Set(2, 10.0);
+    heap.Set(1, 0.0);
+    heap.Set(5, 6.0);
+
+    EXPECT_TRUE(heap.Contains(5));
+    EXPECT_FALSE(heap.Contains(6));
+    EXPECT_EQ(heap.GetKey(2), 10.0);
+    EXPECT_EQ(heap.Top(6),
+              (std::vector<IndexedHeap::Item>{ 2, 3, 5, 4, 0, 1 }));
+}
+
+TEST(IndexedHeapTest, RandomUpdatesAgainstSort)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> key(0.0, 1000.0);
+    std::uniform_int_distribution<IndexedHeap::Item> item(0, 999);
+
+    std::vector<double> keys(500);
+    for (auto& value : keys)
+        value = key(random);
+
+    IndexedHeap heap;
+    heap.Assign(keys);
+
+    // Items past the assigned ones are added by `Set`
+    for (int i = 0; i < 5000; ++i)
+    {
+        const auto kItem = item(random);
+        const auto kKey = key(random);
+        if (kItem >= keys.size())
+            keys.resize(kItem + 1, -1.0);
+        keys[kItem] = kKey;
+        heap.Set(kItem, kKey);
+    }
+
+    auto expected = SortByKey(keys);
+    expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                  [&heap](auto item) {
+                                      return !heap.Contains(item);
+                                  }),
+                   expected.end());
+
+    const auto kTop = heap.Top(50);
+    ASSERT_EQ(kTop.size(), 50u);
+    for (std::size_t i = 0; i < kTop.size(); ++i)
+        EXPECT_EQ(heap.GetKey(kTop[i]), keys[expected[i]]);
+}
+
+} // namespace indexes::test
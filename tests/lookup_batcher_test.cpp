@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <repository/lookup_batcher.hpp>
+
+#include <userver/utest/utest.hpp>
+#include <userver/utils/async.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace pg::test {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+GamePostgres MakeGame(const std::string& slug)
+{
+    GamePostgres game;
+    game.slug = slug;
+    return game;
+}
+
+struct CountingLoader
+{
+    IGameRepository::GamesPostgres
+    operator()(const std::vector<std::string>& keys) const
+    {
+        ++*calls;
+
+        IGameRepository::GamesPostgres games;
+        for (const auto& key : keys)
+            if (key != "missing")
+                games.push_back(MakeGame(key));
+        return games;
+    }
+
+    std::shared_ptr<std::atomic<int>> calls =
+        std::make_shared<std::atomic<int>>(0);
+};
+
+std::vector<std::optional<GamePostgres>>
+LoadConcurrently(LookupBatcher& batcher, const std::vector<std::string>& keys)
+{
+    std::vector<userver::engine::TaskWithResult<std::optional<GamePostgres>>>
+        tasks;
+    for (const auto& key : keys)
+        tasks.push_back(userver::utils::Async(
+            "lookup", [&batcher, key] { return batcher.Load(key); }));
+
+    std::vector<std::optional<GamePostgres>> results;
+    for (auto& task : tasks)
+        results.push_back(task.Get());
+    return results;
+}
+
+} // namespace
+
+UTEST(LookupBatcherTest, MergesConcurrentLookups)
+{
+    CountingLoader loader;
+    BatchSettings settings;
+    settings.window = 10ms;
+
+    LookupBatcher batcher(settings, loader,
+                          [](const GamePostgres& game) { return game.slug; });
+
+    const auto kResults =
+        LoadConcurrently(batcher, { "doom", "zelda", "missing", "doom" });
+
+    EXPECT_EQ(loader.calls->load(), 1);
+    ASSERT_TRUE(kResults[0]);
+    EXPECT_EQ(kResults[0]->slug, "doom");
+    ASSERT_TRUE(kResults[1]);
+    EXPECT_EQ(kResults[1]->slug, "zelda");
+    EXPECT_FALSE(kResults[2]);
+    ASSERT_TRUE(kResults[3]);
+    EXPECT_EQ(kResults[3]->slug, "doom");
+
+    EXPECT_EQ(batcher.GetStatistics().lookups.Load().value, 4u);
+    EXPECT_EQ(batcher.GetStatistics().batches.Load().value, 1u);
+}
+
+UTEST(LookupBatcherTest, FullBatchIsSentRightAway)
+{
+    CountingLoader loader;
+    BatchSettings settings;
+    settings.window = 10s;
+    settings.max_batch = 2;
+
+    LookupBatcher batcher(settings, loader,
+                          [](const GamePostgres& game) { return game.slug; });
+
+    const auto kResults = LoadConcurrently(batcher, { "a", "b", "c", "d" });
+
+    EXPECT_EQ(loader.calls->load(), 2);
+    for (const auto& result : kResults)
+        EXPECT_TRUE(result);
+}
+
+} // namespace pg::test
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <cache/negative_cache.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+
+namespace cache::test {
+
+using namespace std::chrono_literals;
+
+UTEST(NegativeCacheTest, RemembersMissesPerMethod)
+{
+    NegativeCache cache(NegativeCacheSettings{});
+
+    cache.Add("SearchGames", "hlaf life");
+
+    EXPECT_TRUE(cache.Contains("SearchGames", "hlaf life"));
+    EXPECT_FALSE(cache.Contains("GetGamesByGenre", "hlaf life"));
+    EXPECT_FALSE(cache.Contains("SearchGames", "half life"));
+
+    const auto& stats = cache.GetStatistics();
+    EXPECT_EQ(stats.hits.Load().value, 1u);
+    EXPECT_EQ(stats.misses.Load().value, 2u);
+}
+
+UTEST(NegativeCacheTest, BoundedAndExpiring)
+{
+    NegativeCacheSettings settings;
+    settings.shards = 1;
+    settings.capacity = 2;
+    settings.ttl = 10ms;
+    NegativeCache cache(settings);
+
+    cache.Add("SearchGames", "a");
+    cache.Add("SearchGames", "b");
+    cache.Add("SearchGames", "c");
+    EXPECT_EQ(cache.GetSize(), 2u);
+
+    userver::engine::SleepFor(20ms);
+    EXPECT_FALSE(cache.Contains("SearchGames", "c"));
+}
+
+} // namespace cache::test
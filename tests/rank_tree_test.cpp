@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <indexes/rank_tree.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace indexes::test {
+
+namespace {
+
+// Items of `keys` in the order of the tree: decreasing key, then item
+std::vector<RankTree::Item>
+SortByKey(const std::map<RankTree::Item, double>& keys)
+{
+    std::vector<std::pair<double, RankTree::Item>> order;
+    for (const auto& [kItem, kKey] : keys)
+        order.emplace_back(-kKey, kItem);
+    std::sort(order.begin(), order.end());
+
+    std::vector<RankTree::Item> items;
+    for (const auto& [kKey, kItem] : order)
+        items.push_back(kItem);
+    return items;
+}
+
+} // namespace
+
+TEST(RankTreeTest, TopAndRanks)
+{
+    RankTree tree;
+    tree.Set(10, 3.0);
+    tree.Set(11, 9.0);
+    tree.Set(12, 1.0);
+    tree.Set(13, 9.0);
+
+    EXPECT_EQ(tree.Size(), 4u);
+    EXPECT_EQ(tree.Top(3), (std::vector<RankTree::Item>{ 11, 13, 10 }));
+    EXPECT_EQ(tree.GetRank(11), 0u);
+    EXPECT_EQ(tree.GetRank(13), 1u);
+    EXPECT_EQ(tree.GetRank(12), 3u);
+    EXPECT_EQ(tree.GetRank(14), std::nullopt);
+    EXPECT_TRUE(tree.Top(0).empty());
+}
+
+TEST(RankTreeTest, MovesAndErases)
+{
+    RankTree tree;
+    tree.Set(1, 5.0);
+    tree.Set(2, 4.0);
+    tree.Set(3, 3.0);
+
+    tree.Set(3, 6.0);
+    tree.Erase(1);
+    tree.Erase(7);
+
+    EXPECT_FALSE(tree.Contains(1));
+    EXPECT_EQ(tree.GetKey(3), 6.0);
+    EXPECT_EQ(tree.Top(5), (std::vector<RankTree::Item>{ 3, 2 }));
+    EXPECT_EQ(tree.GetRank(2), 1u);
+
+    // The erased node is reused
+    tree.Set(1, 1.0);
+    EXPECT_EQ(tree.Top(5), (std::vector<RankTree::Item>{ 3, 2, 1 }));
+}
+
+TEST(RankTreeTest, RandomUpdatesAgainstSort)
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> key(0, 100);
+    std::uniform_int_distribution<RankTree::Item> item(0, 999);
+
+    RankTree tree;
+    std::map<RankTree::Item, double> keys;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const auto kItem = item(random);
+        if (i % 5 == 0)
+        {
+            tree.Erase(kItem);
+            keys.erase(kItem);
+            continue;
+        }
+
+        const auto kKey = static_cast<double>(key(random));
+        tree.Set(kItem, kKey);
+        keys[kItem] = kKey;
+    }
+
+    const auto kExpected = SortByKey(keys);
+    ASSERT_EQ(tree.Size(), kExpected.size());
+    EXPECT_EQ(tree.Top(kExpected.size()), kExpected);
+    for (std::size_t rank = 0; rank < kExpected.size(); ++rank)
+        EXPECT_EQ(tree.GetRank(kExpected[rank]), rank);
+}
+
+} // namespace indexes::test
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <indexes/roaring_bitmap.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace indexes::test {
+
+namespace {
+
+std::vector<std::uint32_t> ToVector(const std::set<std::uint32_t>& values)
+{
+    return { values.begin(), values.end() };
+}
+
+} // namespace
+
+TEST(RoaringBitmapTest, AddRemoveContains)
+{
+    RoaringBitmap bitmap;
+    bitmap.Add(7);
+    bitmap.Add(70000);
+    bitmap.Add(7);
+
+    EXPECT_TRUE(bitmap.Contains(7));
+    EXPECT_TRUE(bitmap.Contains(70000));
+    EXPECT_FALSE(bitmap.Contains(8));
+    EXPECT_EQ(bitmap.GetCardinality(), 2u);
+
+    bitmap.Remove(7);
+    bitmap.Remove(9);
+    EXPECT_FALSE(bitmap.Contains(7));
+    EXPECT_EQ(bitmap.ToVector(), std::vector<std::uint32_t>{ 70000 });
+
+    bitmap.Remove(70000);
+    EXPECT_TRUE(bitmap.IsEmpty());
+}
+
+// Containers turn into bitmaps and back as they fill up and empty out
+TEST(RoaringBitmapTest, DenseContainers)
+{
+    RoaringBitmap bitmap;
+    for (std::uint32_t i = 0; i < 10000; ++i)
+        bitmap.Add(i * 2);
+
+    EXPECT_EQ(bitmap.GetCardinality(), 10000u);
+    EXPECT_TRUE(bitmap.Contains(19998));
+    EXPECT_FALSE(bitmap.Contains(19999));
+
+    for (std::uint32_t i = 0; i < 9000; ++i)
+        bitmap.Remove(i * 2);
+
+    EXPECT_EQ(bitmap.GetCardinality(), 1000u);
+    EXPECT_EQ(bitmap.ToVector().front(), 18000u);
+}
+
+TEST(RoaringBitmapTest, SetOperationsMatchStdSet)
+{
+    std::mt19937 random(42);
+
+    for (const std::uint32_t kRange : { 5000u, 100000u, 4000000u })
+    {
+        RoaringBitmap lhs;
+        RoaringBitmap rhs;
+        std::set<std::uint32_t> lhs_values;
+        std::set<std::uint32_t> rhs_values;
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            const auto kLeft = random() % kRange;
+            const auto kRight = random() % kRange;
+            lhs.Add(kLeft);
+            rhs.Add(kRight);
+            lhs_values.insert(kLeft);
+            rhs_values.insert(kRight);
+        }
+
+        std::set<std::uint32_t> intersection;
+        std::set_intersection(lhs_values.begin(), lhs_values.end(),
+                              rhs_values.begin(), rhs_values.end(),
+                              std::inserter(intersection, intersection.end()));
+        std::set<std::uint32_t> union_values;
+        std::set_union(lhs_values.begin(), lhs_values.end(),
+                       rhs_values.begin(), rhs_values.end(),
+                       std::inserter(union_values, union_values.end()));
+
+        EXPECT_EQ((lhs & rhs).ToVector(), ToVector(intersection));
+        EXPECT_EQ((lhs | rhs).ToVector(), ToVector(union_values));
+        EXPECT_EQ((lhs & rhs).GetCardinality(), intersection.size());
+        EXPECT_EQ(GetIntersectionCardinality(lhs, rhs), intersection.size());
+    }
+}
+
+} // namespace indexes::test
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cache/lru_cache.hpp>
+#include <cache/search_cache.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+
+#include <string>
+
+namespace cache::test {
+
+using namespace std::chrono_literals;
+
+UTEST(ShardedLruCacheTest, EvictsLeastRecentlyUsed)
+{
+    ShardedLruCache<std::string, int> cache(1, 2, 1h);
+
+    cache.Put("a", 1);
+    cache.Put("b", 2);
+    EXPECT_EQ(cache.Get("a"), 1);
+
+    cache.Put("c", 3);
+
+    EXPECT_EQ(cache.Get("a"), 1);
+    EXPECT_FALSE(cache.Get("b"));
+    EXPECT_EQ(cache.Get("c"), 3);
+    EXPECT_EQ(cache.GetStatistics().evictions.Load().value, 1u);
+}
+
+UTEST(ShardedLruCacheTest, ExpiresAfterTtl)
+{
+    ShardedLruCache<std::string, int> cache(4, 16, 10ms);
+
+    cache.Put("a", 1);
+    EXPECT_EQ(cache.Get("a"), 1);
+
+    userver::engine::SleepFor(20ms);
+
+    EXPECT_FALSE(cache.Get("a"));
+    EXPECT_EQ(cache.GetSize(), 0u);
+}
+
+UTEST(ShardedLruCacheTest, EraseIf)
+{
+    ShardedLruCache<std::string, int> cache(4, 16, 1h);
+
+    for (int i = 0; i < 8; ++i)
+        cache.Put(std::to_string(i), i);
+
+    EXPECT_EQ(cache.EraseIf([](const std::string&, int value) {
+        return value % 2 == 0;
+    }),
+              4u);
+    EXPECT_EQ(cache.GetSize(), 4u);
+    EXPECT_FALSE(cache.Get("2"));
+    EXPECT_EQ(cache.Get("3"), 3);
+}
+
+UTEST(SearchCacheTest, KeyedByQueryAndLimit)
+{
+    SearchCache cache(SearchCacheSettings{});
+
+    cache.Put("witcher", 5, { "id-1", "id-2" });
+
+    EXPECT_EQ(cache.Get("witcher", 5), (SearchCache::Ids{ "id-1", "id-2" }));
+    EXPECT_FALSE(cache.Get("witcher", 10));
+    EXPECT_FALSE(cache.Get("witcher 3", 5));
+}
+
+UTEST(SearchCacheTest, IgnoresCaseOnly)
+{
+    SearchCache cache(SearchCacheSettings{});
+
+    cache.Put("Witcher", 5, { "id-1" });
+
+    EXPECT_TRUE(cache.Get("WITCHER", 5));
+    EXPECT_FALSE(cache.Get("witcher!", 5));
+}
+
+UTEST(SearchCacheTest, EmptyIdsAreNotAHit)
+{
+    SearchCache cache(SearchCacheSettings{});
+
+    cache.Put("witcher", 5, {});
+
+    EXPECT_FALSE(cache.Get("witcher", 5));
+}
+
+UTEST(SearchCacheTest, InvalidatesMatchingQueries)
+{
+    SearchCache cache(SearchCacheSettings{});
+
+    cache.Put("witcher", 5, { "id-1" });
+    cache.Put("wild hunt", 5, { "id-1" });
+    cache.Put("hades", 5, { "id-2" });
+
+    cache.InvalidateMatching("The Witcher 4");
+
+    EXPECT_FALSE(cache.Get("witcher", 5));
+    EXPECT_TRUE(cache.Get("wild hunt", 5));
+    EXPECT_TRUE(cache.Get("hades", 5));
+}
+
+UTEST(SearchCacheTest, Disabled)
+{
+    SearchCacheSettings settings;
+    settings.enabled = false;
+    SearchCache cache(settings);
+
+    cache.Put("witcher", 5, { "id-1" });
+    EXPECT_FALSE(cache.Get("witcher", 5));
+}
+
+} // namespace cache::test
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <indexes/spelling_dictionary.hpp>
+
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace indexes::test {
+
+namespace {
+
+SpellingDictionary MakeDictionary(std::initializer_list<std::string_view> words)
+{
+    SpellingDictionary dictionary(2, 7);
+    for (const auto kWord : words)
+        dictionary.Add(kWord);
+    dictionary.Build(1000);
+    return dictionary;
+}
+
+} // namespace
+
+TEST(SpellingDictionaryTest, EditDistance)
+{
+    EXPECT_EQ(GetEditDistance("witcher", "witcher", 2), 0u);
+    EXPECT_EQ(GetEditDistance("witcher", "witchr", 2), 1u);
+    EXPECT_EQ(GetEditDistance("witcher", "wticher", 2), 1u);
+    EXPECT_EQ(GetEditDistance("hunt", "hnut", 2), 1u);
+    EXPECT_EQ(GetEditDistance("", "abc", 5), 3u);
+    // Anything past the limit is reported as limit + 1
+    EXPECT_EQ(GetEditDistance("witcher", "portal", 2), 3u);
+}
+
+TEST(SpellingDictionaryTest, CorrectsWords)
+{
+    const auto kDictionary =
+        MakeDictionary({ "the", "witcher", "wild", "hunt", "portal" });
+
+    EXPECT_EQ(kDictionary.Correct("witchr"), "witcher");
+    EXPECT_EQ(kDictionary.Correct("wticher"), "witcher");
+    EXPECT_EQ(kDictionary.Correct("witcher"), "witcher");
+    EXPECT_EQ(kDictionary.Correct("portl"), "portal");
+    EXPECT_EQ(kDictionary.Correct("qqqqqq"), std::nullopt);
+    // Short words are corrected by one edit at most
+    EXPECT_EQ(kDictionary.Correct("hxxt"), std::nullopt);
+}
+
+TEST(SpellingDictionaryTest, TypoPastPrefix)
+{
+    const auto kDictionary = MakeDictionary({ "assassins", "creed" });
+
+    EXPECT_EQ(kDictionary.Correct("assassns"), "assassins");
+}
+
+TEST(SpellingDictionaryTest, PrefersFrequentWords)
+{
+    const auto kDictionary =
+        MakeDictionary({ "halo", "hale", "hale", "hale", "halo" });
+
+    // Both are one edit away, "hale" is more frequent
+    EXPECT_EQ(kDictionary.Correct("halx"), "hale");
+}
+
+TEST(SpellingDictionaryTest, KeepsMostFrequentWords)
+{
+    SpellingDictionary dictionary(2, 7);
+    dictionary.Add("doom");
+    dictionary.Add("doom");
+    dictionary.Add("quake");
+    dictionary.Build(1);
+
+    EXPECT_EQ(dictionary.GetWordCount(), 1u);
+    EXPECT_EQ(dictionary.Correct("dooom"), "doom");
+    EXPECT_EQ(dictionary.Correct("quakke"), std::nullopt);
+}
+
+TEST(SpellingDictionaryTest, CorrectsQueries)
+{
+    const auto kDictionary =
+        MakeDictionary({ "the", "witcher", "wild", "hunt" });
+
+    EXPECT_EQ(kDictionary.CorrectQuery("the witchr 3 wlid hnut"),
+              "the witcher 3 wild hunt");
+    EXPECT_EQ(kDictionary.CorrectQuery("witcher 3"), std::nullopt);
+    EXPECT_EQ(kDictionary.CorrectQuery("qqqqqq"), std::nullopt);
+}
+
+TEST(SpellingDictionaryTest, EmptyUntilBuilt)
+{
+    SpellingDictionary dictionary(2, 7);
+    dictionary.Add("witcher");
+
+    EXPECT_EQ(dictionary.Correct("witchr"), std::nullopt);
+    EXPECT_EQ(dictionary.GetWordCount(), 0u);
+}
+
+} // namespace indexes::test
@@ -2,6 +2,8 @@
 #include <tools/utils.hpp>
 
 #include <cstdlib>
+#include <utility>
+#include <vector>
 #include <userver/utils/datetime.hpp>
 
 namespace utils::test {
@@ -68,6 +70,37 @@ TEST_F(UtilsTest, TimestampToString_Negative)
     EXPECT_EQ(utils::TimestampToString(-100), "N/A");
 }
 
+TEST_F(UtilsTest, NormalizeQuery_FoldsCaseAndPunctuation)
+{
+    EXPECT_EQ(utils::NormalizeQuery("  The   WITCHER 3:\tWild-Hunt!! "),
+              "the witcher 3 wild hunt");
+    EXPECT_EQ(utils::NormalizeQuery("Baldur's Gate"), "baldur s gate");
+}
+
+TEST_F(UtilsTest, NormalizeQuery_KeepsUtf8)
+{
+    EXPECT_EQ(utils::NormalizeQuery("Pokémon  Légendes"),
+              "pokémon légendes");
+}
+
+TEST_F(UtilsTest, NormalizeQuery_OnlyPunctuation)
+{
+    EXPECT_EQ(utils::NormalizeQuery(" ?! ... "), "");
+}
+
+TEST_F(UtilsTest, ToCanonicalUuid_AcceptsPostgresSpellings)
+{
+    const std::string kCanonical = "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11";
+
+    EXPECT_EQ(utils::ToCanonicalUuid("A0EEBC99-9C0B-4EF8-BB6D-6BB9BD380A11"),
+              kCanonical);
+    EXPECT_EQ(utils::ToCanonicalUuid("{a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11}"),
+              kCanonical);
+    EXPECT_EQ(utils::ToCanonicalUuid("a0eebc999c0b4ef8bb6d6bb9bd380a11"),
+              kCanonical);
+    EXPECT_EQ(utils::ToCanonicalUuid("unknown-id"), std::nullopt);
+}
+
 TEST_F(UtilsTest, TimePointToProtobuf_Conversion)
 {
     std::string time_str = "2023-10-10T12:00:00+0000";
@@ -82,6 +115,17 @@ TEST_F(UtilsTest, TimePointToProtobuf_Conversion)
     EXPECT_EQ(proto_ts.seconds(), expected_seconds);
 }
 
+TEST_F(UtilsTest, ProtobufToTimePoint_RoundTrip)
+{
+    ::google::protobuf::Timestamp timestamp;
+    timestamp.set_seconds(1696939200);
+
+    const auto kTimePoint = utils::ProtobufToTimePoint(timestamp);
+
+    EXPECT_EQ(utils::TimePointToProtobuf(kTimePoint).seconds(),
+              timestamp.seconds());
+}
+
 TEST_F(UtilsTest, TimePointToProtobuf_Epoch)
 {
     auto sys_tp = std::chrono::system_clock::from_time_t(0);
@@ -92,4 +136,31 @@ TEST_F(UtilsTest, TimePointToProtobuf_Epoch)
     EXPECT_EQ(proto_ts.seconds(), 0);
 }
 
+TEST_F(UtilsTest, VersionToken_ChangesWithRows)
+{
+    const userver::storages::postgres::TimePointWithoutTz kUpdatedAt{
+        std::chrono::system_clock::from_time_t(1696939200)
+    };
+    const userver::storages::postgres::TimePointWithoutTz kLater{
+        kUpdatedAt.GetUnderlying() + std::chrono::microseconds{ 1 }
+    };
+
+    const auto kMake = [](const auto& rows) {
+        VersionToken token;
+        for (const auto& [id, updated_at] : rows)
+            token.Add(id, updated_at);
+        return token.Get();
+    };
+
+    using TimePoint = userver::storages::postgres::TimePointWithoutTz;
+    using Rows = std::vector<std::pair<std::string, TimePoint>>;
+    const auto kBase = kMake(Rows{ { "a", kUpdatedAt }, { "b", kUpdatedAt } });
+
+    EXPECT_EQ(kBase.size(), 16u);
+    EXPECT_EQ(kBase, kMake(Rows{ { "a", kUpdatedAt }, { "b", kUpdatedAt } }));
+    EXPECT_NE(kBase, kMake(Rows{ { "b", kUpdatedAt }, { "a", kUpdatedAt } }));
+    EXPECT_NE(kBase, kMake(Rows{ { "a", kUpdatedAt }, { "b", kLater } }));
+    EXPECT_NE(kBase, kMake(Rows{ { "a", kUpdatedAt } }));
+}
+
 } // namespace utils::test
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <counters/view_counters.hpp>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+#include <userver/utils/async.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace counters::test {
+
+namespace {
+
+boost::uuids::uuid MakeId(std::uint8_t high, std::uint8_t low)
+{
+    boost::uuids::uuid id{};
+    id.data[0] = high;
+    id.data[15] = low;
+    return id;
+}
+
+std::map<boost::uuids::uuid, std::int64_t>
+ToMap(const std::vector<entities::GameViews>& views)
+{
+    std::map<boost::uuids::uuid, std::int64_t> map;
+    for (const auto& game : views)
+        map[game.id] += game.views;
+    return map;
+}
+
+} // namespace
+
+UTEST(ViewCountersTest, CollectSumsViews)
+{
+    ViewCounters counters({});
+
+    const auto kFirst = MakeId(1, 1);
+    const auto kSecond = MakeId(1, 2);
+    // A zero high half is what marks free slots
+    const auto kZeroHigh = MakeId(0, 3);
+
+    for (int i = 0; i < 3; ++i)
+        counters.Add(kFirst);
+    counters.Add(kSecond);
+    counters.Add(kZeroHigh);
+
+    const auto kViews = ToMap(counters.Collect());
+    ASSERT_EQ(kViews.size(), 3u);
+    EXPECT_EQ(kViews.at(kFirst), 3);
+    EXPECT_EQ(kViews.at(kSecond), 1);
+    EXPECT_EQ(kViews.at(kZeroHigh), 1);
+
+    EXPECT_TRUE(counters.Collect().empty());
+}
+
+UTEST(ViewCountersTest, FullTablesOverflow)
+{
+    ViewCounterSettings settings;
+    settings.shard_capacity = 16;
+    ViewCounters counters(settings);
+
+    for (int round = 0; round < 2; ++round)
+        for (int i = 1; i <= 200; ++i)
+            counters.Add(MakeId(static_cast<std::uint8_t>(i), 0));
+
+    const auto kViews = ToMap(counters.Collect());
+    ASSERT_EQ(kViews.size(), 200u);
+    for (const auto& [kId, kCount] : kViews)
+        EXPECT_EQ(kCount, 2);
+}
+
+UTEST_MT(ViewCountersTest, ConcurrentAddsAreNotLost, 4)
+{
+    ViewCounters counters({});
+
+    constexpr int kWriters = 8;
+    constexpr int kViewsPerWriter = 20000;
+
+    std::atomic<bool> done{ false };
+    std::map<boost::uuids::uuid, std::int64_t> collected;
+    auto collector = userver::utils::Async("collector", [&] {
+        while (!done)
+        {
+            for (const auto& [kId, kCount] : ToMap(counters.Collect()))
+                collected[kId] += kCount;
+            userver::engine::Yield();
+        }
+    });
+
+    std::vector<userver::engine::TaskWithResult<void>> writers;
+    for (int writer = 0; writer < kWriters; ++writer)
+        writers.push_back(userver::utils::Async("writer", [&counters] {
+            for (int i = 0; i < kViewsPerWriter; ++i)
+                counters.Add(MakeId(1, static_cast<std::uint8_t>(i % 64)));
+        }));
+    for (auto& writer : writers)
+        writer.Get();
+
+    done = true;
+    collector.Get();
+    for (const auto& [kId, kCount] : ToMap(counters.Collect()))
+        collected[kId] += kCount;
+
+    std::int64_t total = 0;
+    for (const auto& [kId, kCount] : collected)
+        total += kCount;
+    EXPECT_EQ(collected.size(), 64u);
+    EXPECT_EQ(total, kWriters * kViewsPerWriter);
+}
+
+} // namespace counters::test